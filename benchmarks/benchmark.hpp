@@ -0,0 +1,258 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <chrono>
+#include <regex>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <ctime>
+
+/*
+Minimal self-contained benchmark harness following the google-benchmark 
+conventions: benchmarks are functions taking a 'State' and looping on 
+'state.keep_running()', registered with BENCHMARK and parametrized by 
+integer arguments. Command line flags:
+
+    --benchmark_filter=<regex>     run matching benchmarks only
+    --benchmark_min_time=<secs>    minimum measured time per benchmark
+    --benchmark_out=<file>         write results as JSON (google-benchmark format)
+*/
+
+namespace bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    class State
+    {
+    private:
+        const std::vector<long long> args;
+        const long long max_iterations;
+        long long iteration{ 0 };
+
+        Clock::time_point start{};
+        Clock::duration elapsed{ 0 };
+        bool paused{ false };
+
+    public:
+        State(const std::vector<long long>& args, const long long max_iterations)
+            : args{ args }
+            , max_iterations{ max_iterations }
+        {}
+
+        long long range(const int i) const { return args.at(i); }
+
+        long long iterations() const { return max_iterations; }
+
+        double seconds() const { return std::chrono::duration<double>(elapsed).count(); }
+
+        bool keep_running()
+        {
+            if(iteration == 0)
+                start = Clock::now();
+
+            if(iteration++ < max_iterations)
+                return true;
+
+            if(!paused)
+                elapsed += Clock::now() - start;
+
+            return false;
+        }
+
+        // Excludes setup/teardown inside the loop from the measurement.
+        void pause_timing()
+        {
+            elapsed += Clock::now() - start;
+            paused = true;
+        }
+
+        void resume_timing()
+        {
+            start = Clock::now();
+            paused = false;
+        }
+    };
+
+    struct Benchmark
+    {
+        std::string name;
+        std::function<void(State&)> function;
+        std::vector<std::vector<long long>> arg_sets{};
+
+        Benchmark* Args(const std::vector<long long>& args)
+        {
+            arg_sets.push_back(args);
+            return this;
+        }
+
+        Benchmark* Arg(const long long arg) { return Args({ arg }); }
+    };
+
+    inline std::vector<Benchmark*>& registry()
+    {
+        static std::vector<Benchmark*> benchmarks{};
+        return benchmarks;
+    }
+
+    inline Benchmark* register_benchmark(const std::string& name, std::function<void(State&)> function)
+    {
+        registry().push_back(new Benchmark{ name, function });
+        return registry().back();
+    }
+
+    // Prevents the compiler from optimizing away 'value'.
+    template <class T>
+    inline void do_not_optimize(const T& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    inline std::string escape(const std::string& str)
+    {
+        std::string out{};
+
+        for(const char c : str)
+        {
+            if(c == '"' || c == '\\')
+                out += '\\';
+
+            out += c;
+        }
+
+        return out;
+    }
+
+    inline int run(int argc, char** argv)
+    {
+        std::string filter{ "." };
+        std::string out_path{};
+        double min_time{ 0.5 };
+
+        for(int i = 1; i < argc; ++i)
+        {
+            const std::string arg{ argv[i] };
+
+            if(arg.rfind("--benchmark_filter=", 0) == 0)
+                filter = arg.substr(19);
+            else if(arg.rfind("--benchmark_min_time=", 0) == 0)
+                min_time = std::stod(arg.substr(21));
+            else if(arg.rfind("--benchmark_out=", 0) == 0)
+                out_path = arg.substr(16);
+            else
+            {
+                std::cerr << "Unknown argument '" << arg << "'.\n";
+                return 1;
+            }
+        }
+
+        const std::regex pattern{ filter };
+        std::ostringstream json{};
+        bool first{ true };
+
+        std::cout << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(16) << "Time (ns)" << std::setw(14) << "Iterations" << '\n';
+        std::cout << std::string(78, '-') << '\n';
+
+        for(Benchmark* benchmark : registry())
+        {
+            std::vector<std::vector<long long>> arg_sets{ benchmark->arg_sets };
+
+            if(arg_sets.empty())
+                arg_sets.push_back({});
+
+            for(const std::vector<long long>& args : arg_sets)
+            {
+                std::string name{ benchmark->name };
+
+                for(const long long arg : args)
+                    name += "/" + std::to_string(arg);
+
+                if(!std::regex_search(name, pattern))
+                    continue;
+
+                /*
+                Grows the iteration count until a run takes at least 
+                'min_time', as google-benchmark does.
+                */
+
+                long long iterations{ 1 };
+                double seconds{ 0 };
+
+                while(true)
+                {
+                    State state{ args, iterations };
+                    benchmark->function(state);
+                    seconds = state.seconds();
+
+                    if(seconds >= min_time || iterations >= 1000000000)
+                        break;
+
+                    const double scale{ seconds > 0 ? 1.4 * min_time / seconds : 10 };
+                    iterations = std::max(iterations + 1, static_cast<long long>(iterations * std::min(10.0, scale)));
+                }
+
+                const double ns_per_iteration{ seconds * 1e9 / iterations };
+
+                std::cout << std::left << std::setw(48) << name << std::right << std::setw(16) << std::fixed << std::setprecision(0) << ns_per_iteration << std::setw(14) << iterations << std::endl;
+
+                json << (first ? "" : ",") << "\n    {\n"
+                     << "      \"name\": \"" << escape(name) << "\",\n"
+                     << "      \"run_name\": \"" << escape(name) << "\",\n"
+                     << "      \"run_type\": \"iteration\",\n"
+                     << "      \"iterations\": " << iterations << ",\n"
+                     << "      \"real_time\": " << std::fixed << std::setprecision(3) << ns_per_iteration << ",\n"
+                     << "      \"cpu_time\": " << ns_per_iteration << ",\n"
+                     << "      \"time_unit\": \"ns\"\n"
+                     << "    }";
+
+                first = false;
+            }
+        }
+
+        if(!out_path.empty())
+        {
+            std::ofstream file{ out_path };
+            const std::time_t now{ std::time(nullptr) };
+            char date[64];
+            std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+            file << "{\n  \"context\": {\n"
+                 << "    \"date\": \"" << date << "\",\n"
+                 << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+                 << "    \"library_build_type\": \"" <<
+#ifdef NDEBUG
+                    "release"
+#else
+                    "debug"
+#endif
+                 << "\"\n  },\n  \"benchmarks\": [" << json.str() << "\n  ]\n}\n";
+
+            if(!file)
+            {
+                std::cerr << "Could not write '" << out_path << "'.\n";
+                return 1;
+            }
+        }
+
+        return 0;
+    }
+}
+
+#define BENCHMARK_CONCAT_(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_(a, b)
+
+#define BENCHMARK(function) \
+    static bench::Benchmark* BENCHMARK_CONCAT(benchmark_, __COUNTER__) = bench::register_benchmark(#function, function)
+
+#define BENCHMARK_TEMPLATE(function, type) \
+    static bench::Benchmark* BENCHMARK_CONCAT(benchmark_, __COUNTER__) = bench::register_benchmark(#function "<" #type ">", function<type>)
+
+#define BENCHMARK_MAIN() \
+    int main(int argc, char** argv) { return bench::run(argc, argv); }
+
+#endif
\ No newline at end of file
@@ -0,0 +1,277 @@
+#include "benchmark.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include <vector>
+#include <functional>
+
+/*
+Benchmarks of every operation (forward, and backward through 
+Engine::grad), of Engine::grad on chain, diamond and wide graphs, 
+and of Tensor construction and 'ungraph'. Arguments are element 
+counts unless stated otherwise. Backward benchmarks use smaller 
+sizes, since Jacobians are stored densely.
+*/
+
+using bench::State;
+
+template <class T>
+std::vector<T> values(const long long size)
+{
+    std::vector<T> out(size);
+
+    for(long long i = 0; i < size; ++i)
+        out[i] = static_cast<T>(1 + (i % 7)) / static_cast<T>(2);
+
+    return out;
+}
+
+template <class T>
+using BinaryFunction = std::function<Tensor<T>&(Tensor<T>&, Tensor<T>&)>;
+
+template <class T>
+void forward(State& state, const std::vector<int>& shape1, const std::vector<int>& shape2, BinaryFunction<T> function)
+{
+    /*
+    Times 'function' (which builds graph nodes), with the teardown 
+    of the graph excluded.
+    */
+
+    Tensor<T> tensor1{ values<T>(utils::prod(shape1)), shape1 };
+    Tensor<T> tensor2{ values<T>(utils::prod(shape2)), shape2 };
+
+    while(state.keep_running())
+    {
+        Tensor<T>& out{ function(tensor1, tensor2) };
+        bench::do_not_optimize(&out);
+
+        state.pause_timing();
+        tensor1.ungraph();
+        tensor2.ungraph();
+        state.resume_timing();
+    }
+}
+
+template <class T>
+void backward(State& state, const std::vector<int>& shape1, const std::vector<int>& shape2, BinaryFunction<T> function)
+{
+    /*
+    Times Engine::grad of the output of 'function' wrt. its first 
+    argument. The graph is rebuilt (untimed) every iteration, since 
+    operations cache their Jacobians.
+    */
+
+    Tensor<T> tensor1{ values<T>(utils::prod(shape1)), shape1 };
+    Tensor<T> tensor2{ values<T>(utils::prod(shape2)), shape2 };
+
+    while(state.keep_running())
+    {
+        state.pause_timing();
+        Tensor<T>& out{ function(tensor1, tensor2) };
+        state.resume_timing();
+
+        Tensor<T> grad{ Engine<T>::grad(&out, &tensor1) };
+        bench::do_not_optimize(&grad);
+
+        state.pause_timing();
+        tensor1.ungraph();
+        tensor2.ungraph();
+        state.resume_timing();
+    }
+}
+
+#define OPERATION_BENCHMARKS(name, shape1, shape2, expression) \
+    template <class T> \
+    void BM_##name##Forward(State& state) \
+    { \
+        const int n{ static_cast<int>(state.range(0)) }; \
+        forward<T>(state, shape1, shape2, [n](Tensor<T>& a, Tensor<T>& b) -> Tensor<T>& { return expression; }); \
+    } \
+    template <class T> \
+    void BM_##name##Backward(State& state) \
+    { \
+        const int n{ static_cast<int>(state.range(0)) }; \
+        backward<T>(state, shape1, shape2, [n](Tensor<T>& a, Tensor<T>& b) -> Tensor<T>& { return expression; }); \
+    }
+
+// Operations
+
+OPERATION_BENCHMARKS(Add, std::vector<int>({ n }), std::vector<int>({ n }), a + b)
+OPERATION_BENCHMARKS(Mul, std::vector<int>({ n }), std::vector<int>({ n }), a * b)
+OPERATION_BENCHMARKS(Sub, std::vector<int>({ n }), std::vector<int>({ n }), a - b)
+OPERATION_BENCHMARKS(Div, std::vector<int>({ n }), std::vector<int>({ n }), a / b)
+OPERATION_BENCHMARKS(Pow, std::vector<int>({ n }), std::vector<int>({ 1 }), a.pow(3))
+OPERATION_BENCHMARKS(Exp, std::vector<int>({ n }), std::vector<int>({ 1 }), a.exp())
+OPERATION_BENCHMARKS(Log, std::vector<int>({ n }), std::vector<int>({ 1 }), a.log())
+OPERATION_BENCHMARKS(Sum, std::vector<int>({ n }), std::vector<int>({ 1 }), a.sum())
+OPERATION_BENCHMARKS(Subscript, std::vector<int>({ n }), std::vector<int>({ 1 }), a.index({ n / 2 }))
+OPERATION_BENCHMARKS(Broadcast, std::vector<int>({ 1 }), std::vector<int>({ n }), a + b)
+OPERATION_BENCHMARKS(Transpose, std::vector<int>({ n, n }), std::vector<int>({ 1 }), a.transpose())
+OPERATION_BENCHMARKS(MatMul, std::vector<int>({ n, n }), std::vector<int>({ n, n }), a.matmul(b))
+OPERATION_BENCHMARKS(Conv1d, std::vector<int>({ 1, 4, n }), std::vector<int>({ 8, 4, 3 }), a.conv1d(b))
+OPERATION_BENCHMARKS(Conv2d, std::vector<int>({ 1, 4, n, n }), std::vector<int>({ 8, 4, 3, 3 }), a.conv2d(b))
+
+#define ELEMENTWISE(name, type) \
+    BENCHMARK_TEMPLATE(BM_##name##Forward, type)->Arg(16)->Arg(256)->Arg(4096); \
+    BENCHMARK_TEMPLATE(BM_##name##Backward, type)->Arg(16)->Arg(64)->Arg(256)
+
+ELEMENTWISE(Add, double);
+ELEMENTWISE(Add, int);
+ELEMENTWISE(Mul, double);
+ELEMENTWISE(Mul, int);
+ELEMENTWISE(Sub, double);
+ELEMENTWISE(Div, double);
+ELEMENTWISE(Pow, double);
+ELEMENTWISE(Exp, double);
+ELEMENTWISE(Log, double);
+ELEMENTWISE(Sum, double);
+ELEMENTWISE(Sum, int);
+ELEMENTWISE(Subscript, double);
+ELEMENTWISE(Broadcast, double);
+
+// Square side lengths
+BENCHMARK_TEMPLATE(BM_TransposeForward, double)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_TransposeBackward, double)->Arg(4)->Arg(8)->Arg(16);
+BENCHMARK_TEMPLATE(BM_MatMulForward, double)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_MatMulForward, int)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_MatMulBackward, double)->Arg(4)->Arg(8)->Arg(16);
+
+// Input lengths / side lengths
+BENCHMARK_TEMPLATE(BM_Conv1dForward, double)->Arg(32)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_Conv1dBackward, double)->Arg(32)->Arg(128);
+BENCHMARK_TEMPLATE(BM_Conv2dForward, double)->Arg(8)->Arg(32)->Arg(64);
+BENCHMARK_TEMPLATE(BM_Conv2dBackward, double)->Arg(8)->Arg(16);
+
+// Engine
+
+template <class T>
+using GraphBuilder = std::function<Tensor<T>&(Tensor<T>&, int)>;
+
+template <class T>
+void engine_grad(State& state, const int size, const int graph_size, GraphBuilder<T> build)
+{
+    Tensor<T> input{ values<T>(size), { size } };
+
+    while(state.keep_running())
+    {
+        state.pause_timing();
+        Tensor<T>& out{ build(input, graph_size) };
+        state.resume_timing();
+
+        Tensor<T> grad{ Engine<T>::grad(&out, &input) };
+        bench::do_not_optimize(&grad);
+
+        state.pause_timing();
+        input.ungraph();
+        state.resume_timing();
+    }
+}
+
+template <class T>
+Tensor<T>& chain(Tensor<T>& input, const int depth)
+{
+    Tensor<T>* node{ &input };
+
+    for(int i = 0; i < depth; ++i)
+        node = &((*node) * static_cast<T>(1));
+
+    return node->sum();
+}
+
+template <class T>
+Tensor<T>& diamond(Tensor<T>& input, const int depth)
+{
+    // Every node is used twice by the next one
+    Tensor<T>* node{ &input };
+
+    for(int i = 0; i < depth; ++i)
+        node = &((*node) + (*node) * static_cast<T>(1));
+
+    return node->sum();
+}
+
+template <class T>
+Tensor<T>& wide(Tensor<T>& input, const int width)
+{
+    // 'width' independent branches from 'input', summed at the end
+    Tensor<T>* total{ &(input * static_cast<T>(1)).sum() };
+
+    for(int i = 1; i < width; ++i)
+        total = &((*total) + (input * static_cast<T>(i + 1)).sum());
+
+    return *total;
+}
+
+// Arguments: (size of input, depth or width of the graph)
+
+template <class T>
+void BM_EngineChain(State& state)
+{
+    engine_grad<T>(state, state.range(0), state.range(1), chain<T>);
+}
+
+template <class T>
+void BM_EngineDiamond(State& state)
+{
+    engine_grad<T>(state, state.range(0), state.range(1), diamond<T>);
+}
+
+template <class T>
+void BM_EngineWide(State& state)
+{
+    engine_grad<T>(state, state.range(0), state.range(1), wide<T>);
+}
+
+BENCHMARK_TEMPLATE(BM_EngineChain, double)->Args({ 4, 16 })->Args({ 4, 256 })->Args({ 64, 64 });
+BENCHMARK_TEMPLATE(BM_EngineChain, int)->Args({ 4, 256 });
+BENCHMARK_TEMPLATE(BM_EngineDiamond, double)->Args({ 4, 16 })->Args({ 4, 128 })->Args({ 64, 32 });
+BENCHMARK_TEMPLATE(BM_EngineWide, double)->Args({ 4, 16 })->Args({ 4, 256 })->Args({ 64, 64 });
+
+// Tensor construction and teardown
+
+template <class T>
+void BM_ConstructFlat(State& state)
+{
+    const std::vector<T> data{ values<T>(state.range(0)) };
+
+    while(state.keep_running())
+    {
+        Tensor<T> tensor{ data, { static_cast<int>(state.range(0)) } };
+        bench::do_not_optimize(&tensor);
+    }
+}
+
+template <class T>
+void BM_ConstructNested(State& state)
+{
+    const int side{ static_cast<int>(state.range(0)) };
+    const std::vector<std::vector<T>> data(side, values<T>(side));
+
+    while(state.keep_running())
+    {
+        Tensor<T> tensor{ data };
+        bench::do_not_optimize(&tensor);
+    }
+}
+
+template <class T>
+void BM_Ungraph(State& state)
+{
+    // Argument: number of nodes in a chain built from the leaf
+    Tensor<T> input{ values<T>(4), { 4 } };
+
+    while(state.keep_running())
+    {
+        state.pause_timing();
+        chain<T>(input, static_cast<int>(state.range(0)));
+        state.resume_timing();
+
+        input.ungraph();
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_ConstructFlat, double)->Arg(16)->Arg(4096)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_ConstructFlat, int)->Arg(16)->Arg(4096)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_ConstructNested, double)->Arg(4)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_Ungraph, double)->Arg(16)->Arg(1024)->Arg(16384);
+
+BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""
+Compares two benchmark JSON files (as written with --benchmark_out) and
+flags benchmarks whose time grew by more than a threshold.
+
+    compare.py baseline.json contender.json [--threshold 0.10]
+
+Exits with status 1 if any benchmark regressed.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as file:
+        return {b["name"]: b for b in json.load(file)["benchmarks"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("contender")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="relative slowdown counted as a regression (default: 0.10)")
+    parser.add_argument("--metric", choices=["real_time", "cpu_time"], default="real_time")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    contender = load(args.contender)
+    regressions = 0
+
+    print(f"{'Benchmark':<48}{'Baseline':>14}{'Contender':>14}{'Change':>10}")
+    print("-" * 86)
+
+    for name, old in baseline.items():
+        new = contender.get(name)
+
+        if new is None:
+            print(f"{name:<48}{old[args.metric]:>14.0f}{'missing':>14}")
+            continue
+
+        old_time, new_time = old[args.metric], new[args.metric]
+        change = (new_time - old_time) / old_time if old_time > 0 else 0.0
+        flag = ""
+
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+
+        print(f"{name:<48}{old_time:>14.0f}{new_time:>14.0f}{change:>+10.1%}{flag}")
+
+    for name in contender.keys() - baseline.keys():
+        print(f"{name:<48}{'new':>14}{contender[name][args.metric]:>14.0f}")
+
+    if regressions:
+        print(f"\n{regressions} benchmark(s) regressed by more than {args.threshold:.0%}.")
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
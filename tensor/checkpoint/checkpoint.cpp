@@ -0,0 +1,286 @@
+#include "checkpoint.hpp"
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+#include <type_traits>
+#include <limits>
+#include <unordered_set>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+template <class T>
+template <class U>
+void Checkpoint<T>::write_value(std::string& out, const U value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(U));
+}
+
+template <class T>
+template <class U>
+U Checkpoint<T>::read_value(const char*& ptr, const char* end)
+{
+    if(static_cast<uint64_t>(end - ptr) < sizeof(U))
+        throw std::runtime_error("Truncated checkpoint index.");
+
+    U value{};
+    std::memcpy(&value, ptr, sizeof(U));
+    ptr += sizeof(U);
+    return value;
+}
+
+template <class T>
+uint32_t Checkpoint<T>::dtype()
+{
+    /*
+    Element type tag: 'i' (integer) or 'f' (floating point) in 
+    the high byte and the element size in bytes in the low byte.
+    */
+
+    const uint32_t kind{ std::is_integral<T>::value ? 'i' : 'f' };
+    return (kind << 8) | static_cast<uint32_t>(sizeof(T));
+}
+
+template <class T>
+void Checkpoint<T>::save(const std::string& path, const std::vector<std::pair<std::string, const Tensor<T>*>>& tensors)
+{
+    std::unordered_set<std::string> seen{};
+
+    for(const auto& [name, tensor] : tensors)
+        if(!seen.insert(name).second)
+            throw std::runtime_error("More than one tensor named '" + name + "' to save.");
+
+    std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+
+    if(!file)
+        throw std::runtime_error("Could not open '" + path + "' for writing.");
+
+    const std::string padding(alignment, '\0');
+    std::string index{};
+    uint64_t offset{ header_size };
+
+    file.write(padding.data(), header_size);
+
+    for(const auto& [name, tensor] : tensors)
+    {
+        const uint64_t aligned{ (offset + alignment - 1) / alignment * alignment };
+        const uint64_t size{ tensor->data.size() * sizeof(T) };
+
+        file.write(padding.data(), aligned - offset);
+        file.write(reinterpret_cast<const char*>(tensor->data.data()), size);
+
+        write_value<uint32_t>(index, static_cast<uint32_t>(name.size()));
+        index.append(name);
+        write_value<uint32_t>(index, dtype());
+        write_value<uint32_t>(index, static_cast<uint32_t>(tensor->shape.size()));
+
+        for(const int dim_size : tensor->shape)
+            write_value<int64_t>(index, dim_size);
+
+        write_value<uint64_t>(index, aligned);
+        write_value<uint64_t>(index, size);
+
+        offset = aligned + size;
+    }
+
+    file.write(index.data(), index.size());
+
+    std::string header(magic, 8);
+    write_value<uint32_t>(header, version);
+    write_value<uint32_t>(header, static_cast<uint32_t>(tensors.size()));
+    write_value<uint64_t>(header, offset);
+    write_value<uint64_t>(header, index.size());
+    header.resize(header_size, '\0');
+
+    file.seekp(0);
+    file.write(header.data(), header_size);
+
+    if(!file)
+        throw std::runtime_error("Failed writing checkpoint '" + path + "'.");
+}
+
+template <class T>
+Checkpoint<T>::Checkpoint(const std::string& path)
+{
+    const int fd{ ::open(path.c_str(), O_RDONLY) };
+
+    if(fd < 0)
+        throw std::runtime_error("Could not open '" + path + "'.");
+
+    struct stat info{};
+
+    if(::fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < header_size)
+    {
+        ::close(fd);
+        throw std::runtime_error("'" + path + "' is not a checkpoint.");
+    }
+
+    mapped_size = static_cast<uint64_t>(info.st_size);
+    void* address{ ::mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0) };
+    ::close(fd);
+
+    if(address == MAP_FAILED)
+        throw std::runtime_error("Could not map '" + path + "'.");
+
+    mapped = static_cast<const char*>(address);
+
+    try
+    {
+        const char* ptr{ mapped };
+        const char* end{ mapped + header_size };
+
+        if(std::memcmp(ptr, magic, 8) != 0)
+            throw std::runtime_error("'" + path + "' is not a checkpoint.");
+
+        ptr += 8;
+
+        if(read_value<uint32_t>(ptr, end) != version)
+            throw std::runtime_error("Unsupported checkpoint version.");
+
+        const uint32_t count{ read_value<uint32_t>(ptr, end) };
+        const uint64_t index_offset{ read_value<uint64_t>(ptr, end) };
+        const uint64_t index_size{ read_value<uint64_t>(ptr, end) };
+
+        if(index_offset > mapped_size || index_size > mapped_size - index_offset)
+            throw std::runtime_error("Truncated checkpoint index.");
+
+        ptr = mapped + index_offset;
+        end = ptr + index_size;
+
+        for(uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t name_size{ read_value<uint32_t>(ptr, end) };
+
+            if(static_cast<uint64_t>(end - ptr) < name_size)
+                throw std::runtime_error("Truncated checkpoint index.");
+
+            std::string name(ptr, name_size);
+            ptr += name_size;
+
+            if(entries.count(name))
+                throw std::runtime_error("Checkpoint has more than one tensor named '" + name + "'.");
+
+            Entry entry{};
+            entry.dtype = read_value<uint32_t>(ptr, end);
+            const uint32_t dim{ read_value<uint32_t>(ptr, end) };
+
+            /*
+            The payload must hold exactly the elements of the shape, so 
+            that loading never reads or writes past either, and start 
+            at an offset aligned for the element type to be viewed in 
+            place (the mapping itself is page aligned).
+            */
+
+            const uint64_t element_size{ entry.dtype & 0xff };
+            uint64_t expected_size{ element_size };
+
+            for(uint32_t d = 0; d < dim; ++d)
+            {
+                const int64_t dim_size{ read_value<int64_t>(ptr, end) };
+
+                if(dim_size < 0 || dim_size > std::numeric_limits<int>::max())
+                    throw std::runtime_error("Checkpoint tensor '" + name + "' has an invalid shape.");
+
+                if(dim_size != 0 && expected_size > mapped_size / static_cast<uint64_t>(dim_size))
+                    throw std::runtime_error("Checkpoint payload of '" + name + "' is out of bounds.");
+
+                expected_size *= static_cast<uint64_t>(dim_size);
+                entry.shape.push_back(static_cast<int>(dim_size));
+            }
+
+            entry.offset = read_value<uint64_t>(ptr, end);
+            entry.size = read_value<uint64_t>(ptr, end);
+
+            if(entry.offset > mapped_size || entry.size > mapped_size - entry.offset)
+                throw std::runtime_error("Checkpoint payload of '" + name + "' is out of bounds.");
+
+            if(element_size == 0 || entry.size != expected_size)
+                throw std::runtime_error("Checkpoint payload of '" + name + "' does not match its shape.");
+
+            if(entry.dtype == dtype() && entry.offset % alignof(T) != 0)
+                throw std::runtime_error("Checkpoint payload of '" + name + "' is misaligned.");
+
+            entry_names.push_back(name);
+            entries[name] = std::move(entry);
+        }
+    }
+    catch(...)
+    {
+        ::munmap(const_cast<char*>(mapped), mapped_size);
+        throw;
+    }
+}
+
+template <class T>
+Checkpoint<T>::~Checkpoint()
+{
+    if(mapped)
+        ::munmap(const_cast<char*>(mapped), mapped_size);
+}
+
+template <class T>
+const typename Checkpoint<T>::Entry& Checkpoint<T>::entry(const std::string& name) const
+{
+    const auto& iter{ entries.find(name) };
+
+    if(iter == entries.end())
+        throw std::runtime_error("No tensor named '" + name + "' in checkpoint.");
+
+    if(iter->second.dtype != dtype())
+        throw std::runtime_error("Checkpoint tensor '" + name + "' has a different element type.");
+
+    return iter->second;
+}
+
+template <class T>
+const std::vector<std::string>& Checkpoint<T>::names() const
+{
+    return entry_names;
+}
+
+template <class T>
+bool Checkpoint<T>::contains(const std::string& name) const
+{
+    return entries.count(name) > 0;
+}
+
+template <class T>
+utils::Shape Checkpoint<T>::shape(const std::string& name) const
+{
+    return entry(name).shape;
+}
+
+template <class T>
+const T* Checkpoint<T>::view(const std::string& name) const
+{
+    return reinterpret_cast<const T*>(mapped + entry(name).offset);
+}
+
+template <class T>
+Tensor<T> Checkpoint<T>::load(const std::string& name) const
+{
+    const Entry& found{ entry(name) };
+    const T* values{ view(name) };
+
+    return Tensor<T>{ std::vector<T>(values, values + found.size / sizeof(T)), found.shape };
+}
+
+template <class T>
+void Checkpoint<T>::load_into(const std::string& name, Tensor<T>& tensor) const
+{
+    const Entry& found{ entry(name) };
+
+    if(found.shape != tensor.shape)
+        throw std::runtime_error("Checkpoint tensor '" + name + "' has a different shape.");
+
+    std::memcpy(tensor.data.data(), view(name), found.size);
+    tensor.touch();
+}
+
+// Template declarations
+
+template class Checkpoint<int>;
+template class Checkpoint<double>;
+template class Checkpoint<long>;
+template class Checkpoint<long long>;
\ No newline at end of file
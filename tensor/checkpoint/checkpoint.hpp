@@ -0,0 +1,92 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+template <class T>
+class Tensor;
+
+#include "../tensor.hpp"
+#include "../utils/shape.hpp"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+
+template <class T>
+class Checkpoint
+{
+private:
+    /*
+    Binary checkpoint of named tensors. Layout (little-endian):
+
+        header (64 bytes):  magic "TGRADCKP", version, number of 
+                            tensors, offset and size of the index
+        payloads:           raw row-major data of each tensor, each 
+                            starting on a 64-byte boundary
+        index:              per tensor, its name, dtype, shape, and 
+                            the offset and size of its payload
+
+    A loaded checkpoint maps the file with mmap, so opening it only 
+    reads the index, and payloads are paged in when accessed.
+    */
+
+    struct Entry
+    {
+        uint32_t dtype;
+        utils::Shape shape;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    static constexpr char magic[9]{ "TGRADCKP" };
+    static constexpr uint32_t version{ 1 };
+    static constexpr uint64_t alignment{ 64 };
+    static constexpr uint64_t header_size{ 64 };
+
+    static uint32_t dtype();
+
+    template <class U>
+    static void write_value(std::string& out, const U value);
+
+    template <class U>
+    static U read_value(const char*& ptr, const char* end);
+
+    const char* mapped{ nullptr };
+    uint64_t mapped_size{ 0 };
+
+    std::vector<std::string> entry_names;
+    std::unordered_map<std::string, Entry> entries;
+
+    const Entry& entry(const std::string& name) const;
+
+public:
+    // Names must be unique, as tensors are looked up by name
+    static void save(const std::string& path, const std::vector<std::pair<std::string, const Tensor<T>*>>& tensors);
+
+    explicit Checkpoint(const std::string& path);
+    ~Checkpoint();
+
+    Checkpoint(const Checkpoint&) = delete;
+    Checkpoint& operator=(const Checkpoint&) = delete;
+
+    const std::vector<std::string>& names() const;
+
+    bool contains(const std::string& name) const;
+
+    utils::Shape shape(const std::string& name) const;
+
+    /*
+    Zero-copy access to the payload of 'name', valid for the 
+    lifetime of the checkpoint.
+    */
+
+    const T* view(const std::string& name) const;
+
+    // New tensor holding a copy of 'name'.
+    Tensor<T> load(const std::string& name) const;
+
+    // Overwrites the data of 'tensor' (e.g. a parameter) in place.
+    void load_into(const std::string& name, Tensor<T>& tensor) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,538 @@
+#include "code_generator.hpp"
+#include "../operations/binary/add/add.hpp"
+#include "../operations/binary/sub/sub.hpp"
+#include "../operations/binary/mul/mul.hpp"
+#include "../operations/binary/div/div.hpp"
+#include "../operations/binary/matmul/matmul.hpp"
+#include "../operations/binary/conv/conv.hpp"
+#include "../operations/unary/exp/exp.hpp"
+#include "../operations/unary/log/log.hpp"
+#include "../operations/unary/pow/pow.hpp"
+#include "../operations/unary/fill/fill.hpp"
+#include "../operations/unary/broadcast/broadcast.hpp"
+#include "../operations/unary/transpose/transpose.hpp"
+#include <sstream>
+#include <fstream>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <stdexcept>
+
+namespace
+{
+    template <class T>
+    const char* type_name()
+    {
+        if constexpr(std::is_same<T, int>::value)
+            return "int";
+        else if constexpr(std::is_same<T, long>::value)
+            return "long";
+        else if constexpr(std::is_same<T, long long>::value)
+            return "long long";
+        else
+            return "double";
+    }
+
+    template <class T>
+    bool is_uniform(const std::vector<T>& data)
+    {
+        return std::all_of(data.begin(), data.end(), [&data](const T value) { return value == data[0]; });
+    }
+
+    std::string loop(const int size, const std::string& body)
+    {
+        return "    for(int i = 0; i < " + std::to_string(size) + "; ++i)\n        " + body + "\n";
+    }
+}
+
+template <class T>
+CodeGenerator<T>::CodeGenerator(Tensor<T>& root, const std::vector<Tensor<T>*>& targets, const std::string& name)
+    : root{ &root }, targets{ targets }, name{ name }
+{
+    if(!root.oper)
+        throw std::runtime_error("Code generation requires a tensor produced by an operation.");
+
+    if(!targets.empty() && root.data.size() != 1)
+        throw std::runtime_error("Compiled gradients require a scalar root.");
+
+    for(const Tensor<T>* target : targets)
+        if(target->oper)
+            throw std::runtime_error("Compiled gradients are taken wrt. leaves.");
+
+    build_schedule();
+    fuse();
+    generate();
+}
+
+template <class T>
+void CodeGenerator<T>::build_schedule()
+{
+    /*
+    Post-order over the parents of 'root' (see
+    MemoryPlanner::build_schedule), collecting the leaves read on
+    the way.
+    */
+
+    std::unordered_set<Tensor<T>*> visited{ root };
+    std::vector<std::pair<Tensor<T>*, int>> stack{ { root, 0 } };
+
+    while(!stack.empty())
+    {
+        auto& [tensor, next] = stack.back();
+
+        if(next < static_cast<int>(tensor->parents.size()))
+        {
+            Tensor<T>* parent{ tensor->parents[next++] };
+
+            if(!visited.insert(parent).second)
+                continue;
+
+            if(parent->oper)
+                stack.emplace_back(parent, 0);
+            else if(parent->is_accessible)
+                input_tensors.push_back(parent);
+            else
+                constants.push_back(parent);
+
+            continue;
+        }
+
+        if(dynamic_cast<Conv<T>*>(tensor->oper))
+            throw std::runtime_error("Code generation does not support Conv.");
+
+        schedule.push_back(tensor);
+        stack.pop_back();
+    }
+}
+
+template <class T>
+bool CodeGenerator<T>::is_elementwise(const Operation<T>* oper)
+{
+    return dynamic_cast<const Add<T>*>(oper) || dynamic_cast<const Sub<T>*>(oper)
+        || dynamic_cast<const Mul<T>*>(oper) || dynamic_cast<const Div<T>*>(oper)
+        || dynamic_cast<const Exp<T>*>(oper) || dynamic_cast<const Log<T>*>(oper)
+        || dynamic_cast<const Pow<T>*>(oper) || dynamic_cast<const Fill<T>*>(oper)
+        || dynamic_cast<const Broadcast<T>*>(oper);
+}
+
+template <class T>
+void CodeGenerator<T>::fuse()
+{
+    /*
+    An elementwise tensor read once, by an elementwise operation,
+    Sum or Subscript, is computed inside the loop of its reader.
+    'size' counts the operations of the expression of each tensor,
+    including those fused into it.
+    */
+
+    std::unordered_map<const Tensor<T>*, int> uses{};
+    std::unordered_map<const Tensor<T>*, const Tensor<T>*> reader{};
+    std::unordered_map<const Tensor<T>*, int> size{};
+
+    for(const Tensor<T>* tensor : schedule)
+        for(const Tensor<T>* parent : tensor->parents)
+        {
+            ++uses[parent];
+            reader[parent] = tensor;
+        }
+
+    for(const Tensor<T>* tensor : schedule)
+    {
+        size[tensor] = 1;
+
+        for(const Tensor<T>* parent : tensor->parents)
+            if(fused.count(parent))
+                size[tensor] += size[parent];
+
+        if(tensor == root || uses[tensor] != 1 || !is_elementwise(tensor->oper) || size[tensor] > max_fused_operations)
+            continue;
+
+        const Operation<T>* oper{ reader[tensor]->oper };
+
+        if(is_elementwise(oper) || dynamic_cast<const Sum<T>*>(oper) || dynamic_cast<const Subscript<T>*>(oper))
+            fused.insert(tensor);
+    }
+
+    for(const Tensor<T>* target : targets)
+        needs_grad.insert(target);
+
+    for(const Tensor<T>* tensor : schedule)
+        for(const Tensor<T>* parent : tensor->parents)
+            if(needs_grad.count(parent))
+                needs_grad.insert(tensor);
+}
+
+template <class T>
+std::string CodeGenerator<T>::literal(const T value)
+{
+    if constexpr(std::is_integral<T>::value)
+        return "T(" + std::to_string(value) + ")";
+    else
+        return double_literal(static_cast<double>(value));
+}
+
+template <class T>
+std::string CodeGenerator<T>::double_literal(const double value)
+{
+    /*
+    Hexadecimal floating point literals round-trip exactly.
+    */
+
+    if(std::isnan(value))
+        return "std::numeric_limits<double>::quiet_NaN()";
+
+    if(std::isinf(value))
+        return (value > 0) ? "std::numeric_limits<double>::infinity()" : "(-std::numeric_limits<double>::infinity())";
+
+    std::ostringstream out{};
+    out << std::hexfloat << value;
+
+    return (value < 0) ? "(" + out.str() + ")" : out.str();
+}
+
+template <class T>
+std::string CodeGenerator<T>::value(const Tensor<T>* tensor, const std::string& index) const
+{
+    const auto& iter{ arrays.find(tensor) };
+
+    if(iter != arrays.end())
+        return iter->second + "[" + index + "]";
+
+    if(fused.count(tensor))
+        return element(tensor, index);
+
+    // Uniform constant
+    return literal(tensor->data[0]);
+}
+
+template <class T>
+std::string CodeGenerator<T>::element(const Tensor<T>* tensor, const std::string& index) const
+{
+    const Operation<T>* oper{ tensor->oper };
+    const std::vector<Tensor<T>*>& args{ tensor->parents };
+
+    const std::pair<const Operation<T>*, const char*> binary[]{
+        { dynamic_cast<const Add<T>*>(oper), " + " }, { dynamic_cast<const Sub<T>*>(oper), " - " },
+        { dynamic_cast<const Mul<T>*>(oper), " * " }, { dynamic_cast<const Div<T>*>(oper), " / " } };
+
+    for(const auto& [match, symbol] : binary)
+        if(match)
+            return "(" + value(args[0], index) + symbol + value(args[1], index) + ")";
+
+    if(const Exp<T>* exp = dynamic_cast<const Exp<T>*>(oper))
+        return "T(std::pow(" + literal(exp->get_base()) + ", " + value(args[0], index) + "))";
+
+    if(const Log<T>* log = dynamic_cast<const Log<T>*>(oper))
+        return "T(std::log(" + value(args[0], index) + ") / " + double_literal(std::log(log->get_base())) + ")";
+
+    if(const Pow<T>* pow = dynamic_cast<const Pow<T>*>(oper))
+        return "T(std::pow(" + value(args[0], index) + ", " + literal(pow->get_power()) + "))";
+
+    if(const Fill<T>* fill = dynamic_cast<const Fill<T>*>(oper))
+        return literal(fill->get_value());
+
+    // Broadcast
+    return value(args[0], "0");
+}
+
+template <class T>
+std::string CodeGenerator<T>::forward(const Tensor<T>* tensor) const
+{
+    const Operation<T>* oper{ tensor->oper };
+    const std::vector<Tensor<T>*>& args{ tensor->parents };
+    const std::string& out{ arrays.at(tensor) };
+
+    if(is_elementwise(oper))
+        return loop(static_cast<int>(tensor->data.size()), out + "[i] = " + element(tensor, "i") + ";");
+
+    if(dynamic_cast<const Sum<T>*>(oper))
+        return "    {\n        T sum{ 0 };\n"
+            "    " + loop(static_cast<int>(args[0]->data.size()), "    sum += " + value(args[0], "i") + ";")
+            + "        " + out + "[0] = sum;\n    }\n";
+
+    if(const Subscript<T>* subscript = dynamic_cast<const Subscript<T>*>(oper))
+        return "    " + out + "[0] = " + value(args[0], std::to_string(args[0]->flatten_index(subscript->get_index()))) + ";\n";
+
+    const std::string rows{ std::to_string(args[0]->shape[0]) };
+    const std::string cols{ std::to_string(args[0]->shape[1]) };
+
+    if(dynamic_cast<const Transpose<T>*>(oper))
+        return "    for(int i = 0; i < " + rows + "; ++i)\n"
+            "        for(int j = 0; j < " + cols + "; ++j)\n"
+            "            " + out + "[j*" + rows + " + i] = " + value(args[0], "i*" + cols + " + j") + ";\n";
+
+    // MatMul, in i-k-j order so that the inner loop is contiguous
+    const std::string inner{ std::to_string(args[1]->shape[1]) };
+
+    return loop(static_cast<int>(tensor->data.size()), out + "[i] = 0;")
+        + "    for(int i = 0; i < " + rows + "; ++i)\n"
+        "        for(int k = 0; k < " + cols + "; ++k)\n"
+        "        {\n"
+        "            const T a{ " + value(args[0], "i*" + cols + " + k") + " };\n"
+        "            for(int j = 0; j < " + inner + "; ++j)\n"
+        "                " + out + "[i*" + inner + " + j] += a * " + value(args[1], "k*" + inner + " + j") + ";\n"
+        "        }\n";
+}
+
+template <class T>
+std::string CodeGenerator<T>::backward(const Tensor<T>* tensor) const
+{
+    /*
+    Adds the contribution of 'tensor' to the adjoints of its
+    arguments, as in the '_vjp' of its operation.
+    */
+
+    const Operation<T>* oper{ tensor->oper };
+    const std::vector<Tensor<T>*>& args{ tensor->parents };
+    const std::string& grad{ adjoints.at(tensor) };
+    const int size{ static_cast<int>(tensor->data.size()) };
+
+    std::string code{};
+
+    for(int slot = 0; slot < static_cast<int>(args.size()); ++slot)
+    {
+        if(!needs_grad.count(args[slot]))
+            continue;
+
+        const std::string& arg_grad{ adjoints.at(args[slot]) };
+        const std::string target{ arg_grad + "[i]" };
+        const std::string g{ grad + "[i]" };
+
+        if(dynamic_cast<const Add<T>*>(oper))
+            code += loop(size, target + " += " + g + ";");
+
+        else if(dynamic_cast<const Sub<T>*>(oper))
+            code += loop(size, target + ((slot == 0) ? " += " : " -= ") + g + ";");
+
+        else if(dynamic_cast<const Mul<T>*>(oper))
+            code += loop(size, target + " += " + g + " * " + value(args[1 - slot], "i") + ";");
+
+        else if(dynamic_cast<const Div<T>*>(oper))
+        {
+            const std::string quotient{ g + " / " + value(args[1], "i") };
+            code += loop(size, (slot == 0) ? target + " += " + quotient + ";"
+                : target + " -= " + quotient + " * " + value(tensor, "i") + ";");
+        }
+
+        else if(const Exp<T>* exp = dynamic_cast<const Exp<T>*>(oper))
+            code += loop(size, target + " += " + g + " * (" + value(tensor, "i") + " * "
+                + literal(static_cast<T>(std::log(exp->get_base()))) + ");");
+
+        else if(const Log<T>* log = dynamic_cast<const Log<T>*>(oper))
+            code += loop(size, target + " += " + g + " * (T(std::pow(" + value(args[0], "i") + ", "
+                + literal(T(-1)) + ")) * " + literal(static_cast<T>(1.0 / std::log(log->get_base()))) + ");");
+
+        else if(const Pow<T>* pow = dynamic_cast<const Pow<T>*>(oper))
+            code += loop(size, target + " += " + g + " * (T(std::pow(" + value(args[0], "i") + ", "
+                + literal(pow->get_power() - 1) + ")) * " + literal(pow->get_power()) + ");");
+
+        else if(dynamic_cast<const Broadcast<T>*>(oper))
+            code += "    {\n        T sum{ 0 };\n    " + loop(size, "    sum += " + g + ";")
+                + "        " + arg_grad + "[0] += sum;\n    }\n";
+
+        else if(dynamic_cast<const Sum<T>*>(oper))
+            code += loop(static_cast<int>(args[0]->data.size()), target + " += " + grad + "[0];");
+
+        else if(const Subscript<T>* subscript = dynamic_cast<const Subscript<T>*>(oper))
+            code += "    " + arg_grad + "[" + std::to_string(args[0]->flatten_index(subscript->get_index())) + "] += " + grad + "[0];\n";
+
+        else if(dynamic_cast<const Transpose<T>*>(oper))
+        {
+            const std::string rows{ std::to_string(args[0]->shape[0]) };
+            const std::string cols{ std::to_string(args[0]->shape[1]) };
+
+            code += "    for(int i = 0; i < " + rows + "; ++i)\n"
+                "        for(int j = 0; j < " + cols + "; ++j)\n"
+                "            " + arg_grad + "[i*" + cols + " + j] += " + grad + "[j*" + rows + " + i];\n";
+        }
+
+        else if(dynamic_cast<const MatMul<T>*>(oper))
+        {
+            /*
+            For out = A B: dA = g B^T and dB = A^T g.
+            */
+
+            const std::string rows{ std::to_string(args[0]->shape[0]) };
+            const std::string cols{ std::to_string(args[0]->shape[1]) };
+            const std::string inner{ std::to_string(args[1]->shape[1]) };
+
+            if(slot == 0)
+                code += "    for(int i = 0; i < " + rows + "; ++i)\n"
+                    "        for(int k = 0; k < " + cols + "; ++k)\n"
+                    "        {\n"
+                    "            T sum{ 0 };\n"
+                    "            for(int j = 0; j < " + inner + "; ++j)\n"
+                    "                sum += " + grad + "[i*" + inner + " + j] * " + value(args[1], "k*" + inner + " + j") + ";\n"
+                    "            " + arg_grad + "[i*" + cols + " + k] += sum;\n"
+                    "        }\n";
+            else
+                code += "    for(int i = 0; i < " + rows + "; ++i)\n"
+                    "        for(int k = 0; k < " + cols + "; ++k)\n"
+                    "        {\n"
+                    "            const T a{ " + value(args[0], "i*" + cols + " + k") + " };\n"
+                    "            for(int j = 0; j < " + inner + "; ++j)\n"
+                    "                " + arg_grad + "[k*" + inner + " + j] += a * " + grad + "[i*" + inner + " + j];\n"
+                    "        }\n";
+        }
+
+        // Fill does not depend on its argument
+    }
+
+    return code;
+}
+
+template <class T>
+void CodeGenerator<T>::generate()
+{
+    std::ostringstream out{};
+    std::ostringstream buffers{};
+
+    out << "// Generated by tensorgrad. Operations: " << schedule.size() << " (" << fused.size() << " fused), inputs: "
+        << input_tensors.size() << ", gradient targets: " << targets.size() << ".\n\n"
+        << "#include <cmath>\n#include <limits>\n\nnamespace\n{\n    using T = " << type_name<T>() << ";\n";
+
+    for(int j = 0; j < static_cast<int>(input_tensors.size()); ++j)
+    {
+        arrays[input_tensors[j]] = "x" + std::to_string(j);
+        buffers << "    const T* __restrict x" << j << "{ inputs[" << j << "] };\n";
+    }
+
+    for(int j = 0; j < static_cast<int>(constants.size()); ++j)
+    {
+        const std::vector<T>& data{ constants[j]->data };
+
+        if(is_uniform(data))
+            continue;
+
+        arrays[constants[j]] = "c" + std::to_string(j);
+        out << "\n    const T c" << j << "[" << data.size() << "]{ ";
+
+        for(int i = 0; i < static_cast<int>(data.size()); ++i)
+            out << (i ? ", " : "") << literal(data[i]);
+
+        out << " };\n";
+    }
+
+    const auto allocate = [this, &buffers](const Tensor<T>* tensor, const std::string& array)
+    {
+        buffers << "    T* __restrict " << array << "{ workspace + " << workspace << " };\n";
+        workspace += static_cast<long long>(tensor->data.size());
+    };
+
+    for(int k = 0; k < static_cast<int>(schedule.size()); ++k)
+    {
+        const Tensor<T>* tensor{ schedule[k] };
+        const std::string array{ "v" + std::to_string(k) };
+
+        if(tensor == root)
+        {
+            arrays[tensor] = array;
+            buffers << "    T* __restrict " << array << "{ outputs[0] };\n";
+        }
+        else if(!fused.count(tensor))
+        {
+            arrays[tensor] = array;
+            allocate(tensor, array);
+        }
+
+        if(needs_grad.count(tensor))
+        {
+            adjoints[tensor] = "g" + std::to_string(k);
+            allocate(tensor, adjoints[tensor]);
+        }
+    }
+
+    for(int j = 0; j < static_cast<int>(targets.size()); ++j)
+    {
+        adjoints[targets[j]] = "d" + std::to_string(j);
+        buffers << "    T* __restrict d" << j << "{ outputs[" << j + 1 << "] };\n";
+    }
+
+    out << "}\n\n"
+        << "extern \"C\" long long " << name << "_workspace_size()\n{\n    return " << workspace << ";\n}\n\n"
+        << "extern \"C\" void " << name << "_run(const T* const* inputs, T* const* outputs, T* workspace)\n{\n"
+        << buffers.str() << "\n    // Forward\n\n";
+
+    for(const Tensor<T>* tensor : schedule)
+        if(!fused.count(tensor))
+            out << forward(tensor);
+
+    if(!targets.empty())
+    {
+        out << "\n    // Backward\n\n";
+
+        for(const Tensor<T>* target : targets)
+            out << loop(static_cast<int>(target->data.size()), adjoints.at(target) + "[i] = 0;");
+
+        for(const Tensor<T>* tensor : schedule)
+            if(needs_grad.count(tensor))
+                out << loop(static_cast<int>(tensor->data.size()), adjoints.at(tensor) + "[i] = 0;");
+
+        if(needs_grad.count(root))
+        {
+            out << "    " << adjoints.at(root) << "[0] = 1;\n";
+
+            for(auto iter = schedule.rbegin(); iter != schedule.rend(); ++iter)
+                if(needs_grad.count(*iter))
+                    out << backward(*iter);
+        }
+    }
+
+    out << "}\n";
+    code = out.str();
+}
+
+template <class T>
+const std::string& CodeGenerator<T>::source() const
+{
+    return code;
+}
+
+template <class T>
+void CodeGenerator<T>::write(const std::string& path) const
+{
+    std::ofstream file{ path };
+
+    if(!(file << code))
+        throw std::runtime_error("Could not write generated code to '" + path + "'.");
+}
+
+template <class T>
+const std::vector<Tensor<T>*>& CodeGenerator<T>::inputs() const
+{
+    return input_tensors;
+}
+
+template <class T>
+const std::vector<Tensor<T>*>& CodeGenerator<T>::gradient_targets() const
+{
+    return targets;
+}
+
+template <class T>
+long long CodeGenerator<T>::workspace_size() const
+{
+    return workspace;
+}
+
+template <class T>
+std::uint64_t CodeGenerator<T>::hash() const
+{
+    std::uint64_t hash{ 14695981039346656037ull };
+
+    for(const unsigned char c : code)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+// Template declarations
+
+template class CodeGenerator<int>;
+template class CodeGenerator<double>;
+template class CodeGenerator<long>;
+template class CodeGenerator<long long>;
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef CODE_GENERATOR_HPP
+#define CODE_GENERATOR_HPP
+
+template <class T>
+class Tensor;
+
+#include "../tensor.hpp"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+
+template <class T>
+class CodeGenerator
+{
+private:
+    /*
+    'schedule' holds the tensors produced by operations that 'root'
+    depends on, arguments first (as in MemoryPlanner). 'inputs'
+    are the accessible leaves the graph reads, in the order the
+    generated function takes them; inaccessible leaves (the
+    constants of operator overloads) are baked into the source.
+    */
+
+    Tensor<T>* root;
+    std::vector<Tensor<T>*> targets;
+    std::string name;
+
+    std::vector<Tensor<T>*> schedule;
+    std::vector<Tensor<T>*> input_tensors;
+    std::vector<Tensor<T>*> constants;
+
+    /*
+    Array each value (and each adjoint, for tensors a target
+    depends on) is read from. A fused tensor has no array: its
+    elements are recomputed inside the loop of the tensor that
+    reads it.
+    */
+
+    std::unordered_map<const Tensor<T>*, std::string> arrays;
+    std::unordered_map<const Tensor<T>*, std::string> adjoints;
+    std::unordered_set<const Tensor<T>*> fused;
+    std::unordered_set<const Tensor<T>*> needs_grad;
+    long long workspace{ 0 };
+
+    std::string code;
+
+    void build_schedule();
+    void fuse();
+    void generate();
+
+    std::string value(const Tensor<T>* tensor, const std::string& index) const;
+    std::string element(const Tensor<T>* tensor, const std::string& index) const;
+
+    std::string forward(const Tensor<T>* tensor) const;
+    std::string backward(const Tensor<T>* tensor) const;
+
+    static bool is_elementwise(const Operation<T>* oper);
+    static std::string literal(const T value);
+    static std::string double_literal(const double value);
+
+public:
+    /*
+    Above this many operations, an elementwise operation is not
+    fused into the loop of the tensor reading it. The backward
+    pass recomputes fused values wherever it needs them, so long
+    fused expressions trade memory traffic for arithmetic.
+    */
+
+    static constexpr int max_fused_operations{ 8 };
+
+    /*
+    Generates C++ source evaluating the graph built up to 'root'
+    and, for each of 'targets' (leaves, with 'root' a scalar), the
+    gradient of 'root' wrt. it. Shapes, operation parameters and
+    constants are baked into the source, and chains of elementwise
+    operations are fused into a single loop. The source defines
+
+        extern "C" long long <name>_workspace_size();
+        extern "C" void <name>_run(const T* const* inputs,
+                                   T* const* outputs, T* workspace);
+
+    where 'inputs' holds the values of 'inputs()', in order,
+    'outputs[0]' receives 'root' and 'outputs[1 + j]' the gradient
+    wrt. 'targets[j]', and 'workspace' holds at least
+    '<name>_workspace_size()' elements. Conv is not supported.
+    */
+
+    CodeGenerator(Tensor<T>& root, const std::vector<Tensor<T>*>& targets = {}, const std::string& name = "tensorgrad_graph");
+
+    const std::string& source() const;
+
+    // Writes 'source()' to 'path', to be compiled ahead of time
+    void write(const std::string& path) const;
+
+    const std::vector<Tensor<T>*>& inputs() const;
+
+    const std::vector<Tensor<T>*>& gradient_targets() const;
+
+    long long workspace_size() const;
+
+    // FNV-1a hash of 'source()'
+    std::uint64_t hash() const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "compiled_graph.hpp"
+#include <dlfcn.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+#include <mutex>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace
+{
+    std::string quote(const std::string& argument)
+    {
+        std::string quoted{ "'" };
+
+        for(const char c : argument)
+            quoted += (c == '\'') ? std::string{ "'\\''" } : std::string{ c };
+
+        return quoted + "'";
+    }
+
+    /*
+    Whether 'path' itself (not a symlink to it) is of type 'type', 
+    owned by the effective user and not writable by anyone else, so 
+    that no other user can plant a library to be loaded.
+    */
+
+    bool is_private(const std::filesystem::path& path, const mode_t type)
+    {
+        struct stat status{};
+
+        if(lstat(path.c_str(), &status) != 0)
+            return false;
+
+        return (status.st_mode & S_IFMT) == type && status.st_uid == geteuid() && !(status.st_mode & (S_IWGRP | S_IWOTH));
+    }
+
+    // Creates the cache directory, its last component with mode 0700
+    void make_cache_directory(const std::filesystem::path& dir)
+    {
+        if(dir.has_parent_path())
+            std::filesystem::create_directories(dir.parent_path());
+
+        if(mkdir(dir.c_str(), S_IRWXU) != 0 && errno != EEXIST)
+            throw std::runtime_error("Could not create the JIT cache '" + dir.string() + "': " + std::strerror(errno));
+
+        if(!is_private(dir, S_IFDIR))
+            throw std::runtime_error("JIT cache '" + dir.string() + "' is not a directory owned by and only writable by the current user.");
+    }
+}
+
+JitOptions JitOptions::from_environment()
+{
+    JitOptions options{};
+
+    if(const char* compiler = std::getenv("TENSORGRAD_CXX"))
+        options.compiler = compiler;
+    else if(const char* compiler = std::getenv("CXX"))
+        options.compiler = compiler;
+
+    if(const char* cache_dir = std::getenv("TENSORGRAD_JIT_CACHE"))
+        options.cache_dir = cache_dir;
+
+    return options;
+}
+
+template <class T>
+CompiledGraph<T>::CompiledGraph(Tensor<T>& root, const std::vector<Tensor<T>*>& targets, const JitOptions& options)
+    : root{ &root }, targets{ targets }
+{
+    const CodeGenerator<T> generator{ root, targets };
+
+    inputs = generator.inputs();
+    workspace.resize(static_cast<std::size_t>(generator.workspace_size()));
+
+    void* handle{ load(generator, options, library, cached) };
+    function = reinterpret_cast<Function>(dlsym(handle, "tensorgrad_graph_run"));
+
+    if(!function)
+        throw std::runtime_error("Compiled graph '" + library + "' has no entry point.");
+}
+
+template <class T>
+void* CompiledGraph<T>::load(const CodeGenerator<T>& generator, const JitOptions& options, std::string& library, bool& cached)
+{
+    /*
+    The library is compiled to a temporary path and renamed into
+    place, so that processes sharing a cache never load a partly
+    written library.
+    */
+
+    static std::mutex mutex{};
+    static std::unordered_map<std::string, void*> loaded{};
+
+    std::uint64_t hash{ generator.hash() };
+
+    for(const unsigned char c : '\n' + options.compiler + ' ' + options.flags)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+
+    namespace fs = std::filesystem;
+
+    fs::path dir{ options.cache_dir.empty() ? fs::temp_directory_path() / ("tensorgrad_jit-" + std::to_string(geteuid())) : fs::path{ options.cache_dir } };
+
+    if(!dir.has_filename())
+        dir = dir.parent_path();
+
+    std::ostringstream stem{};
+    stem << "graph_" << std::hex << std::setw(16) << std::setfill('0') << hash;
+
+    const fs::path path{ dir / (stem.str() + ".so") };
+    library = path.string();
+
+    std::lock_guard<std::mutex> lock{ mutex };
+
+    const auto& iter{ loaded.find(library) };
+
+    if(iter != loaded.end())
+    {
+        cached = true;
+        return iter->second;
+    }
+
+    make_cache_directory(dir);
+    cached = fs::exists(path);
+
+    if(!cached)
+    {
+        const std::string unique{ stem.str() + "." + std::to_string(getpid()) };
+        const fs::path source{ dir / (unique + ".cpp") };
+        const fs::path temporary{ dir / (unique + ".so") };
+        const fs::path log{ dir / (stem.str() + ".log") };
+
+        generator.write(source.string());
+
+        const std::string command{ options.compiler + " " + options.flags + " -shared -fPIC -o " + quote(temporary.string())
+            + " " + quote(source.string()) + " 2> " + quote(log.string()) };
+
+        if(std::system(command.c_str()) != 0)
+            throw std::runtime_error("Compiling the generated code failed, see '" + log.string() + "'.");
+
+        fs::permissions(temporary, fs::perms::owner_all);
+        fs::rename(temporary, path);
+        fs::remove(source);
+    }
+
+    if(!is_private(path, S_IFREG))
+        throw std::runtime_error("Refusing to load '" + library + "', which is not a file owned by and only writable by the current user.");
+
+    void* handle{ dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL) };
+
+    if(!handle)
+        throw std::runtime_error("Could not load compiled graph: " + std::string{ dlerror() });
+
+    loaded[library] = handle;
+    return handle;
+}
+
+template <class T>
+Tensor<T>& CompiledGraph<T>::run()
+{
+    std::vector<const T*> in{};
+    std::vector<T*> out{};
+
+    for(const Tensor<T>* input : inputs)
+    {
+        if(input->data.size() != static_cast<std::size_t>(utils::prod(input->shape)))
+            throw std::runtime_error("Input of a compiled graph has been released.");
+
+        in.push_back(input->data.data());
+    }
+
+    root->data.resize(static_cast<std::size_t>(utils::prod(root->shape)));
+    out.push_back(root->data.data());
+
+    for(Tensor<T>* target : targets)
+    {
+        if(target->grad_in_graph)
+            target->release_grad();
+
+        if(!target->grad || target->grad->shape != target->shape)
+        {
+            Tensor<T> grad{ target->shape, 0 };
+
+            if(!target->grad)
+                target->grad = new Tensor<T>{ std::vector<T>{} };
+
+            target->grad->take(grad);
+        }
+
+        target->grad->non_zero_idxs.clear();
+        out.push_back(target->grad->data.data());
+    }
+
+    function(in.data(), out.data(), workspace.data());
+
+    root->touch();
+    root->is_stale = false;
+    root->sync_memory();
+
+    for(Tensor<T>* target : targets)
+    {
+        target->grad->touch();
+        target->grad->sync_memory();
+    }
+
+    return *root;
+}
+
+template <class T>
+const std::string& CompiledGraph<T>::library_path() const
+{
+    return library;
+}
+
+template <class T>
+bool CompiledGraph<T>::from_cache() const
+{
+    return cached;
+}
+
+// Template declarations
+
+template class CompiledGraph<int>;
+template class CompiledGraph<double>;
+template class CompiledGraph<long>;
+template class CompiledGraph<long long>;
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef COMPILED_GRAPH_HPP
+#define COMPILED_GRAPH_HPP
+
+template <class T>
+class Tensor;
+
+#include "../tensor.hpp"
+#include "code_generator.hpp"
+#include <vector>
+#include <string>
+
+/*
+How CompiledGraph builds generated code: the shared library is
+compiled with '<compiler> <flags> -shared -fPIC' and cached in
+'cache_dir' under the hash of the source, compiler and flags. If
+empty, 'cache_dir' is 'tensorgrad_jit-<uid>' in the system
+temporary directory. The cache directory is created with mode
+0700, and it and any cached library are only used if owned by
+the current user and not writable by anyone else.
+*/
+
+struct JitOptions
+{
+    std::string compiler{ "c++" };
+    std::string flags{ "-O3 -march=native -std=c++17" };
+    std::string cache_dir{};
+
+    // 'compiler' from TENSORGRAD_CXX (or CXX), 'cache_dir' from TENSORGRAD_JIT_CACHE
+    static JitOptions from_environment();
+};
+
+template <class T>
+class CompiledGraph
+{
+private:
+    using Function = void (*)(const T* const*, T* const*, T*);
+
+    Tensor<T>* root;
+    std::vector<Tensor<T>*> inputs;
+    std::vector<Tensor<T>*> targets;
+    std::vector<T> workspace;
+
+    Function function{ nullptr };
+    std::string library;
+    bool cached{ false };
+
+    /*
+    Shared libraries stay loaded for the lifetime of the process,
+    keyed by their path, so every CompiledGraph of the same graph
+    shares one.
+    */
+
+    static void* load(const CodeGenerator<T>& generator, const JitOptions& options, std::string& library, bool& cached);
+
+public:
+    /*
+    Generates code for the graph built up to 'root' and, for each
+    of 'targets', the gradient of 'root' wrt. it (see
+    CodeGenerator), then compiles and loads it, unless a library
+    for the same code is already cached. The compiled graph reads
+    the leaves of the graph when run, so it can be rerun after
+    they change, but not after the graph's structure or shapes do.
+    */
+
+    CompiledGraph(Tensor<T>& root, const std::vector<Tensor<T>*>& targets = {}, const JitOptions& options = JitOptions::from_environment());
+
+    /*
+    Recomputes 'root' from the current values of the leaves, and
+    overwrites the 'grad' of each target (with the target's shape),
+    returning 'root'. 'root' then counts as up to date, so reading
+    it does not recompute the graph (see Tensor<T>::refresh), but
+    the graph's other tensors keep their values. Not safe to call
+    concurrently on one object.
+    */
+
+    Tensor<T>& run();
+
+    // Path of the loaded shared library
+    const std::string& library_path() const;
+
+    // Whether the library was found in the cache rather than compiled
+    bool from_cache() const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include "data_loader.hpp"
+#include "../utils/utils.hpp"
+#include <fstream>
+#include <stdexcept>
+#include <charconv>
+#include <cctype>
+
+template <class T>
+DataLoader<T>::DataLoader(const std::string& path, const Format format, const std::vector<int>& record_shape, const int batch_size, const int num_buffers, const bool skip_header)
+    : path{ path }
+    , format{ format }
+    , batch_shape{ utils::concat_shapes({ batch_size }, record_shape) }
+    , batch_size{ batch_size }
+    , record_size{ utils::prod(record_shape) }
+    , skip_header{ skip_header }
+{
+    if(batch_size <= 0 || num_buffers <= 0)
+        throw std::runtime_error("DataLoader needs a positive batch size and number of buffers.");
+
+    buffers.reserve(num_buffers);
+
+    for(int i = 0; i < num_buffers; ++i)
+        buffers.emplace_back(batch_shape, 0);
+
+    start();
+}
+
+template <class T>
+DataLoader<T>::~DataLoader()
+{
+    stop();
+}
+
+template <class T>
+void DataLoader<T>::start()
+{
+    free_buffers.clear();
+    filled_buffers.clear();
+
+    for(int i = 0; i < static_cast<int>(buffers.size()); ++i)
+        free_buffers.push_back(i);
+
+    finished = false;
+    stopping = false;
+    error = nullptr;
+
+    producer = std::thread{ &DataLoader<T>::produce, this };
+}
+
+template <class T>
+void DataLoader<T>::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        stopping = true;
+    }
+
+    buffer_freed.notify_all();
+
+    if(producer.joinable())
+        producer.join();
+
+    if(held_buffer >= 0)
+    {
+        buffers[held_buffer].ungraph();
+        held_buffer = -1;
+    }
+}
+
+template <class T>
+void DataLoader<T>::produce()
+{
+    /*
+    Background thread: waits for a free buffer, fills it from 
+    the file without holding the lock, and queues it.
+    */
+
+    try
+    {
+        std::ifstream file{ path, format == Format::Binary ? std::ios::binary : std::ios::in };
+
+        if(!file)
+            throw std::runtime_error("Could not open '" + path + "'.");
+
+        int line_number{ 0 };
+        std::string header{};
+
+        if(format == Format::CSV && skip_header && std::getline(file, header))
+            ++line_number;
+
+        while(true)
+        {
+            int buffer{};
+
+            {
+                std::unique_lock<std::mutex> lock{ mutex };
+                buffer_freed.wait(lock, [this]{ return stopping || !free_buffers.empty(); });
+
+                if(stopping)
+                    return;
+
+                buffer = free_buffers.front();
+                free_buffers.pop_front();
+            }
+
+            T* out{ buffers[buffer].data.data() };
+            const bool filled{ format == Format::Binary ? fill_binary(file, out) : fill_csv(file, out, line_number) };
+            buffers[buffer].touch();
+
+            {
+                std::lock_guard<std::mutex> lock{ mutex };
+
+                if(filled)
+                    filled_buffers.push_back(buffer);
+                else
+                {
+                    free_buffers.push_back(buffer);
+                    finished = true;
+                }
+            }
+
+            buffer_filled.notify_one();
+
+            if(!filled)
+                return;
+        }
+    }
+    catch(...)
+    {
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            error = std::current_exception();
+            finished = true;
+        }
+
+        buffer_filled.notify_one();
+    }
+}
+
+template <class T>
+bool DataLoader<T>::fill_binary(std::istream& file, T* out)
+{
+    const std::streamsize size{ static_cast<std::streamsize>(batch_size) * record_size * static_cast<std::streamsize>(sizeof(T)) };
+    file.read(reinterpret_cast<char*>(out), size);
+    return file.gcount() == size;
+}
+
+template <class T>
+bool DataLoader<T>::fill_csv(std::istream& file, T* out, int& line_number)
+{
+    /*
+    Parses 'batch_size' records with std::from_chars, writing 
+    each value directly into the batch. Blank lines are skipped.
+    */
+
+    std::string line{};
+    int record{ 0 };
+
+    while(record < batch_size && std::getline(file, line))
+    {
+        ++line_number;
+
+        const char* ptr{ line.data() };
+        const char* end{ line.data() + line.size() };
+        T* record_out{ out + static_cast<long long>(record) * record_size };
+        int count{ 0 };
+
+        while(true)
+        {
+            while(ptr != end && std::isspace(static_cast<unsigned char>(*ptr)))
+                ++ptr;
+
+            if(ptr == end)
+                break;
+
+            // std::from_chars does not accept a leading '+'
+            if(*ptr == '+')
+                ++ptr;
+
+            if(count == record_size)
+                throw std::runtime_error("Too many values on line " + std::to_string(line_number) + " of '" + path + "'.");
+
+            const auto [next, code]{ std::from_chars(ptr, end, record_out[count]) };
+
+            if(code != std::errc{})
+                throw std::runtime_error("Invalid value on line " + std::to_string(line_number) + " of '" + path + "'.");
+
+            ++count;
+            ptr = next;
+
+            while(ptr != end && std::isspace(static_cast<unsigned char>(*ptr)))
+                ++ptr;
+
+            if(ptr != end && *ptr == ',')
+                ++ptr;
+        }
+
+        if(count == 0)
+            continue;
+
+        if(count != record_size)
+            throw std::runtime_error("Too few values on line " + std::to_string(line_number) + " of '" + path + "'.");
+
+        ++record;
+    }
+
+    return record == batch_size;
+}
+
+template <class T>
+Tensor<T>* DataLoader<T>::next()
+{
+    std::unique_lock<std::mutex> lock{ mutex };
+
+    if(held_buffer >= 0)
+    {
+        buffers[held_buffer].ungraph();
+        free_buffers.push_back(held_buffer);
+        held_buffer = -1;
+        buffer_freed.notify_one();
+    }
+
+    buffer_filled.wait(lock, [this]{ return finished || !filled_buffers.empty(); });
+
+    if(!filled_buffers.empty())
+    {
+        held_buffer = filled_buffers.front();
+        filled_buffers.pop_front();
+        return &buffers[held_buffer];
+    }
+
+    if(error)
+        std::rethrow_exception(error);
+
+    return nullptr;
+}
+
+template <class T>
+void DataLoader<T>::reset()
+{
+    stop();
+    start();
+}
+
+// Template declarations
+
+template class DataLoader<int>;
+template class DataLoader<double>;
+template class DataLoader<long>;
+template class DataLoader<long long>;
\ No newline at end of file
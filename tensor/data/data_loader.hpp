@@ -0,0 +1,84 @@
+#ifndef DATA_LOADER_HPP
+#define DATA_LOADER_HPP
+
+template <class T>
+class Tensor;
+
+#include "../tensor.hpp"
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+template <class T>
+class DataLoader
+{
+public:
+    /*
+    'Binary' files hold raw records of prod(record_shape) values 
+    of type T back to back. 'CSV' files hold one record per line, 
+    with prod(record_shape) comma-separated values.
+    */
+
+    enum class Format { Binary, CSV };
+
+private:
+    /*
+    Batches are parsed on a background thread straight into a ring 
+    of 'num_buffers' pre-allocated leaf tensors of shape 
+    (batch_size, *record_shape), so reading and parsing the next 
+    batches overlaps with computing on the current one. A trailing 
+    partial batch is dropped.
+    */
+
+    const std::string path;
+    const Format format;
+    const std::vector<int> batch_shape;
+    const int batch_size;
+    const int record_size;
+    const bool skip_header;
+
+    std::vector<Tensor<T>> buffers;
+    std::deque<int> free_buffers;
+    std::deque<int> filled_buffers;
+    int held_buffer{ -1 };
+
+    std::thread producer;
+    std::mutex mutex;
+    std::condition_variable buffer_freed;
+    std::condition_variable buffer_filled;
+    bool finished{ false };
+    bool stopping{ false };
+    std::exception_ptr error{};
+
+    void produce();
+    bool fill_binary(std::istream& file, T* out);
+    bool fill_csv(std::istream& file, T* out, int& line_number);
+
+    void start();
+    void stop();
+
+public:
+    DataLoader(const std::string& path, const Format format, const std::vector<int>& record_shape, const int batch_size, const int num_buffers = 2, const bool skip_header = false);
+    ~DataLoader();
+
+    DataLoader(const DataLoader&) = delete;
+    DataLoader& operator=(const DataLoader&) = delete;
+
+    /*
+    Next batch of the epoch, or nullptr once the file is exhausted. 
+    The batch stays valid until the following call to 'next' or 
+    'reset', which hands its buffer back to the loader and removes 
+    any graph built from it (see 'ungraph').
+    */
+
+    Tensor<T>* next();
+
+    // Starts a new epoch from the beginning of the file.
+    void reset();
+};
+
+#endif
\ No newline at end of file
@@ -1,144 +1,882 @@
 #include "engine.hpp"
 #include "../utils/utils.hpp"
+#include "../utils/thread_pool.hpp"
+#include "../utils/profiler.hpp"
+#include "../operations/unary/fill/fill.hpp"
 #include <vector>
 #include <algorithm>
-#include <map>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <exception>
 
 template <class T>
 Tensor<T> Engine<T>::grad(Tensor<T>* node, Tensor<T>* target)
 {
     /*
     Computes the derivative of node with respect to target.
+
+    The tensors between target and node form a DAG of tasks, each 
+    computing the derivative of one tensor from those of its 
+    parents. A task is submitted to the thread pool once all of 
+    its parents are done (dependency counting), so independent 
+    branches run concurrently. Each derivative has its own slot 
+    written by exactly one task, so no locks are needed, and it 
+    is released once the last task using it is done. Tensors that 
+    do not depend on target are skipped entirely.
     */
 
-    if(node == target)
-        return utils::self_derivative<T>(node->shape, true);
+    TENSORGRAD_PROFILE_SCOPE(profile, "Engine::grad", "engine");
+    TENSORGRAD_PROFILE_SET(profile, shape, Profiler::shape_str(node->shape, target->shape));
 
-    else if(!node->has_parents())
-        return Tensor<T>{ { 0 } };
+    node->refresh();
 
-    std::vector<Tensor<T>*> parents{ node->parents };
-    std::vector<Tensor<T>> node_wrt_parents{ node->oper->backward(parents) };
-    
-    const std::vector<int> node_target_shape{ utils::concat_shapes(node->shape, target->shape) };
-    Tensor<T> node_wrt_target{ node_target_shape, 0 };
+    const std::vector<Tensor<T>*> order{ topological_order(node) };
+    const std::unordered_set<Tensor<T>*> depends{ dependents(order, { target }) };
+
+    if(!depends.count(node))
+        return Tensor<T>{ utils::concat_shapes(node->shape, target->shape), 0 };
+
+    std::vector<Tensor<T>*> tensors{};
+    std::unordered_map<Tensor<T>*, int> position{};
+
+    for(Tensor<T>* tensor : order)
+        if(depends.count(tensor))
+        {
+            position[tensor] = static_cast<int>(tensors.size());
+            tensors.push_back(tensor);
+        }
+
+    const int num_tasks{ static_cast<int>(tensors.size()) };
+
+    std::vector<std::vector<int>> consumers(num_tasks);
+    std::vector<std::atomic<int>> pending(num_tasks);
+    std::vector<std::atomic<int>> uses(num_tasks);
 
-    int i{ 0 };
-    for(Tensor<T>* parent : parents)
+    for(int i = 0; i < num_tasks; ++i)
     {
-        Tensor<T> node_wrt_parent = node_wrt_parents[i++];
-        Tensor<T> parent_wrt_target = grad(parent, target);
-        const int parent_dim{ parent->dim };
-        
-        update(node_wrt_target, node_wrt_parent, parent_wrt_target, parent_dim);
+        if(tensors[i] == target)
+            continue;
+
+        for(Tensor<T>* parent : tensors[i]->parents)
+            if(depends.count(parent))
+            {
+                const int p{ position.at(parent) };
+                consumers[p].push_back(i);
+                ++pending[i];
+                ++uses[p];
+            }
     }
 
+    std::vector<std::unique_ptr<Tensor<T>>> derivatives(num_tasks);
+
+    ThreadPool& pool{ ThreadPool::global() };
+    std::atomic<int> in_flight{ 0 };
+    std::atomic<bool> failed{ false };
+    std::exception_ptr error{};
+
+    std::function<void(int)> run = [&](int i)
+    {
+        if(!failed)
+        {
+            try
+            {
+                derivatives[i] = std::make_unique<Tensor<T>>(local_grad(tensors[i], target, position, derivatives, uses));
+
+                for(int consumer : consumers[i])
+                    if(--pending[consumer] == 0)
+                    {
+                        ++in_flight;
+                        pool.submit([&run, consumer]{ run(consumer); });
+                    }
+            }
+            catch(...)
+            {
+                if(!failed.exchange(true))
+                    error = std::current_exception();
+            }
+        }
+
+        --in_flight;
+    };
+
+    /*
+    Every other tensor depends on target through one of its parents, 
+    so target is the only task ready at the start (submitting ready 
+    tasks in a loop would race with the tasks already running).
+    */
+
+    const int target_position{ position.at(target) };
+    ++in_flight;
+    pool.submit([&run, target_position]{ run(target_position); });
+
+    pool.run_until([&in_flight]{ return in_flight == 0; });
+
+    if(error)
+        std::rethrow_exception(error);
+
+    Tensor<T> node_wrt_target{ std::move(*derivatives[position.at(node)]) };
+    TENSORGRAD_PROFILE_SET(profile, elements, static_cast<long long>(node_wrt_target.data.size()));
+    TENSORGRAD_PROFILE_SET(profile, nnz, static_cast<long long>(node_wrt_target.non_zero_idxs.size()));
+
     return node_wrt_target;
 }
 
 template <class T>
-void Engine<T>::update(Tensor<T>& node_wrt_target, const Tensor<T>& node_wrt_parent, const Tensor<T>& parent_wrt_target, const int parent_dim)
+Tensor<T> Engine<T>::local_grad(Tensor<T>* tensor, Tensor<T>* target, const std::unordered_map<Tensor<T>*, int>& position, std::vector<std::unique_ptr<Tensor<T>>>& derivatives, std::vector<std::atomic<int>>& uses)
 {
-    if(parent_wrt_target.non_zero_idxs.size() == 0)
-        return;
+    /*
+    Derivative of 'tensor' wrt. 'target' from the (completed) 
+    derivatives of its parents, releasing each parent derivative 
+    after its last use.
+    */
+
+    if(tensor == target)
+        return utils::self_derivative<T>(tensor->shape, true);
+
+    const std::vector<Tensor<T>*>& parents{ tensor->parents };
+    const std::vector<SparseRows> tensor_wrt_parents{ local_jacobians(tensor, position) };
+
+    const utils::Shape tensor_target_shape{ utils::concat_shapes(tensor->shape, target->shape) };
+    Tensor<T> tensor_wrt_target{ tensor_target_shape, 0 };
+
+    for(int i = 0; i < static_cast<int>(parents.size()); ++i)
+    {
+        const auto& iter{ position.find(parents[i]) };
+
+        if(iter == position.end())
+            continue;
+
+        const int p{ iter->second };
+        update(tensor_wrt_target, tensor_wrt_parents[i], *derivatives[p], parents[i]->dim);
+
+        if(--uses[p] == 0)
+            derivatives[p].reset();
+    }
+
+    if(Operation<T>::cache_policy() == JacobianCache::Recompute)
+        tensor->oper->release_jacobians();
+
+    tensor_wrt_target.sync_memory();
+    return tensor_wrt_target;
+}
+
+template <class T>
+typename Engine<T>::SparseJacobian Engine<T>::sparse_grad(Tensor<T>* node, Tensor<T>* target)
+{
+    /*
+    Jacobian by Curtis-Powell-Reid compression. A first sweep from 
+    target to node propagates the sparsity pattern of each 
+    derivative (the target elements each element depends on), 
+    read from the 'non_zero_idxs' of the Jacobians of each 
+    operation. Columns (target elements) that share no row in the 
+    pattern of node are given the same colour, and a second sweep 
+    propagates one derivative per colour, wrt. the sum of the 
+    target elements of that colour, rather than one per target 
+    element. Each non-zero is the only one of its colour in its 
+    row, so it is read back from the compressed derivative of node.
+    */
+
+    TENSORGRAD_PROFILE_SCOPE(profile, "Engine::sparse_grad", "engine");
+    TENSORGRAD_PROFILE_SET(profile, shape, Profiler::shape_str(node->shape, target->shape));
+
+    node->refresh();
+
+    const std::vector<Tensor<T>*> order{ topological_order(node) };
+    const std::unordered_set<Tensor<T>*> depends{ dependents(order, { target }) };
+
+    const int num_rows{ utils::prod(node->shape) };
+    const int num_cols{ utils::prod(target->shape) };
+
+    SparseJacobian jacobian{ node->shape, target->shape, std::vector<int>(num_rows + 1, 0), {}, {}, 0 };
+
+    if(!depends.count(node))
+        return jacobian;
+
+    std::vector<Tensor<T>*> tensors{};
+    std::unordered_map<Tensor<T>*, int> position{};
+
+    for(Tensor<T>* tensor : order)
+        if(depends.count(tensor))
+        {
+            position[tensor] = static_cast<int>(tensors.size());
+            tensors.push_back(tensor);
+        }
+
+    const int num_tensors{ static_cast<int>(tensors.size()) };
+
+    /*
+    Jacobian of each tensor wrt. each parent it depends on target 
+    through (by position), read once and used by both sweeps.
+    */
+
+    std::vector<std::vector<std::pair<int, SparseRows>>> locals(num_tensors);
+    std::vector<int> uses(num_tensors, 0);
+
+    for(int i = 0; i < num_tensors; ++i)
+    {
+        Tensor<T>* tensor{ tensors[i] };
+
+        if(tensor == target)
+            continue;
+
+        const std::vector<Tensor<T>*>& parents{ tensor->parents };
+        std::vector<SparseRows> tensor_wrt_parents{ local_jacobians(tensor, position) };
 
-    std::map<std::vector<int>, std::vector<int>> cache;
+        for(int k = 0; k < static_cast<int>(parents.size()); ++k)
+        {
+            const auto& iter{ position.find(parents[k]) };
+
+            if(iter == position.end())
+                continue;
+
+            /*
+            'non_zero_idxs' can list entries that are zero (e.g. every 
+            entry of a matrix in the Jacobian of Matmul), which would 
+            only widen the pattern, so they are dropped.
+            */
+
+            SparseRows local{ std::move(tensor_wrt_parents[k]) };
+            int nnz{ 0 };
+
+            for(int row = 0; row + 1 < static_cast<int>(local.offsets.size()); ++row)
+            {
+                const int begin{ local.offsets[row] };
+                local.offsets[row] = nnz;
+
+                for(int j = begin; j < local.offsets[row+1]; ++j)
+                    if(local.values[j] != 0)
+                    {
+                        local.cols[nnz] = local.cols[j];
+                        local.values[nnz++] = local.values[j];
+                    }
+            }
+
+            local.offsets.back() = nnz;
+            local.cols.resize(nnz);
+            local.values.resize(nnz);
+
+            locals[i].emplace_back(iter->second, std::move(local));
+            ++uses[iter->second];
+        }
+
+        if(Operation<T>::cache_policy() == JacobianCache::Recompute)
+            tensor->oper->release_jacobians();
+    }
+
+    // Sparsity sweep
 
-    bool first_run{ true };
-    for(std::vector<int> n_wrt_p_idx : node_wrt_parent.non_zero_idxs)
+    std::vector<SparseRows> patterns(num_tensors);
+    std::vector<int> remaining{ uses };
+
+    for(int i = 0; i < num_tensors; ++i)
     {
-        if(first_run)
+        const int rows{ static_cast<int>(tensors[i]->data.size()) };
+        SparseRows& pattern{ patterns[i] };
+
+        if(tensors[i] == target)
         {
-            first_update(cache, node_wrt_target, node_wrt_parent, parent_wrt_target, n_wrt_p_idx, parent_dim);
-            first_run = false;
+            pattern.offsets.resize(rows + 1);
+            pattern.cols.resize(rows);
+
+            for(int row = 0; row <= rows; ++row)
+                pattern.offsets[row] = row;
+
+            for(int row = 0; row < rows; ++row)
+                pattern.cols[row] = row;
+
             continue;
         }
 
-        cached_update(cache, node_wrt_target, node_wrt_parent, parent_wrt_target, n_wrt_p_idx, parent_dim);
+        std::vector<std::vector<int>> row_cols(rows);
+
+        utils::parallel_for(0, rows, [&](int row_begin, int row_end)
+        {
+            std::vector<int> stamp(num_cols, -1);
+
+            for(int row = row_begin; row < row_end; ++row)
+            {
+                for(const auto& [p, local] : locals[i])
+                    for(int j = local.offsets[row]; j < local.offsets[row+1]; ++j)
+                    {
+                        const int q{ local.cols[j] };
+
+                        for(int k = patterns[p].offsets[q]; k < patterns[p].offsets[q+1]; ++k)
+                        {
+                            const int col{ patterns[p].cols[k] };
+
+                            if(stamp[col] != row)
+                            {
+                                stamp[col] = row;
+                                row_cols[row].push_back(col);
+                            }
+                        }
+                    }
+
+                std::sort(row_cols[row].begin(), row_cols[row].end());
+            }
+        }
+        , 64);
+
+        pattern.offsets.assign(rows + 1, 0);
+
+        for(int row = 0; row < rows; ++row)
+        {
+            pattern.offsets[row + 1] = pattern.offsets[row] + static_cast<int>(row_cols[row].size());
+            pattern.cols.insert(pattern.cols.end(), row_cols[row].begin(), row_cols[row].end());
+        }
+
+        for(const auto& [p, local] : locals[i])
+            if(--remaining[p] == 0)
+                patterns[p] = SparseRows{};
+    }
+
+    const SparseRows& node_pattern{ patterns[position.at(node)] };
+    const std::vector<int> colors{ color_columns(node_pattern, num_cols, jacobian.colors) };
+    const int num_colors{ jacobian.colors };
+
+    // Compressed sweep, with 'num_colors' values per element
+
+    std::vector<std::vector<T>> compressed(num_tensors);
+    remaining = uses;
+
+    for(int i = 0; i < num_tensors; ++i)
+    {
+        const int rows{ static_cast<int>(tensors[i]->data.size()) };
+        compressed[i].assign(static_cast<std::size_t>(rows) * num_colors, 0);
+
+        if(tensors[i] == target)
+        {
+            for(int row = 0; row < rows; ++row)
+                compressed[i][static_cast<std::size_t>(row) * num_colors + colors[row]] = 1;
+
+            continue;
+        }
+
+        utils::parallel_for(0, rows, [&](int row_begin, int row_end)
+        {
+            for(int row = row_begin; row < row_end; ++row)
+            {
+                T* out{ compressed[i].data() + static_cast<std::size_t>(row) * num_colors };
+
+                for(const auto& [p, local] : locals[i])
+                    for(int j = local.offsets[row]; j < local.offsets[row+1]; ++j)
+                    {
+                        const T value{ local.values[j] };
+                        const T* in{ compressed[p].data() + static_cast<std::size_t>(local.cols[j]) * num_colors };
+
+                        for(int c = 0; c < num_colors; ++c)
+                            out[c] += value * in[c];
+                    }
+            }
+        }
+        , 64);
+
+        for(const auto& [p, local] : locals[i])
+            if(--remaining[p] == 0)
+                std::vector<T>{}.swap(compressed[p]);
+
+        locals[i].clear();
     }
+
+    // Recovery
+
+    const std::vector<T>& node_compressed{ compressed[position.at(node)] };
+
+    jacobian.offsets = node_pattern.offsets;
+    jacobian.cols = node_pattern.cols;
+    jacobian.values.resize(node_pattern.cols.size());
+
+    for(int row = 0; row < num_rows; ++row)
+        for(int k = node_pattern.offsets[row]; k < node_pattern.offsets[row+1]; ++k)
+            jacobian.values[k] = node_compressed[static_cast<std::size_t>(row) * num_colors + colors[node_pattern.cols[k]]];
+
+    TENSORGRAD_PROFILE_SET(profile, elements, static_cast<long long>(num_rows) * num_colors);
+    TENSORGRAD_PROFILE_SET(profile, nnz, static_cast<long long>(jacobian.values.size()));
+
+    return jacobian;
 }
 
 template <class T>
-void Engine<T>::first_update(std::map<std::vector<int>, std::vector<int>>& cache, Tensor<T>& node_wrt_target, const Tensor<T>& node_wrt_parent, const Tensor<T>& parent_wrt_target, const std::vector<int>& n_wrt_p_idx, const int parent_dim)
+Tensor<T> Engine<T>::SparseJacobian::to_dense() const
 {
-    int node_dim{ node_wrt_parent.dim - parent_dim };
-    int cache_index{ 0 };
+    const int num_cols{ utils::prod(target_shape) };
+    Tensor<T> dense{ utils::concat_shapes(node_shape, target_shape), 0 };
 
-    for(std::vector<int> p_wrt_t_idx : parent_wrt_target.non_zero_idxs)
+    for(int row = 0; row + 1 < static_cast<int>(offsets.size()); ++row)
     {
-        std::vector<int> p_idx{};
+        const utils::Shape node_idx{ utils::unflatten_index(row, node_shape) };
 
-        bool is_valid{ true };
-        for(int i = 0; i < parent_dim; ++i)
+        for(int k = offsets[row]; k < offsets[row+1]; ++k)
         {
-            if(n_wrt_p_idx[node_dim+i] != p_wrt_t_idx[i])
-                is_valid = false;
+            const utils::Shape idx{ utils::concat_shapes(node_idx, utils::unflatten_index(cols[k], target_shape)) };
+            dense.data[static_cast<std::size_t>(row) * num_cols + cols[k]] = values[k];
+            dense.non_zero_idxs.push_back(idx);
+        }
+    }
+
+    dense.sync_memory();
+    return dense;
+}
+
+template <class T>
+Tensor<T> Engine<T>::forward_grad(Tensor<T>* node, Tensor<T>* target)
+{
+    /*
+    Forward-mode counterpart of 'grad'. Requires 'target' to have 
+    been seeded with 'seed_tangent_basis' before 'node' was computed, 
+    such that the tangents of node hold d node / d target with the 
+    target index leading. The result has the same layout as 'grad'.
+    */
+
+    if(!node->tangent)
+        return Tensor<T>{ utils::concat_shapes(node->shape, target->shape), 0 };
 
-            p_idx.push_back(p_wrt_t_idx[i]);
+    const int target_size{ static_cast<int>(target->data.size()) };
+    const int node_size{ static_cast<int>(node->data.size()) };
+
+    if(!target->tangent || (target->tangent->shape[0] != target_size) || (node->tangent->shape[0] != target_size))
+        throw std::runtime_error("Target was not seeded with a tangent basis.");
+
+    Tensor<T> node_wrt_target{ utils::concat_shapes(node->shape, target->shape), 0 };
+    const std::vector<T>& tangents{ node->tangent->data };
+
+    for(int n = 0; n < node_size; ++n)
+    {
+        const utils::Shape node_idx{ utils::unflatten_index(n, node->shape) };
+
+        for(int t = 0; t < target_size; ++t)
+        {
+            const T value{ tangents[t*node_size + n] };
+            if(value == 0)
+                continue;
+
+            node_wrt_target.data[n*target_size + t] = value;
+            node_wrt_target.non_zero_idxs.push_back(utils::concat_shapes(node_idx, utils::unflatten_index(t, target->shape)));
         }
+    }
+
+    return node_wrt_target;
+}
+
+template <class T>
+std::vector<Tensor<T>*> Engine<T>::grad_graph(Tensor<T>* node, const std::vector<Tensor<T>*>& targets)
+{
+    /*
+    Reverse-mode derivative of a scalar 'node' wrt. each target, 
+    built from graph operations through each operation's 'vjp', 
+    so that the results can be differentiated again. Tangents 
+    seeded before the forward pass propagate through these 
+    operations as well (forward-over-reverse, see 'hvp').
+    */
 
-        const auto& iter{ cache.find(p_idx) };
+    if(!node->is_scalar)
+        throw std::runtime_error("create_graph requires a scalar tensor.");
 
-        if(iter != cache.end())
-            iter->second.push_back(cache_index);
-        
-        else
-            cache.insert({p_idx, { cache_index }});
+    node->refresh();
 
-        ++cache_index;
+    const std::vector<Tensor<T>*> order{ topological_order(node) };
+    const std::unordered_set<Tensor<T>*> depends{ dependents(order, targets) };
 
+    for(Tensor<T>* tensor : order)
+        if(depends.count(tensor) && tensor->has_parents() && !tensor->oper->has_vjp())
+            throw std::runtime_error(Profiler::type_name(typeid(*(tensor->oper))) + " has no differentiable backward, so create_graph is not supported.");
 
-        if(!is_valid)
+    std::unordered_map<Tensor<T>*, Tensor<T>*> adjoints{};
+
+    if(depends.count(node))
+    {
+        Fill<T>* oper = new Fill<T>(1);
+        adjoints[node] = &oper->forward(*node);
+    }
+
+    for(auto iter = order.rbegin(); iter != order.rend(); ++iter)
+    {
+        Tensor<T>* tensor{ *iter };
+        const auto& adjoint{ adjoints.find(tensor) };
+
+        if((adjoint == adjoints.end()) || !tensor->has_parents())
             continue;
 
-        std::vector<int> n_wrt_t_idx{ get_n_wrt_t_idx(n_wrt_p_idx, p_wrt_t_idx, parent_dim) };
+        std::vector<Tensor<T>*> parents{ tensor->parents };
+        std::vector<Tensor<T>*> contributions{ tensor->oper->vjp(parents, *tensor, *(adjoint->second)) };
+
+        for(int i = 0; i < static_cast<int>(parents.size()); ++i)
+        {
+            if(!contributions[i] || !depends.count(parents[i]))
+                continue;
+
+            const auto& existing{ adjoints.find(parents[i]) };
+
+            if(existing == adjoints.end())
+                adjoints[parents[i]] = contributions[i];
+            else
+                existing->second = &(*(existing->second) + *contributions[i]);
+        }
+    }
+
+    std::vector<Tensor<T>*> grads{};
+
+    for(Tensor<T>* target : targets)
+    {
+        const auto& adjoint{ adjoints.find(target) };
+
+        if(adjoint != adjoints.end())
+        {
+            grads.push_back(adjoint->second);
+            continue;
+        }
+
+        Fill<T>* oper = new Fill<T>(0);
+        grads.push_back(&oper->forward(*target));
+    }
+
+    return grads;
+}
+
+template <class T>
+Tensor<T> Engine<T>::hvp(Tensor<T>* node, Tensor<T>* target)
+{
+    /*
+    Hessian-vector product of a scalar 'node' wrt. 'target' by 
+    forward-over-reverse. Requires 'target' to have been seeded 
+    with 'seed_tangent(v)' before 'node' was computed; returns the 
+    tangent of d node / d target, i.e. H v, of shape 
+    (num_tangents, *target.shape).
+    */
+
+    if(!target->tangent)
+        throw std::runtime_error("Target was not seeded with a tangent.");
+
+    Tensor<T>* grad{ grad_graph(node, { target })[0] };
+
+    if(!grad->tangent)
+        return Tensor<T>{ target->tangent->shape, 0 };
+
+    return Tensor<T>{ grad->tangent->data, grad->tangent->shape };
+}
+
+template <class T>
+void Engine<T>::release_jacobians(Tensor<T>* node)
+{
+    for(Tensor<T>* tensor : topological_order(node))
+        if(tensor->oper)
+            tensor->oper->release_jacobians();
+}
+
+template <class T>
+std::vector<Tensor<T>*> Engine<T>::topological_order(Tensor<T>* node)
+{
+    /*
+    Tensors that 'node' was produced from (including itself), 
+    ordered such that every tensor comes after its parents. 
+    Uses an explicit stack rather than recursion.
+    */
 
-        node_wrt_target(n_wrt_t_idx) += node_wrt_parent(n_wrt_p_idx) * parent_wrt_target(p_wrt_t_idx);
-        
-        if(std::find(node_wrt_target.non_zero_idxs.begin(), node_wrt_target.non_zero_idxs.end(), n_wrt_t_idx) == node_wrt_target.non_zero_idxs.end())
-            node_wrt_target.non_zero_idxs.push_back(n_wrt_t_idx);
+    std::vector<Tensor<T>*> order{};
+    std::unordered_set<Tensor<T>*> visited{ node };
+    std::vector<std::pair<Tensor<T>*, int>> stack{ { node, 0 } };
+
+    while(!stack.empty())
+    {
+        auto& [tensor, next_parent] = stack.back();
+
+        if(next_parent < static_cast<int>(tensor->parents.size()))
+        {
+            Tensor<T>* parent{ tensor->parents[next_parent++] };
+
+            if(parent && visited.insert(parent).second)
+                stack.push_back({ parent, 0 });
+
+            continue;
+        }
+
+        order.push_back(tensor);
+        stack.pop_back();
     }
+
+    return order;
 }
 
 template <class T>
-void Engine<T>::cached_update(const std::map<std::vector<int>, std::vector<int>>& cache, Tensor<T>& node_wrt_target, const Tensor<T>& node_wrt_parent, const Tensor<T>& parent_wrt_target, const std::vector<int>& n_wrt_p_idx, const int parent_dim)
+std::unordered_set<Tensor<T>*> Engine<T>::dependents(const std::vector<Tensor<T>*>& order, const std::vector<Tensor<T>*>& targets)
 {
-    int node_dim{ node_wrt_parent.dim - parent_dim };
-    std::vector<int> p_idx{};
+    /*
+    Tensors in 'order' (topologically sorted) that are one of 
+    'targets' or were produced from one of them.
+    */
+
+    const std::unordered_set<Tensor<T>*> target_set(targets.begin(), targets.end());
+    std::unordered_set<Tensor<T>*> depends{};
+
+    for(Tensor<T>* tensor : order)
+    {
+        bool tensor_depends{ target_set.count(tensor) > 0 };
+
+        for(Tensor<T>* parent : tensor->parents)
+            if(depends.count(parent))
+                tensor_depends = true;
 
-    for(int i = 0; i < parent_dim; ++i)
-        p_idx.push_back(n_wrt_p_idx[node_dim+i]);
+        if(tensor_depends)
+            depends.insert(tensor);
+    }
+
+    return depends;
+}
 
-    const auto& iter{ cache.find(p_idx) };
+template <class T>
+void Engine<T>::update(Tensor<T>& node_wrt_target, const SparseRows& node_wrt_parent, const Tensor<T>& parent_wrt_target, const int parent_dim)
+{
+    /*
+    Accumulates node_wrt_target += node_wrt_parent * parent_wrt_target, 
+    contracting over the indices of the parent. Both factors are 
+    viewed as sparse matrices built from their 'non_zero_idxs', 
+    and the product is formed row by row (rows being the flattened 
+    node indices). Rows are processed in chunks of 'chunk_rows', 
+    each chunk split across threads, every thread writing only to 
+    its own rows with its own scratch accumulator.
+    */
 
-    if(iter == cache.end())
+    if((parent_wrt_target.non_zero_idxs.size() == 0) || node_wrt_parent.cols.empty())
         return;
 
-    for(int i : iter->second)
+    TENSORGRAD_PROFILE_SCOPE(profile, "Engine::update", "engine");
+    TENSORGRAD_PROFILE_SET(profile, shape, Profiler::shape_str(node_wrt_target.shape, parent_wrt_target.shape));
+    TENSORGRAD_PROFILE_SET(profile, nnz, static_cast<long long>(node_wrt_parent.cols.size() + parent_wrt_target.non_zero_idxs.size()));
+
+    const int node_dim{ node_wrt_target.dim - (parent_wrt_target.dim - parent_dim) };
+    const utils::Shape node_shape(node_wrt_target.shape.begin(), node_wrt_target.shape.begin() + node_dim);
+    const utils::Shape target_shape(node_wrt_target.shape.begin() + node_dim, node_wrt_target.shape.end());
+
+    const int node_size{ utils::prod(node_shape) };
+    const int target_size{ utils::prod(target_shape) };
+
+    const SparseRows& node_rows{ node_wrt_parent };
+    const SparseRows parent_rows{ to_sparse_rows(parent_wrt_target, parent_dim) };
+    const SparseRows existing_rows{ to_sparse_rows(node_wrt_target, node_dim) };
+
+    T* out{ node_wrt_target.data.data() };
+
+    for(int chunk_begin = 0; chunk_begin < node_size; chunk_begin += chunk_rows)
     {
-        std::vector<int> p_wrt_t_idx{ parent_wrt_target.non_zero_idxs[i] };
-        std::vector<int> n_wrt_t_idx{ get_n_wrt_t_idx(n_wrt_p_idx, p_wrt_t_idx, parent_dim) };
-    
-        node_wrt_target(n_wrt_t_idx) += node_wrt_parent(n_wrt_p_idx) * parent_wrt_target(p_wrt_t_idx);
+        const int chunk_end{ std::min(node_size, chunk_begin + chunk_rows) };
+        std::vector<std::vector<int>> new_cols(chunk_end - chunk_begin);
+
+        utils::parallel_for(chunk_begin, chunk_end, [&](int row_begin, int row_end)
+        {
+            /*
+            'state' is 0 for untouched columns, 1 for columns touched 
+            in this row and 2 for touched columns already non-zero 
+            in node_wrt_target.
+            */
+
+            std::vector<T> accum(target_size, 0);
+            std::vector<char> state(target_size, 0);
+            std::vector<int> touched{};
+
+            for(int row = row_begin; row < row_end; ++row)
+            {
+                for(int i = node_rows.offsets[row]; i < node_rows.offsets[row+1]; ++i)
+                {
+                    const int p{ node_rows.cols[i] };
+                    const T n_wrt_p{ node_rows.values[i] };
+
+                    for(int j = parent_rows.offsets[p]; j < parent_rows.offsets[p+1]; ++j)
+                    {
+                        const int t{ parent_rows.cols[j] };
+
+                        if(!state[t])
+                        {
+                            state[t] = 1;
+                            touched.push_back(t);
+                        }
+
+                        accum[t] += n_wrt_p * parent_rows.values[j];
+                    }
+                }
+
+                if(touched.empty())
+                    continue;
+
+                for(int i = existing_rows.offsets[row]; i < existing_rows.offsets[row+1]; ++i)
+                    if(state[existing_rows.cols[i]])
+                        state[existing_rows.cols[i]] = 2;
+
+                std::vector<int>& row_new_cols{ new_cols[row - chunk_begin] };
+
+                for(int t : touched)
+                {
+                    out[row*target_size + t] += accum[t];
+
+                    if(state[t] == 1)
+                        row_new_cols.push_back(t);
+
+                    accum[t] = 0;
+                    state[t] = 0;
+                }
+
+                touched.clear();
+            }
+        }
+        , 64);
+
+        for(int row = chunk_begin; row < chunk_end; ++row)
+        {
+            if(new_cols[row - chunk_begin].empty())
+                continue;
+
+            const utils::Shape node_idx{ utils::unflatten_index(row, node_shape) };
+
+            for(int t : new_cols[row - chunk_begin])
+                node_wrt_target.non_zero_idxs.push_back(utils::concat_shapes(node_idx, utils::unflatten_index(t, target_shape)));
+        }
+    }
+}
+
+template <class T>
+std::vector<typename Engine<T>::SparseRows> Engine<T>::local_jacobians(Tensor<T>* tensor, const std::unordered_map<Tensor<T>*, int>& position)
+{
+    /*
+    Jacobians of 'tensor' wrt. its parents, as sparse rows for those 
+    in 'position' (left empty for the others). Operations without 
+    dense Jacobians produce the sparse rows directly.
+    */
+
+    std::vector<Tensor<T>*> parents{ tensor->parents };
+
+    if(!tensor->oper->has_jacobians())
+        return tensor->oper->sparse_backward(parents);
+
+    const std::vector<Tensor<T>>& tensor_wrt_parents{ tensor->oper->backward(parents) };
+    std::vector<SparseRows> rows(parents.size());
+
+    for(int i = 0; i < static_cast<int>(parents.size()); ++i)
+        if(position.count(parents[i]))
+            rows[i] = to_sparse_rows(tensor_wrt_parents[i], tensor->dim);
+
+    return rows;
+}
+
+template <class T>
+typename Engine<T>::SparseRows Engine<T>::to_sparse_rows(const Tensor<T>& tensor, const int row_dim)
+{
+    const utils::Shape row_shape(tensor.shape.begin(), tensor.shape.begin() + row_dim);
+    const utils::Shape col_shape(tensor.shape.begin() + row_dim, tensor.shape.end());
     
-        if(std::find(node_wrt_target.non_zero_idxs.begin(), node_wrt_target.non_zero_idxs.end(), n_wrt_t_idx) == node_wrt_target.non_zero_idxs.end())
-            node_wrt_target.non_zero_idxs.push_back(n_wrt_t_idx);
+    const int num_rows{ utils::prod(row_shape) };
+    const int num_cols{ utils::prod(col_shape) };
+    const int nnz{ static_cast<int>(tensor.non_zero_idxs.size()) };
+
+    std::vector<int> entry_rows(nnz);
+    std::vector<int> entry_cols(nnz);
+
+    SparseRows sparse{};
+    sparse.offsets.assign(num_rows + 1, 0);
+
+    for(int i = 0; i < nnz; ++i)
+    {
+        const utils::Shape& idx{ tensor.non_zero_idxs[i] };
+
+        int row{ 0 }, col{ 0 };
+        for(int d = 0; d < row_dim; ++d)
+            row = row * row_shape[d] + idx[d];
+
+        for(int d = row_dim; d < tensor.dim; ++d)
+            col = col * col_shape[d - row_dim] + idx[d];
+
+        entry_rows[i] = row;
+        entry_cols[i] = col;
+        ++sparse.offsets[row + 1];
+    }
+
+    for(int row = 0; row < num_rows; ++row)
+        sparse.offsets[row + 1] += sparse.offsets[row];
+
+    sparse.cols.resize(nnz);
+    sparse.values.resize(nnz);
+    std::vector<int> fill(sparse.offsets.begin(), sparse.offsets.end() - 1);
+
+    for(int i = 0; i < nnz; ++i)
+    {
+        const int pos{ fill[entry_rows[i]]++ };
+        sparse.cols[pos] = entry_cols[i];
+        sparse.values[pos] = tensor.data[entry_rows[i] * num_cols + entry_cols[i]];
     }
+
+    return sparse;
 }
 
 template <class T>
-std::vector<int> Engine<T>::get_n_wrt_t_idx(const std::vector<int>& n_wrt_p_idx, const std::vector<int>& p_wrt_t_idx, const int parent_dim)
+std::vector<int> Engine<T>::color_columns(const SparseRows& pattern, const int num_cols, int& num_colors)
 {
-    const int node_dim{ static_cast<int>(n_wrt_p_idx.size()) - parent_dim };
-    std::vector<int> n_wrt_t_idx{};
+    /*
+    'forbidden[c] == col' marks colour c as taken by a column 
+    sharing a row with 'col'.
+    */
+
+    const int num_rows{ static_cast<int>(pattern.offsets.size()) - 1 };
+
+    std::vector<int> col_offsets(num_cols + 1, 0);
+
+    for(const int col : pattern.cols)
+        ++col_offsets[col + 1];
+
+    for(int col = 0; col < num_cols; ++col)
+        col_offsets[col + 1] += col_offsets[col];
+
+    std::vector<int> col_rows(pattern.cols.size());
+    std::vector<int> fill(col_offsets.begin(), col_offsets.end() - 1);
 
-    for(int i = 0; i < node_dim; ++i)
-        n_wrt_t_idx.push_back(n_wrt_p_idx[i]);
+    for(int row = 0; row < num_rows; ++row)
+        for(int k = pattern.offsets[row]; k < pattern.offsets[row+1]; ++k)
+            col_rows[fill[pattern.cols[k]]++] = row;
 
-    for(int i = parent_dim; i < p_wrt_t_idx.size(); ++i)
-        n_wrt_t_idx.push_back(p_wrt_t_idx[i]);
+    std::vector<int> by_degree(num_cols);
+
+    for(int col = 0; col < num_cols; ++col)
+        by_degree[col] = col;
+
+    std::stable_sort(by_degree.begin(), by_degree.end(), [&col_offsets](const int col1, const int col2)
+    {
+        return col_offsets[col1 + 1] - col_offsets[col1] > col_offsets[col2 + 1] - col_offsets[col2];
+    });
+
+    std::vector<int> colors(num_cols, 0);
+    std::vector<int> colored(num_cols, 0);
+    std::vector<int> forbidden{};
+    num_colors = 0;
+
+    for(const int col : by_degree)
+    {
+        for(int k = col_offsets[col]; k < col_offsets[col+1]; ++k)
+        {
+            const int row{ col_rows[k] };
+
+            for(int j = pattern.offsets[row]; j < pattern.offsets[row+1]; ++j)
+                if(colored[pattern.cols[j]])
+                    forbidden[colors[pattern.cols[j]]] = col;
+        }
+
+        int color{ 0 };
+
+        while((color < num_colors) && (forbidden[color] == col))
+            ++color;
+
+        if(color == num_colors)
+        {
+            ++num_colors;
+            forbidden.push_back(-1);
+        }
+
+        colors[col] = color;
+        colored[col] = 1;
+    }
 
-    return n_wrt_t_idx;
+    return colors;
 }
 
 // Template declarations
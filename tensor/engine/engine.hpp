@@ -2,20 +2,92 @@
 #define ENGINE_HPP
 
 #include "../tensor.hpp"
-#include <map>
+#include <vector>
+#include <unordered_set>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
 
 template <class T>
 class Engine
 {
 public:
+    /*
+    Derivative of a node wrt. a target as a compressed sparse row 
+    matrix, rows being the flattened indices of the node and 
+    columns the flattened indices of the target. 'colors' is the 
+    number of compressed columns it was recovered from.
+    */
+
+    struct SparseJacobian
+    {
+        utils::Shape node_shape;
+        utils::Shape target_shape;
+        std::vector<int> offsets;
+        std::vector<int> cols;
+        std::vector<T> values;
+        int colors{ 0 };
+
+        // Derivative tensor of shape (*node_shape, *target_shape), as returned by 'grad'
+        Tensor<T> to_dense() const;
+    };
+
     static Tensor<T> grad(Tensor<T>* node, Tensor<T>* target);
+
+    /*
+    Same derivative as 'grad', for Jacobians that are large but 
+    structurally sparse (e.g. of a discretised PDE). Its cost 
+    grows with the number of colours (at least the largest number 
+    of non-zeros in a row, 3 for a tridiagonal Jacobian) rather 
+    than with the size of 'target'.
+    */
+
+    static SparseJacobian sparse_grad(Tensor<T>* node, Tensor<T>* target);
+
+    static Tensor<T> forward_grad(Tensor<T>* node, Tensor<T>* target);
+
+    static std::vector<Tensor<T>*> grad_graph(Tensor<T>* node, const std::vector<Tensor<T>*>& targets);
+
+    static Tensor<T> hvp(Tensor<T>* node, Tensor<T>* target);
+
+    // Frees the Jacobians cached by the operations 'node' was produced by
+    static void release_jacobians(Tensor<T>* node);
     
 private:
-    static void update(Tensor<T>& node_wrt_target, const Tensor<T>& node_wrt_parent, const Tensor<T>& parent_wrt_target, const int parent_dim);
-    static void first_update(std::map<std::vector<int>, std::vector<int>>& cache, Tensor<T>& node_wrt_target, const Tensor<T>& node_wrt_parent, const Tensor<T>& parent_wrt_target, const std::vector<int>& n_wrt_p_idx, const int parent_dim);
-    static void cached_update(const std::map<std::vector<int>, std::vector<int>>& cache, Tensor<T>& node_wrt_target, const Tensor<T>& node_wrt_parent, const Tensor<T>& parent_wrt_target, const std::vector<int>& n_wrt_p_idx, const int parent_dim);
-    
-    static std::vector<int> get_n_wrt_t_idx(const std::vector<int>& n_wrt_p_idx, const std::vector<int>& p_wrt_t_idx, const int parent_dim);
+    /*
+    Compressed sparse row view of a derivative tensor, where 
+    the first 'row_dim' indices (flattened) are the row and 
+    the remaining indices (flattened) are the column.
+    */
+
+    using SparseRows = typename Operation<T>::SparseRows;
+
+    /*
+    Number of output rows contracted per chunk in 'update', 
+    bounding the scratch memory held at once.
+    */
+
+    static constexpr int chunk_rows{ 4096 };
+
+    static Tensor<T> local_grad(Tensor<T>* tensor, Tensor<T>* target, const std::unordered_map<Tensor<T>*, int>& position, std::vector<std::unique_ptr<Tensor<T>>>& derivatives, std::vector<std::atomic<int>>& uses);
+
+    static void update(Tensor<T>& node_wrt_target, const SparseRows& node_wrt_parent, const Tensor<T>& parent_wrt_target, const int parent_dim);
+
+    static std::vector<SparseRows> local_jacobians(Tensor<T>* tensor, const std::unordered_map<Tensor<T>*, int>& position);
+
+    static SparseRows to_sparse_rows(const Tensor<T>& tensor, const int row_dim);
+
+    /*
+    Greedy colouring of the columns of 'pattern' (largest column 
+    first) such that no two columns sharing a row have the same 
+    colour, returning the colour of each column.
+    */
+
+    static std::vector<int> color_columns(const SparseRows& pattern, const int num_cols, int& num_colors);
+
+    static std::vector<Tensor<T>*> topological_order(Tensor<T>* node);
+
+    static std::unordered_set<Tensor<T>*> dependents(const std::vector<Tensor<T>*>& order, const std::vector<Tensor<T>*>& targets);
 };
 
 #endif
\ No newline at end of file
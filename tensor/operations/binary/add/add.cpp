@@ -3,6 +3,7 @@
 #include "../../../tensor.hpp"
 #include <cassert>
 #include <vector>
+#include <utility>
 
 template <class T>
 Tensor<T>& Add<T>::_forward(Tensor<T>& tensor1, Tensor<T>& tensor2)
@@ -11,20 +12,66 @@ Tensor<T>& Add<T>::_forward(Tensor<T>& tensor1, Tensor<T>& tensor2)
 
     Tensor<T>* out = new Tensor<T>{ tensor1.shape, 0 };
 
-    out->modify([&tensor1, &tensor2](Tensor<T>& tensor, const std::vector<int>& index)
-    {
-        tensor(index) = tensor1(index) + tensor2(index);
-    }
-    , out->shape);
+    const std::vector<T>& values1{ this->values(tensor1) };
+    const std::vector<T>& values2{ this->values(tensor2) };
+    std::vector<T>& result{ this->values(*out) };
+
+    for(int i = 0; i < static_cast<int>(result.size()); ++i)
+        result[i] = values1[i] + values2[i];
 
     return *out;
 }
 
+template <class T>
+void Add<T>::_forward_in_place(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& donor)
+{
+    assert(tensor1.shape == tensor2.shape);
+
+    const std::vector<T>& values1{ this->values(tensor1) };
+    const std::vector<T>& values2{ this->values(tensor2) };
+    std::vector<T>& out{ this->values(donor) };
+
+    for(int i = 0; i < static_cast<int>(out.size()); ++i)
+        out[i] = values1[i] + values2[i];
+}
+
 template <class T>
 std::vector<Tensor<T>> Add<T>::_backward(Tensor<T>& tensor1, Tensor<T>& tensor2)
 {
     Tensor<T> grad{ utils::self_derivative<T>(tensor1.shape, true) };
-    return { grad, grad };
+    Tensor<T> grad_copy{ grad };
+    return this->moved(grad, grad_copy);
+}
+
+template <class T>
+Tensor<T> Add<T>::_tangent(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, const Tensor<T>* tangent1, const Tensor<T>* tangent2)
+{
+    Tensor<T> out_tangent{ this->tangent_like(out, tangent1, tangent2) };
+    std::vector<T>& result{ this->values(out_tangent) };
+
+    for(const Tensor<T>* tangent : { tangent1, tangent2 })
+    {
+        if(!tangent)
+            continue;
+
+        const std::vector<T>& in{ this->values(*tangent) };
+        for(int i = 0; i < static_cast<int>(result.size()); ++i)
+            result[i] += in[i];
+    }
+
+    return out_tangent;
+}
+
+template <class T>
+std::vector<Tensor<T>*> Add<T>::_vjp(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, Tensor<T>& grad)
+{
+    return { &grad, &grad };
+}
+
+template <class T>
+bool Add<T>::in_place() const
+{
+    return true;
 }
 
 // Template initialization
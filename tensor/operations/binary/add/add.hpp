@@ -12,7 +12,13 @@ class Add : public Binary<T>
 {
 protected:
     Tensor<T>& _forward(Tensor<T>& tensor1, Tensor<T>& tensor2) override;
+    void _forward_in_place(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& donor) override;
     std::vector<Tensor<T>> _backward(Tensor<T>& tensor1, Tensor<T>& tensor2) override;
+    Tensor<T> _tangent(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, const Tensor<T>* tangent1, const Tensor<T>* tangent2) override;
+    std::vector<Tensor<T>*> _vjp(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, Tensor<T>& grad) override;
+
+public:
+    bool in_place() const override;
 };
 
 #endif
\ No newline at end of file
@@ -1,28 +1,59 @@
 #include "binary.hpp"
+#include "../../utils/no_grad.hpp"
 #include <cassert>
 #include <stdexcept>
 
 template <class T>
-Tensor<T>& Binary<T>::forward(Tensor<T>& tensor1, Tensor<T>& tensor2)
+Tensor<T>& Binary<T>::compute(Tensor<T>& tensor1, Tensor<T>& tensor2)
 {
+    TENSORGRAD_PROFILE_SCOPE(profile, Profiler::type_name(typeid(*this)), "forward");
+    TENSORGRAD_PROFILE_SET(profile, shape, Profiler::shape_str(tensor1.shape, tensor2.shape));
+
     Tensor<T>& out{ _forward(tensor1, tensor2) };
 
+    TENSORGRAD_PROFILE_SET(profile, elements, static_cast<long long>(this->values(out).size()));
+    TENSORGRAD_PROFILE_SET(profile, bytes, static_cast<long long>(this->values(out).size() * sizeof(T)));
+
+    if(tensor1.tangent || tensor2.tangent)
+        out.tangent = new Tensor<T>{ _tangent(tensor1, tensor2, out, tensor1.tangent, tensor2.tangent) };
+
+    return out;
+}
+
+template <class T>
+Tensor<T>& Binary<T>::forward(Tensor<T>& tensor1, Tensor<T>& tensor2)
+{
+    Tensor<T>& out{ compute(tensor1, tensor2) };
+
     this->cached_args = { &tensor1, &tensor2 };
     out.set_grad_info(this->cached_args, this);
     return out;
 }
 
 template <class T>
-std::vector<Tensor<T>> Binary<T>::backward(Tensor<T>& tensor1, Tensor<T>& tensor2)
+const std::vector<Tensor<T>>& Binary<T>::backward(Tensor<T>& tensor1, Tensor<T>& tensor2)
 {
     assert((&tensor1 == this->cached_args[0]) && (&tensor2 == this->cached_args[1]));
 
-    if(this->done_backward)
-        return this->cached_grads;
+    return this->jacobians({ &tensor1, &tensor2 }, [&]
+    {
+        TENSORGRAD_PROFILE_SCOPE(profile, Profiler::type_name(typeid(*this)), "backward");
+        TENSORGRAD_PROFILE_SET(profile, shape, Profiler::shape_str(tensor1.shape, tensor2.shape));
+
+        std::vector<Tensor<T>> grads{ _backward(tensor1, tensor2) };
 
-    this->cached_grads = { _backward(tensor1, tensor2) };
-    this->done_backward = true;
-    return this->cached_grads;
+        TENSORGRAD_PROFILE_SET(profile, elements, this->total_bytes(grads) / static_cast<long long>(sizeof(T)));
+        TENSORGRAD_PROFILE_SET(profile, bytes, this->total_bytes(grads));
+        TENSORGRAD_PROFILE_SET(profile, nnz, this->total_nnz(grads));
+
+        return grads;
+    });
+}
+
+template <class T>
+void Binary<T>::_forward_in_place(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& donor)
+{
+    throw std::runtime_error("Operation cannot be evaluated in place.");
 }
 
 template <class T>
@@ -37,6 +68,24 @@ std::vector<Tensor<T>> Binary<T>::_backward(Tensor<T>& tensor)
     throw std::runtime_error("Binary operation does not support unary arguments.");
 }
 
+template <class T>
+Tensor<T> Binary<T>::_tangent(Tensor<T>& tensor, Tensor<T>& out, const Tensor<T>& tangent)
+{
+    throw std::runtime_error("Binary operation does not support unary arguments.");
+}
+
+template <class T>
+std::vector<Tensor<T>*> Binary<T>::_vjp(Tensor<T>& tensor, Tensor<T>& out, Tensor<T>& grad)
+{
+    throw std::runtime_error("Binary operation does not support unary arguments.");
+}
+
+template <class T>
+std::vector<Tensor<T>*> Binary<T>::_vjp(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, Tensor<T>& grad)
+{
+    throw std::runtime_error("Operation has no differentiable backward, see 'has_vjp'.");
+}
+
 template <class T>
 Tensor<T>& Binary<T>::forward(Tensor<T>& tensor)
 {
@@ -44,7 +93,7 @@ Tensor<T>& Binary<T>::forward(Tensor<T>& tensor)
 }
 
 template <class T>
-std::vector<Tensor<T>> Binary<T>::backward(Tensor<T>& tensor)
+const std::vector<Tensor<T>>& Binary<T>::backward(Tensor<T>& tensor)
 {
     throw std::runtime_error("Binary operation does not support unary arguments.");
 }
@@ -57,12 +106,42 @@ Tensor<T>& Binary<T>::forward(std::vector<Tensor<T>*> args)
 }
 
 template <class T>
-std::vector<Tensor<T>> Binary<T>::backward(std::vector<Tensor<T>*>& args)
+Tensor<T>& Binary<T>::evaluate(std::vector<Tensor<T>*> args)
+{
+    assert(args.size() == 2);
+    this->check_not_donated(args);
+
+    Tensor<T>& tensor1{ *(args[0]) };
+    Tensor<T>& tensor2{ *(args[1]) };
+
+    if(this->in_place() && !tensor1.tangent && !tensor2.tangent)
+    {
+        Tensor<T>* donor{ this->donatable(tensor1) ? &tensor1 : (this->donatable(tensor2) ? &tensor2 : nullptr) };
+
+        if(donor)
+        {
+            _forward_in_place(tensor1, tensor2, *donor);
+            return NoGradGuard::adopt(&this->donate(*donor));
+        }
+    }
+
+    return NoGradGuard::adopt(&compute(tensor1, tensor2));
+}
+
+template <class T>
+const std::vector<Tensor<T>>& Binary<T>::backward(std::vector<Tensor<T>*>& args)
 {
     assert(args.size() == 2);
     return backward(*(args[0]), *(args[1]));
 }
 
+template <class T>
+std::vector<Tensor<T>*> Binary<T>::vjp(std::vector<Tensor<T>*>& args, Tensor<T>& out, Tensor<T>& grad)
+{
+    assert(args.size() == 2);
+    return _vjp(*(args[0]), *(args[1]), out, grad);
+}
+
 // Template declarations
 
 template class Binary<int>;
@@ -15,15 +15,32 @@ protected:
     virtual Tensor<T>& _forward(Tensor<T>& tensor1, Tensor<T>& tensor2) = 0;
     virtual std::vector<Tensor<T>> _backward(Tensor<T>& tensor1, Tensor<T>& tensor2) = 0;
 
+    Tensor<T> _tangent(Tensor<T>& tensor, Tensor<T>& out, const Tensor<T>& tangent) override;
+    virtual Tensor<T> _tangent(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, const Tensor<T>* tangent1, const Tensor<T>* tangent2) = 0;
+
+    std::vector<Tensor<T>*> _vjp(Tensor<T>& tensor, Tensor<T>& out, Tensor<T>& grad) override;
+    std::vector<Tensor<T>*> _vjp(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, Tensor<T>& grad) override;
+
+    /*
+    Overwrites the values of 'donor' (one of the arguments) with 
+    the result, for operations that are 'in_place'.
+    */
+
+    virtual void _forward_in_place(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& donor);
+
+    Tensor<T>& compute(Tensor<T>& tensor1, Tensor<T>& tensor2);
+
 public:
     Tensor<T>& forward(Tensor<T>& tensor) override;
-    std::vector<Tensor<T>> backward(Tensor<T>& tensor) override;
+    const std::vector<Tensor<T>>& backward(Tensor<T>& tensor) override;
 
     Tensor<T>& forward(Tensor<T>& tensor1, Tensor<T>& tensor2) override;
-    std::vector<Tensor<T>> backward(Tensor<T>& tensor1, Tensor<T>& tensor2) override;
+    const std::vector<Tensor<T>>& backward(Tensor<T>& tensor1, Tensor<T>& tensor2) override;
 
     Tensor<T>& forward(std::vector<Tensor<T>*> args) override;
-    std::vector<Tensor<T>> backward(std::vector<Tensor<T>*>& args) override;
+    const std::vector<Tensor<T>>& backward(std::vector<Tensor<T>*>& args) override;
+    std::vector<Tensor<T>*> vjp(std::vector<Tensor<T>*>& args, Tensor<T>& out, Tensor<T>& grad) override;
+    Tensor<T>& evaluate(std::vector<Tensor<T>*> args) override;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,389 @@
+#include "conv.hpp"
+#include "../../../utils/utils.hpp"
+#include "../../../tensor.hpp"
+#include <vector>
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+
+template <class T>
+Conv<T>::Conv(const int spatial_dims, const std::vector<int>& stride, const std::vector<int>& padding, const std::vector<int>& dilation)
+    : spatial_dims{ spatial_dims }
+    , stride{ stride }
+    , padding{ padding }
+    , dilation{ dilation }
+{
+    assert((spatial_dims == 1) || (spatial_dims == 2));
+    assert((stride.size() == spatial_dims) && (padding.size() == spatial_dims) && (dilation.size() == spatial_dims));
+}
+
+template <class T>
+Conv1d<T>::Conv1d(const int stride, const int padding, const int dilation)
+    : Conv<T>(1, { stride }, { padding }, { dilation })
+{}
+
+template <class T>
+Conv2d<T>::Conv2d(const std::vector<int>& stride, const std::vector<int>& padding, const std::vector<int>& dilation)
+    : Conv<T>(2, stride, padding, dilation)
+{}
+
+template <class T>
+typename Conv<T>::Geometry Conv<T>::geometry(const Tensor<T>& input, const Tensor<T>& weight) const
+{
+    assert((input.dim == spatial_dims + 2) && (weight.dim == spatial_dims + 2));
+    assert(input.shape[1] == weight.shape[1]);
+
+    Geometry geo{};
+    geo.batch = input.shape[0];
+    geo.in_channels = input.shape[1];
+    geo.out_channels = weight.shape[0];
+
+    const bool is_2d{ spatial_dims == 2 };
+
+    geo.in_h = is_2d ? input.shape[2] : 1;
+    geo.in_w = input.shape[spatial_dims + 1];
+    geo.kernel_h = is_2d ? weight.shape[2] : 1;
+    geo.kernel_w = weight.shape[spatial_dims + 1];
+
+    geo.stride_h = is_2d ? stride[0] : 1;
+    geo.stride_w = stride[spatial_dims - 1];
+    geo.pad_h = is_2d ? padding[0] : 0;
+    geo.pad_w = padding[spatial_dims - 1];
+    geo.dil_h = is_2d ? dilation[0] : 1;
+    geo.dil_w = dilation[spatial_dims - 1];
+
+    geo.out_h = (geo.in_h + 2*geo.pad_h - geo.dil_h*(geo.kernel_h - 1) - 1) / geo.stride_h + 1;
+    geo.out_w = (geo.in_w + 2*geo.pad_w - geo.dil_w*(geo.kernel_w - 1) - 1) / geo.stride_w + 1;
+
+    assert((geo.out_h > 0) && (geo.out_w > 0) && "Convolution output would be empty.");
+    return geo;
+}
+
+template <class T>
+utils::Shape Conv<T>::out_shape(const Geometry& geo) const
+{
+    if(spatial_dims == 2)
+        return { geo.batch, geo.out_channels, geo.out_h, geo.out_w };
+
+    return { geo.batch, geo.out_channels, geo.out_w };
+}
+
+template <class T>
+void Conv<T>::direct_forward(const Geometry& geo, const T* input, const T* weight, T* out) const
+{
+    /*
+    Direct convolution, each output channel computed
+    independently on its own thread. Results are added
+    into 'out'.
+    */
+
+    utils::parallel_for(0, geo.out_channels, [&geo, input, weight, out](int oc_begin, int oc_end)
+    {
+        for(int oc = oc_begin; oc < oc_end; ++oc)
+        for(int n = 0; n < geo.batch; ++n)
+        for(int oh = 0; oh < geo.out_h; ++oh)
+        for(int ow = 0; ow < geo.out_w; ++ow)
+        {
+            T acc{ 0 };
+
+            for(int ic = 0; ic < geo.in_channels; ++ic)
+            for(int kh = 0; kh < geo.kernel_h; ++kh)
+            {
+                const int ih{ oh*geo.stride_h - geo.pad_h + kh*geo.dil_h };
+                if((ih < 0) || (ih >= geo.in_h))
+                    continue;
+
+                const T* in_row{ input + ((n*geo.in_channels + ic)*geo.in_h + ih)*geo.in_w };
+                const T* w_row{ weight + ((oc*geo.in_channels + ic)*geo.kernel_h + kh)*geo.kernel_w };
+
+                for(int kw = 0; kw < geo.kernel_w; ++kw)
+                {
+                    const int iw{ ow*geo.stride_w - geo.pad_w + kw*geo.dil_w };
+                    if((iw >= 0) && (iw < geo.in_w))
+                        acc += in_row[iw] * w_row[kw];
+                }
+            }
+
+            out[((n*geo.out_channels + oc)*geo.out_h + oh)*geo.out_w + ow] += acc;
+        }
+    });
+}
+
+template <class T>
+void Conv<T>::im2col_forward(const Geometry& geo, const T* input, const T* weight, T* out) const
+{
+    /*
+    Unrolls each batch element into a column matrix of shape
+    (in_channels * kernel_h * kernel_w, out_h * out_w), then
+    computes out[n] += weight * columns with the output channels
+    (GEMM rows) split across threads.
+    */
+
+    const int rows{ geo.in_channels * geo.kernel_h * geo.kernel_w };
+    const int cols{ geo.out_h * geo.out_w };
+    std::vector<T> columns(rows * cols);
+
+    for(int n = 0; n < geo.batch; ++n)
+    {
+        for(int ic = 0; ic < geo.in_channels; ++ic)
+        for(int kh = 0; kh < geo.kernel_h; ++kh)
+        for(int kw = 0; kw < geo.kernel_w; ++kw)
+        {
+            const int row{ (ic*geo.kernel_h + kh)*geo.kernel_w + kw };
+            T* col_row{ columns.data() + row*cols };
+
+            for(int oh = 0; oh < geo.out_h; ++oh)
+            {
+                const int ih{ oh*geo.stride_h - geo.pad_h + kh*geo.dil_h };
+                const bool row_valid{ (ih >= 0) && (ih < geo.in_h) };
+                const T* in_row{ row_valid ? input + ((n*geo.in_channels + ic)*geo.in_h + ih)*geo.in_w : nullptr };
+
+                for(int ow = 0; ow < geo.out_w; ++ow)
+                {
+                    const int iw{ ow*geo.stride_w - geo.pad_w + kw*geo.dil_w };
+                    const bool valid{ row_valid && (iw >= 0) && (iw < geo.in_w) };
+                    col_row[oh*geo.out_w + ow] = valid ? in_row[iw] : static_cast<T>(0);
+                }
+            }
+        }
+
+        const T* col_data{ columns.data() };
+        T* out_batch{ out + n*geo.out_channels*cols };
+
+        utils::parallel_for(0, geo.out_channels, [rows, cols, weight, col_data, out_batch](int oc_begin, int oc_end)
+        {
+            for(int oc = oc_begin; oc < oc_end; ++oc)
+            {
+                T* out_row{ out_batch + oc*cols };
+                const T* w_row{ weight + oc*rows };
+
+                for(int r = 0; r < rows; ++r)
+                {
+                    const T w_value{ w_row[r] };
+                    const T* col_row{ col_data + r*cols };
+
+                    for(int c = 0; c < cols; ++c)
+                        out_row[c] += w_value * col_row[c];
+                }
+            }
+        });
+    }
+}
+
+template <class T>
+Tensor<T>& Conv<T>::_forward(Tensor<T>& input, Tensor<T>& weight)
+{
+    const Geometry geo{ geometry(input, weight) };
+
+    Tensor<T>* out = new Tensor<T>{ out_shape(geo), 0 };
+
+    if(geo.in_channels * geo.kernel_h * geo.kernel_w <= direct_threshold)
+        direct_forward(geo, input.data.data(), weight.data.data(), out->data.data());
+    else
+        im2col_forward(geo, input.data.data(), weight.data.data(), out->data.data());
+
+    return *out;
+}
+
+template <class T>
+std::vector<Tensor<T>> Conv<T>::_backward(Tensor<T>& input, Tensor<T>& weight)
+{
+    throw std::runtime_error("Conv has no dense Jacobians, use 'sparse_backward'.");
+}
+
+template <class T>
+std::vector<typename Operation<T>::SparseRows> Conv<T>::sparse_backward(std::vector<Tensor<T>*>& args)
+{
+    /*
+    Only the structurally non-zero entries are formed:
+    d out[n, oc, oh, ow] / d input[n, ic, ih, iw] = weight[oc, ic, kh, kw]
+    d out[n, oc, oh, ow] / d weight[oc, ic, kh, kw] = input[n, ic, ih, iw]
+    for every tap (kh, kw) that lands inside the input, so each 
+    Jacobian holds as many entries as the forward pass has 
+    multiplications. Each row (output element) is hit by every 
+    input channel and in-bounds tap once, in increasing column 
+    order, so its length is known before it is filled.
+    */
+
+    assert(args.size() == 2);
+
+    const Tensor<T>& input{ *(args[0]) };
+    const Tensor<T>& weight{ *(args[1]) };
+
+    TENSORGRAD_PROFILE_SCOPE(profile, Profiler::type_name(typeid(*this)), "backward");
+    TENSORGRAD_PROFILE_SET(profile, shape, Profiler::shape_str(input.shape, weight.shape));
+
+    const Geometry geo{ geometry(input, weight) };
+    const int out_size{ geo.batch * geo.out_channels * geo.out_h * geo.out_w };
+
+    const auto valid_taps = [](const int out_pos, const int stride, const int pad, const int dil, const int kernel, const int in_size)
+    {
+        int count{ 0 };
+
+        for(int k = 0; k < kernel; ++k)
+        {
+            const int pos{ out_pos*stride - pad + k*dil };
+            count += (pos >= 0) && (pos < in_size);
+        }
+
+        return count;
+    };
+
+    typename Operation<T>::SparseRows grad_input{};
+    grad_input.offsets.assign(out_size + 1, 0);
+
+    for(int row = 0; row < out_size; ++row)
+    {
+        const int ow{ row % geo.out_w };
+        const int oh{ (row / geo.out_w) % geo.out_h };
+        const int taps{ valid_taps(oh, geo.stride_h, geo.pad_h, geo.dil_h, geo.kernel_h, geo.in_h) * valid_taps(ow, geo.stride_w, geo.pad_w, geo.dil_w, geo.kernel_w, geo.in_w) };
+
+        grad_input.offsets[row + 1] = grad_input.offsets[row] + geo.in_channels * taps;
+    }
+
+    const int nnz{ grad_input.offsets[out_size] };
+
+    grad_input.cols.resize(nnz);
+    grad_input.values.resize(nnz);
+
+    typename Operation<T>::SparseRows grad_weight{ grad_input.offsets, std::vector<int>(nnz), std::vector<T>(nnz) };
+
+    utils::parallel_for(0, out_size, [&](int row_begin, int row_end)
+    {
+        for(int row = row_begin; row < row_end; ++row)
+        {
+            const int ow{ row % geo.out_w };
+            const int oh{ (row / geo.out_w) % geo.out_h };
+            const int oc{ (row / (geo.out_w * geo.out_h)) % geo.out_channels };
+            const int n{ row / (geo.out_w * geo.out_h * geo.out_channels) };
+
+            int entry{ grad_input.offsets[row] };
+
+            for(int ic = 0; ic < geo.in_channels; ++ic)
+            for(int kh = 0; kh < geo.kernel_h; ++kh)
+            {
+                const int ih{ oh*geo.stride_h - geo.pad_h + kh*geo.dil_h };
+                if((ih < 0) || (ih >= geo.in_h))
+                    continue;
+
+                for(int kw = 0; kw < geo.kernel_w; ++kw)
+                {
+                    const int iw{ ow*geo.stride_w - geo.pad_w + kw*geo.dil_w };
+                    if((iw < 0) || (iw >= geo.in_w))
+                        continue;
+
+                    const int in_flat{ ((n*geo.in_channels + ic)*geo.in_h + ih)*geo.in_w + iw };
+                    const int w_flat{ ((oc*geo.in_channels + ic)*geo.kernel_h + kh)*geo.kernel_w + kw };
+
+                    grad_input.cols[entry] = in_flat;
+                    grad_input.values[entry] = weight.data[w_flat];
+                    grad_weight.cols[entry] = w_flat;
+                    grad_weight.values[entry] = input.data[in_flat];
+                    ++entry;
+                }
+            }
+        }
+    }
+    , 64);
+
+    TENSORGRAD_PROFILE_SET(profile, nnz, 2LL * nnz);
+
+    std::vector<typename Operation<T>::SparseRows> grads{};
+    grads.push_back(std::move(grad_input));
+    grads.push_back(std::move(grad_weight));
+    return grads;
+}
+
+template <class T>
+bool Conv<T>::has_jacobians() const
+{
+    return false;
+}
+
+template <class T>
+bool Conv<T>::has_vjp() const
+{
+    return false;
+}
+
+
+template <class T>
+Tensor<T> Conv<T>::_tangent(Tensor<T>& input, Tensor<T>& weight, Tensor<T>& out, const Tensor<T>* input_tangent, const Tensor<T>* weight_tangent)
+{
+    /*
+    d conv(X, W) = conv(dX, W) + conv(X, dW). The input tangents 
+    are stacked along the batch dimension and convolved in a 
+    single call, the weight tangents one at a time.
+    */
+
+    const Geometry geo{ geometry(input, weight) };
+
+    Tensor<T> out_tangent{ this->tangent_like(out, input_tangent, weight_tangent) };
+    const int num_tangents{ out_tangent.shape[0] };
+    T* result{ out_tangent.data.data() };
+
+    const bool use_direct{ geo.in_channels * geo.kernel_h * geo.kernel_w <= direct_threshold };
+    const auto convolve = [this, use_direct](const Geometry& geo, const T* in, const T* w, T* out_data)
+    {
+        if(use_direct)
+            direct_forward(geo, in, w, out_data);
+        else
+            im2col_forward(geo, in, w, out_data);
+    };
+
+    if(input_tangent)
+    {
+        Geometry stacked{ geo };
+        stacked.batch *= num_tangents;
+        convolve(stacked, input_tangent->data.data(), weight.data.data(), result);
+    }
+
+    if(weight_tangent)
+    {
+        const int out_size{ static_cast<int>(out.data.size()) };
+        const int weight_size{ static_cast<int>(weight.data.size()) };
+
+        for(int k = 0; k < num_tangents; ++k)
+            convolve(geo, input.data.data(), weight_tangent->data.data() + k*weight_size, result + k*out_size);
+    }
+
+    return out_tangent;
+}
+
+template <class T>
+bool Conv<T>::equivalent(const Operation<T>& other) const
+{
+    if(!Operation<T>::equivalent(other))
+        return false;
+
+    const Conv<T>& conv{ static_cast<const Conv<T>&>(other) };
+    return (conv.spatial_dims == spatial_dims) && (conv.stride == stride) && (conv.padding == padding) && (conv.dilation == dilation);
+}
+
+template <class T>
+long long Conv<T>::flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const
+{
+    /*
+    A multiply and an add per tap of every output value.
+    */
+
+    const Tensor<T>& weight{ *args[1] };
+    return 2LL * utils::prod(out.shape) * (utils::prod(weight.shape) / weight.shape[0]);
+}
+
+// Template declarations
+
+template class Conv<int>;
+template class Conv<double>;
+template class Conv<long>;
+template class Conv<long long>;
+
+template class Conv1d<int>;
+template class Conv1d<double>;
+template class Conv1d<long>;
+template class Conv1d<long long>;
+
+template class Conv2d<int>;
+template class Conv2d<double>;
+template class Conv2d<long>;
+template class Conv2d<long long>;
\ No newline at end of file
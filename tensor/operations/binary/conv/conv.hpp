@@ -0,0 +1,79 @@
+#ifndef CONV_HPP
+#define CONV_HPP
+
+template <class T>
+class Binary;
+
+#include "../binary.hpp"
+#include "../../../tensor.hpp"
+#include <vector>
+
+template <class T>
+class Conv : public Binary<T>
+{
+protected:
+    /*
+    Convolution (cross-correlation) of an input of shape
+    (batch, in_channels, *spatial) with a weight of shape
+    (out_channels, in_channels, *kernel), where 'spatial' and
+    'kernel' have 'spatial_dims' entries (1 or 2).
+
+    A 1d convolution is treated as a 2d convolution of height 1.
+    */
+
+    struct Geometry
+    {
+        int batch, in_channels, out_channels;
+        int in_h, in_w, kernel_h, kernel_w, out_h, out_w;
+        int stride_h, stride_w, pad_h, pad_w, dil_h, dil_w;
+    };
+
+    /*
+    Filters with at most this many taps per output value
+    (in_channels * kernel_h * kernel_w) use the direct kernel,
+    larger ones go through im2col + GEMM.
+    */
+
+    static constexpr int direct_threshold{ 16 };
+
+    const int spatial_dims;
+    const std::vector<int> stride;
+    const std::vector<int> padding;
+    const std::vector<int> dilation;
+
+    Geometry geometry(const Tensor<T>& input, const Tensor<T>& weight) const;
+    utils::Shape out_shape(const Geometry& geo) const;
+
+    void direct_forward(const Geometry& geo, const T* input, const T* weight, T* out) const;
+    void im2col_forward(const Geometry& geo, const T* input, const T* weight, T* out) const;
+
+    Tensor<T>& _forward(Tensor<T>& input, Tensor<T>& weight) override;
+    std::vector<Tensor<T>> _backward(Tensor<T>& input, Tensor<T>& weight) override;
+    Tensor<T> _tangent(Tensor<T>& input, Tensor<T>& weight, Tensor<T>& out, const Tensor<T>* input_tangent, const Tensor<T>* weight_tangent) override;
+
+public:
+    Conv(const int spatial_dims, const std::vector<int>& stride, const std::vector<int>& padding, const std::vector<int>& dilation);
+
+    std::vector<typename Operation<T>::SparseRows> sparse_backward(std::vector<Tensor<T>*>& args) override;
+
+    bool has_jacobians() const override;
+    bool has_vjp() const override;
+    bool equivalent(const Operation<T>& other) const override;
+    long long flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const override;
+};
+
+template <class T>
+class Conv1d : public Conv<T>
+{
+public:
+    Conv1d(const int stride = 1, const int padding = 0, const int dilation = 1);
+};
+
+template <class T>
+class Conv2d : public Conv<T>
+{
+public:
+    Conv2d(const std::vector<int>& stride = { 1, 1 }, const std::vector<int>& padding = { 0, 0 }, const std::vector<int>& dilation = { 1, 1 });
+};
+
+#endif
\ No newline at end of file
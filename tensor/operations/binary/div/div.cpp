@@ -0,0 +1,117 @@
+#include "div.hpp"
+#include "../../../utils/utils.hpp"
+#include "../../../tensor.hpp"
+#include <cassert>
+#include <vector>
+#include <utility>
+
+template <class T>
+Tensor<T>& Div<T>::_forward(Tensor<T>& tensor1, Tensor<T>& tensor2)
+{
+    assert(tensor1.shape == tensor2.shape);
+
+    Tensor<T>* out = new Tensor<T>{ tensor1.shape, 0 };
+
+    const std::vector<T>& values1{ this->values(tensor1) };
+    const std::vector<T>& values2{ this->values(tensor2) };
+    std::vector<T>& result{ this->values(*out) };
+
+    for(int i = 0; i < static_cast<int>(result.size()); ++i)
+        result[i] = values1[i] / values2[i];
+
+    return *out;
+}
+
+template <class T>
+void Div<T>::_forward_in_place(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& donor)
+{
+    assert(tensor1.shape == tensor2.shape);
+
+    const std::vector<T>& values1{ this->values(tensor1) };
+    const std::vector<T>& values2{ this->values(tensor2) };
+    std::vector<T>& out{ this->values(donor) };
+
+    for(int i = 0; i < static_cast<int>(out.size()); ++i)
+        out[i] = values1[i] / values2[i];
+}
+
+template <class T>
+std::vector<Tensor<T>> Div<T>::_backward(Tensor<T>& tensor1, Tensor<T>& tensor2)
+{
+    /*
+    d(X / Y)/dX = 1 / Y and d(X / Y)/dY = -X / Y^2, elementwise.
+    */
+
+    utils::Shape grad_shape{ utils::concat_shapes(tensor1.shape, tensor1.shape) };
+    Tensor<T> grad1{ grad_shape, 0 };
+
+    grad1.modify([&tensor2 = std::as_const(tensor2)](Tensor<T>& tensor, const utils::Shape index)
+    {
+        utils::Shape total_index{ utils::concat_shapes(index, index) };
+        tensor(total_index) = 1 / tensor2(index);
+        tensor.non_zero_idxs.push_back(total_index);
+    }
+    , tensor1.shape);
+
+    Tensor<T> grad2{ grad_shape, 0 };
+
+    grad2.modify([&tensor1 = std::as_const(tensor1), &tensor2 = std::as_const(tensor2)](Tensor<T>& tensor, const utils::Shape index)
+    {
+        utils::Shape total_index{ utils::concat_shapes(index, index) };
+        tensor(total_index) = -tensor1(index) / (tensor2(index) * tensor2(index));
+        tensor.non_zero_idxs.push_back(total_index);
+    }
+    , tensor1.shape);
+
+    return this->moved(grad1, grad2);
+}
+
+template <class T>
+Tensor<T> Div<T>::_tangent(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, const Tensor<T>* tangent1, const Tensor<T>* tangent2)
+{
+    /*
+    d(X / Y) = (dX - (X / Y) * dY) / Y
+    */
+
+    Tensor<T> out_tangent{ this->tangent_like(out, tangent1, tangent2) };
+    std::vector<T>& result{ this->values(out_tangent) };
+    const std::vector<T>& quotient{ this->values(out) };
+    const std::vector<T>& divisor{ this->values(tensor2) };
+    const int size{ static_cast<int>(quotient.size()) };
+
+    if(tangent1)
+    {
+        const std::vector<T>& in{ this->values(*tangent1) };
+        for(int i = 0; i < static_cast<int>(result.size()); ++i)
+            result[i] += in[i] / divisor[i % size];
+    }
+
+    if(tangent2)
+    {
+        const std::vector<T>& in{ this->values(*tangent2) };
+        for(int i = 0; i < static_cast<int>(result.size()); ++i)
+            result[i] -= in[i] * quotient[i % size] / divisor[i % size];
+    }
+
+    return out_tangent;
+}
+
+template <class T>
+std::vector<Tensor<T>*> Div<T>::_vjp(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, Tensor<T>& grad)
+{
+    Tensor<T>& grad1{ grad / this->operand(tensor2) };
+    return { &grad1, &(-(grad1 * out)) };
+}
+
+template <class T>
+bool Div<T>::in_place() const
+{
+    return true;
+}
+
+// Template declarations
+
+template class Div<int>;
+template class Div<double>;
+template class Div<long>;
+template class Div<long long>;
\ No newline at end of file
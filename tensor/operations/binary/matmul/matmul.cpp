@@ -1,6 +1,7 @@
 #include "matmul.hpp"
 #include "../../../tensor.hpp"
 #include <vector>
+#include <utility>
 #include <cassert>
 
 template <class T>
@@ -14,12 +15,19 @@ Tensor<T>& MatMul<T>::_forward(Tensor<T>& tensor1, Tensor<T>& tensor2)
     assert(cols1 == rows2);
 
     Tensor<T>* out = new Tensor<T>{ { rows1, cols2 }, 0 };
-    
-    out->modify([&tensor1, &tensor2](Tensor<T>& tensor, const std::vector<int>& index)
-    {
-        tensor(index[0], index[2]) += tensor1(index[0], index[1]) * tensor2(index[1], index[2]);
-    }
-    , { rows1, cols1, cols2 });
+
+    const std::vector<T>& values1{ this->values(tensor1) };
+    const std::vector<T>& values2{ this->values(tensor2) };
+    std::vector<T>& result{ this->values(*out) };
+
+    for(int i = 0; i < rows1; ++i)
+        for(int k = 0; k < cols1; ++k)
+        {
+            const T value{ values1[i*cols1 + k] };
+
+            for(int j = 0; j < cols2; ++j)
+                result[i*cols2 + j] += value * values2[k*cols2 + j];
+        }
 
     return *out;
 }
@@ -32,9 +40,9 @@ std::vector<Tensor<T>> MatMul<T>::_backward(Tensor<T>& tensor1, Tensor<T>& tenso
 
     Tensor<T> grad1{ { rows1, cols2, rows1, cols1 }, 0 };
 
-    grad1.modify([&tensor2](Tensor<T>& tensor, const std::vector<int>& index)
+    grad1.modify([&tensor2 = std::as_const(tensor2)](Tensor<T>& tensor, const utils::Shape& index)
     {
-        std::vector<int> total_index{ index[0], index[1], index[0], index[2] };
+        utils::Shape total_index{ index[0], index[1], index[0], index[2] };
         tensor(total_index) = tensor2(index[2], index[1]);
         tensor.non_zero_idxs.push_back(total_index);
     }
@@ -42,17 +50,72 @@ std::vector<Tensor<T>> MatMul<T>::_backward(Tensor<T>& tensor1, Tensor<T>& tenso
 
     Tensor<T> grad2{ { rows1, cols2, rows2, cols2 }, 0 };
 
-    grad2.modify([&tensor1](Tensor<T>& tensor, const std::vector<int>& index)
+    grad2.modify([&tensor1 = std::as_const(tensor1)](Tensor<T>& tensor, const utils::Shape& index)
     {
-        std::vector<int> total_index{ index[0], index[1], index[2], index[1] };
+        utils::Shape total_index{ index[0], index[1], index[2], index[1] };
         tensor(total_index) = tensor1(index[0], index[2]);
         tensor.non_zero_idxs.push_back(total_index);
     }
     , { rows1, cols2, rows2 });
 
-    return { grad1, grad2 };
+    return this->moved(grad1, grad2);
+}
+
+
+template <class T>
+Tensor<T> MatMul<T>::_tangent(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, const Tensor<T>* tangent1, const Tensor<T>* tangent2)
+{
+    /*
+    d(X Y) = dX Y + X dY, for each tangent.
+    */
+
+    const int rows1{ tensor1.shape[0] }, cols1{ tensor1.shape[1] }, cols2{ tensor2.shape[1] };
+
+    Tensor<T> out_tangent{ this->tangent_like(out, tangent1, tangent2) };
+    T* result{ this->values(out_tangent).data() };
+    const T* x{ this->values(tensor1).data() };
+    const T* y{ this->values(tensor2).data() };
+
+    for(int k = 0; k < out_tangent.shape[0]; ++k)
+    {
+        const T* dx{ tangent1 ? this->values(*tangent1).data() + k*rows1*cols1 : nullptr };
+        const T* dy{ tangent2 ? this->values(*tangent2).data() + k*cols1*cols2 : nullptr };
+        T* d_out{ result + k*rows1*cols2 };
+
+        for(int i = 0; i < rows1; ++i)
+        for(int j = 0; j < cols1; ++j)
+        {
+            const T dx_ij{ dx ? dx[i*cols1 + j] : static_cast<T>(0) };
+            const T x_ij{ x[i*cols1 + j] };
+
+            for(int l = 0; l < cols2; ++l)
+            {
+                if(dx)
+                    d_out[i*cols2 + l] += dx_ij * y[j*cols2 + l];
+                if(dy)
+                    d_out[i*cols2 + l] += x_ij * dy[j*cols2 + l];
+            }
+        }
+    }
+
+    return out_tangent;
 }
 
+template <class T>
+std::vector<Tensor<T>*> MatMul<T>::_vjp(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, Tensor<T>& grad)
+{
+    /*
+    d/dX = G Y^T, d/dY = X^T G
+    */
+
+    return { &grad.matmul(this->operand(tensor2).transpose()), &this->operand(tensor1).transpose().matmul(grad) };
+}
+
+template <class T>
+long long MatMul<T>::flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const
+{
+    return 2LL * args[0]->shape[0] * args[0]->shape[1] * args[1]->shape[1];
+}
 
 // Template declarations
 
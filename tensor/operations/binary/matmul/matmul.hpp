@@ -10,6 +10,11 @@ class MatMul : public Binary<T>
 protected:
     Tensor<T>& _forward(Tensor<T>& tensor1, Tensor<T>& tensor2) override;
     std::vector<Tensor<T>> _backward(Tensor<T>& tensor1, Tensor<T>& tensor2) override;
+    Tensor<T> _tangent(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, const Tensor<T>* tangent1, const Tensor<T>* tangent2) override;
+    std::vector<Tensor<T>*> _vjp(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, Tensor<T>& grad) override;
+
+public:
+    long long flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const override;
 };
 
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "../../../tensor.hpp"
 #include <vector>
 #include <cassert>
+#include <utility>
 
 template <class T>
 Tensor<T>& Mul<T>::_forward(Tensor<T>& tensor1, Tensor<T>& tensor2)
@@ -10,24 +11,38 @@ Tensor<T>& Mul<T>::_forward(Tensor<T>& tensor1, Tensor<T>& tensor2)
 
     Tensor<T>* out = new Tensor<T>{ tensor1.shape, 0 };
 
-    out->modify([&tensor1, &tensor2](Tensor<T>& tensor, const std::vector<int>& index)
-    {
-        tensor(index) = tensor1(index) * tensor2(index);
-    }
-    , out->shape);
-    
+    const std::vector<T>& values1{ this->values(tensor1) };
+    const std::vector<T>& values2{ this->values(tensor2) };
+    std::vector<T>& result{ this->values(*out) };
+
+    for(int i = 0; i < static_cast<int>(result.size()); ++i)
+        result[i] = values1[i] * values2[i];
+
     return *out;
 }
 
+template <class T>
+void Mul<T>::_forward_in_place(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& donor)
+{
+    assert(tensor1.shape == tensor2.shape);
+
+    const std::vector<T>& values1{ this->values(tensor1) };
+    const std::vector<T>& values2{ this->values(tensor2) };
+    std::vector<T>& out{ this->values(donor) };
+
+    for(int i = 0; i < static_cast<int>(out.size()); ++i)
+        out[i] = values1[i] * values2[i];
+}
+
 template <class T>
 std::vector<Tensor<T>> Mul<T>::_backward(Tensor<T>& tensor1, Tensor<T>& tensor2)
 {
-    std::vector<int> grad_shape{ utils::concat_shapes(tensor1.shape, tensor1.shape) };
+    utils::Shape grad_shape{ utils::concat_shapes(tensor1.shape, tensor1.shape) };
     Tensor<T> grad1{ grad_shape, 0 };
 
-    grad1.modify([&tensor2](Tensor<T>& tensor, const std::vector<int> index)
+    grad1.modify([&tensor2 = std::as_const(tensor2)](Tensor<T>& tensor, const utils::Shape index)
     {
-        std::vector<int> total_index{ utils::concat_shapes(index, index) };
+        utils::Shape total_index{ utils::concat_shapes(index, index) };
         tensor(total_index) = tensor2(index);
         tensor.non_zero_idxs.push_back(total_index);
     }
@@ -35,18 +50,58 @@ std::vector<Tensor<T>> Mul<T>::_backward(Tensor<T>& tensor1, Tensor<T>& tensor2)
 
     Tensor<T> grad2{ grad_shape, 0 };
 
-    grad2.modify([&tensor1](Tensor<T>& tensor, const std::vector<int> index)
+    grad2.modify([&tensor1 = std::as_const(tensor1)](Tensor<T>& tensor, const utils::Shape index)
     {
-        std::vector<int> total_index{ utils::concat_shapes(index, index) };
+        utils::Shape total_index{ utils::concat_shapes(index, index) };
         tensor(total_index) = tensor1(index);
         tensor.non_zero_idxs.push_back(total_index);
     }
     , tensor1.shape);
 
-    return { grad1, grad2 };
+    return this->moved(grad1, grad2);
 }
 
 
+template <class T>
+Tensor<T> Mul<T>::_tangent(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, const Tensor<T>* tangent1, const Tensor<T>* tangent2)
+{
+    /*
+    d(X * Y) = dX * Y + X * dY
+    */
+
+    Tensor<T> out_tangent{ this->tangent_like(out, tangent1, tangent2) };
+    std::vector<T>& result{ this->values(out_tangent) };
+    const int size{ static_cast<int>(this->values(out).size()) };
+
+    const std::pair<const Tensor<T>*, const Tensor<T>*> terms[]{ { tangent1, &tensor2 }, { tangent2, &tensor1 } };
+
+    for(const auto& [tangent, other] : terms)
+    {
+        if(!tangent)
+            continue;
+
+        const std::vector<T>& in{ this->values(*tangent) };
+        const std::vector<T>& scale{ this->values(*other) };
+
+        for(int i = 0; i < static_cast<int>(result.size()); ++i)
+            result[i] += in[i] * scale[i % size];
+    }
+
+    return out_tangent;
+}
+
+template <class T>
+std::vector<Tensor<T>*> Mul<T>::_vjp(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, Tensor<T>& grad)
+{
+    return { &(grad * this->operand(tensor2)), &(grad * this->operand(tensor1)) };
+}
+
+template <class T>
+bool Mul<T>::in_place() const
+{
+    return true;
+}
+
 // Template declarations
 
 template class Mul<int>;
@@ -0,0 +1,88 @@
+#include "sub.hpp"
+#include "../../../utils/utils.hpp"
+#include "../../../tensor.hpp"
+#include <cassert>
+#include <vector>
+#include <utility>
+
+template <class T>
+Tensor<T>& Sub<T>::_forward(Tensor<T>& tensor1, Tensor<T>& tensor2)
+{
+    assert(tensor1.shape == tensor2.shape);
+
+    Tensor<T>* out = new Tensor<T>{ tensor1.shape, 0 };
+
+    const std::vector<T>& values1{ this->values(tensor1) };
+    const std::vector<T>& values2{ this->values(tensor2) };
+    std::vector<T>& result{ this->values(*out) };
+
+    for(int i = 0; i < static_cast<int>(result.size()); ++i)
+        result[i] = values1[i] - values2[i];
+
+    return *out;
+}
+
+template <class T>
+void Sub<T>::_forward_in_place(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& donor)
+{
+    assert(tensor1.shape == tensor2.shape);
+
+    const std::vector<T>& values1{ this->values(tensor1) };
+    const std::vector<T>& values2{ this->values(tensor2) };
+    std::vector<T>& out{ this->values(donor) };
+
+    for(int i = 0; i < static_cast<int>(out.size()); ++i)
+        out[i] = values1[i] - values2[i];
+}
+
+template <class T>
+std::vector<Tensor<T>> Sub<T>::_backward(Tensor<T>& tensor1, Tensor<T>& tensor2)
+{
+    Tensor<T> grad1{ utils::self_derivative<T>(tensor1.shape, true) };
+    Tensor<T> grad2{ grad1 };
+
+    for(T& value : this->values(grad2))
+        value = -value;
+
+    return this->moved(grad1, grad2);
+}
+
+template <class T>
+Tensor<T> Sub<T>::_tangent(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, const Tensor<T>* tangent1, const Tensor<T>* tangent2)
+{
+    Tensor<T> out_tangent{ this->tangent_like(out, tangent1, tangent2) };
+    std::vector<T>& result{ this->values(out_tangent) };
+
+    const std::pair<const Tensor<T>*, T> terms[]{ { tangent1, 1 }, { tangent2, -1 } };
+
+    for(const auto& [tangent, sign] : terms)
+    {
+        if(!tangent)
+            continue;
+
+        const std::vector<T>& in{ this->values(*tangent) };
+        for(int i = 0; i < static_cast<int>(result.size()); ++i)
+            result[i] += sign * in[i];
+    }
+
+    return out_tangent;
+}
+
+template <class T>
+std::vector<Tensor<T>*> Sub<T>::_vjp(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, Tensor<T>& grad)
+{
+    return { &grad, &(-grad) };
+}
+
+template <class T>
+bool Sub<T>::in_place() const
+{
+    return true;
+}
+
+// Template declarations
+
+template class Sub<int>;
+template class Sub<double>;
+template class Sub<long>;
+template class Sub<long long>;
\ No newline at end of file
@@ -1,4 +1,261 @@
 #include "operation.hpp"
+#include "../utils/utils.hpp"
+#include "../utils/no_grad.hpp"
+#include <cassert>
+#include <stdexcept>
+
+template <class T>
+std::atomic<JacobianCache> Operation<T>::policy{ JacobianCache::Keep };
+
+template <class T>
+std::vector<T>& Operation<T>::values(Tensor<T>& tensor)
+{
+    /*
+    Raw row-major storage of 'tensor', for operations 
+    that work on flat data.
+    */
+
+    return tensor.data;
+}
+
+template <class T>
+const std::vector<T>& Operation<T>::values(const Tensor<T>& tensor)
+{
+    return tensor.data;
+}
+
+template <class T>
+Tensor<T> Operation<T>::tangent_like(const Tensor<T>& out, const Tensor<T>* tangent1, const Tensor<T>* tangent2)
+{
+    /*
+    Zero tangent for 'out', with as many tangents as the 
+    (non-null) argument tangents.
+    */
+
+    const Tensor<T>* tangent{ tangent1 ? tangent1 : tangent2 };
+    assert(tangent);
+    assert(!(tangent1 && tangent2) || (tangent1->shape[0] == tangent2->shape[0]));
+
+    return Tensor<T>{ utils::concat_shapes({ tangent->shape[0] }, out.shape), 0 };
+}
+
+template <class T>
+Tensor<T>& Operation<T>::constant(const utils::Shape& shape, const T value)
+{
+    /*
+    Inaccessible constant tensor, deleted along with the 
+    (single) tensor it is used to produce.
+    */
+
+    Tensor<T>* out = new Tensor<T>{ shape, value };
+    out->set_accessible_bool(false);
+    return *out;
+}
+
+template <class T>
+Tensor<T>& Operation<T>::operand(Tensor<T>& tensor)
+{
+    /*
+    Inaccessible tensors are deleted along with the single tensor 
+    they produced, so they cannot be reused as the argument of a 
+    new operation (as in '_vjp'). They are constants, so a fresh 
+    copy is used in their place.
+    */
+
+    if(tensor.is_accessible)
+        return tensor;
+
+    Tensor<T>& copy{ constant(tensor.shape, 0) };
+    copy.data = tensor.data;
+    return copy;
+}
+
+template <class T>
+Tensor<T>& Operation<T>::broadcast(Tensor<T>& scalar, const utils::Shape& shape)
+{
+    return scalar.broadcast(shape);
+}
+
+template <class T>
+long long Operation<T>::total_nnz(const std::vector<Tensor<T>>& tensors)
+{
+    long long nnz{ 0 };
+
+    for(const Tensor<T>& tensor : tensors)
+        nnz += static_cast<long long>(tensor.non_zero_idxs.size());
+
+    return nnz;
+}
+
+template <class T>
+long long Operation<T>::total_bytes(const std::vector<Tensor<T>>& tensors)
+{
+    long long bytes{ 0 };
+
+    for(const Tensor<T>& tensor : tensors)
+        bytes += static_cast<long long>(tensor.data.size() * sizeof(T));
+
+    return bytes;
+}
+
+template <class T>
+void Operation<T>::account_jacobians(std::vector<Tensor<T>>& tensors)
+{
+    for(Tensor<T>& tensor : tensors)
+    {
+        tensor.memory.mark_jacobian();
+        tensor.sync_memory();
+    }
+}
+
+template <class T>
+MemoryUsage Operation<T>::memory_usage() const
+{
+    MemoryUsage usage{};
+
+    for(const Tensor<T>& tensor : cached_grads)
+        usage += tensor.memory.usage();
+
+    return usage;
+}
+
+template <class T>
+const std::vector<Tensor<T>>& Operation<T>::jacobians(const std::vector<Tensor<T>*>& args, const std::function<std::vector<Tensor<T>>()>& compute)
+{
+    /*
+    The returned reference stays valid until the Jacobians are 
+    released or recomputed, which only happens through this graph.
+    */
+
+    std::lock_guard<std::mutex> lock{ backward_mutex };
+
+    bool valid{ has_cache && (cached_versions.size() == args.size()) };
+
+    for(int i = 0; valid && i < static_cast<int>(args.size()); ++i)
+        valid = (cached_versions[i] == args[i]->version);
+
+    if(valid)
+        return cached_grads;
+
+    cached_grads = compute();
+    account_jacobians(cached_grads);
+
+    cached_versions.clear();
+
+    for(const Tensor<T>* arg : args)
+        cached_versions.push_back(arg->version);
+
+    has_cache = true;
+    return cached_grads;
+}
+
+template <class T>
+void Operation<T>::release_jacobians()
+{
+    std::lock_guard<std::mutex> lock{ backward_mutex };
+
+    std::vector<Tensor<T>>{}.swap(cached_grads);
+    has_cache = false;
+}
+
+template <class T>
+void Operation<T>::set_cache_policy(const JacobianCache policy)
+{
+    Operation<T>::policy = policy;
+}
+
+template <class T>
+JacobianCache Operation<T>::cache_policy()
+{
+    return policy;
+}
+
+template <class T>
+bool Operation<T>::donatable(const Tensor<T>& tensor)
+{
+    /*
+    Only temporaries owned by a NoGradGuard qualify: results of a 
+    donating guard, and inaccessible constants (which nothing else 
+    refers to) unless they belong to a graph being re-evaluated, 
+    as by a MemoryPlanner. A tangent still needs the values of the 
+    argument.
+    */
+
+    return NoGradGuard::enabled() && (tensor.is_donatable || (!tensor.is_accessible && !tensor.has_children())) && !tensor.tangent;
+}
+
+template <class T>
+Tensor<T>& Operation<T>::donate(Tensor<T>& donor)
+{
+    /*
+    The donor records that it no longer holds its values before 
+    the result records them, so they are never counted twice.
+    */
+
+    std::vector<T> values{ std::move(donor.data) };
+
+    donor.data.clear();
+    ++donor.version;
+    donor.sync_memory();
+
+    Tensor<T>* out = new Tensor<T>{ std::move(values), donor.shape };
+    return *out;
+}
+
+template <class T>
+void Operation<T>::check_not_donated(const std::vector<Tensor<T>*>& args)
+{
+    for(const Tensor<T>* arg : args)
+        if(arg->data.size() != static_cast<size_t>(utils::prod(arg->shape)))
+            throw std::runtime_error("Tensor was donated to another operation.");
+}
+
+template <class T>
+bool Operation<T>::in_place() const
+{
+    return false;
+}
+
+template <class T>
+std::vector<typename Operation<T>::SparseRows> Operation<T>::sparse_backward(std::vector<Tensor<T>*>& args)
+{
+    throw std::runtime_error("Operation has dense Jacobians, use 'backward'.");
+}
+
+template <class T>
+bool Operation<T>::has_jacobians() const
+{
+    return true;
+}
+
+template <class T>
+bool Operation<T>::has_vjp() const
+{
+    return true;
+}
+
+template <class T>
+bool Operation<T>::equivalent(const Operation<T>& other) const
+{
+    return typeid(*this) == typeid(other);
+}
+
+template <class T>
+long long Operation<T>::flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const
+{
+    return static_cast<long long>(utils::prod(out.shape));
+}
+
+template <class T>
+void Operation<T>::rebind(const std::vector<Tensor<T>*>& args)
+{
+    std::lock_guard<std::mutex> lock{ backward_mutex };
+
+    cached_args = args;
+    std::vector<Tensor<T>>{}.swap(cached_grads);
+    cached_versions.clear();
+    has_cache = false;
+}
 
 // Template declarations
 
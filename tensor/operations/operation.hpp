@@ -5,15 +5,46 @@ template <class T>
 class Tensor;
 
 #include "../tensor.hpp"
+#include "../utils/profiler.hpp"
+#include "../utils/memory.hpp"
+#include "../utils/shape.hpp"
 #include <vector>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <utility>
+#include <typeinfo>
+
+/*
+What an operation does with its Jacobians once the engine has used 
+them: 'Keep' them until the graph is destroyed, 'Free' them at the 
+end of the 'backprop' call, or 'Recompute' them on every use, 
+freeing each right after it is consumed.
+*/
+
+enum class JacobianCache { Keep, Free, Recompute };
 
 template <class T>
 class Operation
 {
+private:
+    static std::atomic<JacobianCache> policy;
+
 protected:
     std::vector<Tensor<T>*> cached_args;
+    /*
+    Jacobians wrt. the arguments, computed on the first call to 
+    'backward' (even if several threads ask for them at once) and 
+    again once released or once an argument has been modified, 
+    as tracked by the argument versions they were computed from.
+    */
+
     std::vector<Tensor<T>> cached_grads;
-    bool done_backward{ false };
+    std::vector<unsigned long long> cached_versions;
+    bool has_cache{ false };
+    std::mutex backward_mutex;
+
+    const std::vector<Tensor<T>>& jacobians(const std::vector<Tensor<T>*>& args, const std::function<std::vector<Tensor<T>>()>& compute);
     
     // Unary functions
     virtual Tensor<T>& _forward(Tensor<T>& tensor) = 0;
@@ -23,18 +54,170 @@ protected:
     virtual Tensor<T>& _forward(Tensor<T>& tensor1, Tensor<T>& tensor2) = 0;
     virtual std::vector<Tensor<T>> _backward(Tensor<T>& tensor1, Tensor<T>& tensor2) = 0;
 
+    /*
+    Forward-mode functions. Given the tangents of the arguments,
+    of shape (num_tangents, *arg.shape), returns the tangent of
+    'out' of shape (num_tangents, *out.shape). A null binary
+    tangent is treated as zero.
+    */
+
+    virtual Tensor<T> _tangent(Tensor<T>& tensor, Tensor<T>& out, const Tensor<T>& tangent) = 0;
+    virtual Tensor<T> _tangent(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, const Tensor<T>* tangent1, const Tensor<T>* tangent2) = 0;
+
+    /*
+    Differentiable vector-Jacobian products. Given 'grad', the
+    derivative of some scalar wrt. 'out', returns the derivative
+    of that scalar wrt. each argument, built from graph operations
+    so that it can itself be differentiated. A null entry means
+    no contribution.
+    */
+
+    virtual std::vector<Tensor<T>*> _vjp(Tensor<T>& tensor, Tensor<T>& out, Tensor<T>& grad) = 0;
+    virtual std::vector<Tensor<T>*> _vjp(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, Tensor<T>& grad) = 0;
+
+    // Helpers
+    static std::vector<T>& values(Tensor<T>& tensor);
+    static const std::vector<T>& values(const Tensor<T>& tensor);
+    static Tensor<T> tangent_like(const Tensor<T>& out, const Tensor<T>* tangent1, const Tensor<T>* tangent2 = nullptr);
+    static Tensor<T>& constant(const utils::Shape& shape, const T value);
+    static Tensor<T>& broadcast(Tensor<T>& scalar, const utils::Shape& shape);
+    static Tensor<T>& operand(Tensor<T>& tensor);
+
+    // Profiling statistics of Jacobians
+    static long long total_nnz(const std::vector<Tensor<T>>& tensors);
+    static long long total_bytes(const std::vector<Tensor<T>>& tensors);
+
+    // Records Jacobians with the MemoryTracker
+    static void account_jacobians(std::vector<Tensor<T>>& tensors);
+
+    // Moves the Jacobians into a vector rather than copying them
+    template <class... Tensors>
+    static std::vector<Tensor<T>> moved(Tensors&... tensors);
+
+    /*
+    Buffer donation (see NoGradGuard). 'donate' moves the values of 
+    'donor', already overwritten with the result, into a new tensor.
+    */
+
+    static bool donatable(const Tensor<T>& tensor);
+    static Tensor<T>& donate(Tensor<T>& donor);
+    static void check_not_donated(const std::vector<Tensor<T>*>& args);
+
 public:
+    virtual ~Operation() = default;
+
     // Unary functions
     virtual Tensor<T>& forward(Tensor<T>& tensor) = 0;
-    virtual std::vector<Tensor<T>> backward(Tensor<T>& tensor) = 0;
+    virtual const std::vector<Tensor<T>>& backward(Tensor<T>& tensor) = 0;
 
     // Binary functions
     virtual Tensor<T>& forward(Tensor<T>& tensor1, Tensor<T>& tensor2) = 0;
-    virtual std::vector<Tensor<T>> backward(Tensor<T>& tensor1, Tensor<T>& tensor2) = 0;
+    virtual const std::vector<Tensor<T>>& backward(Tensor<T>& tensor1, Tensor<T>& tensor2) = 0;
     
     // Generic
     virtual Tensor<T>& forward(std::vector<Tensor<T>*> args) = 0;
-    virtual std::vector<Tensor<T>> backward(std::vector<Tensor<T>*>& args) = 0;
+    virtual const std::vector<Tensor<T>>& backward(std::vector<Tensor<T>*>& args) = 0;
+    virtual std::vector<Tensor<T>*> vjp(std::vector<Tensor<T>*>& args, Tensor<T>& out, Tensor<T>& grad) = 0;
+
+    /*
+    Jacobian wrt. an argument in compressed sparse row form, with a 
+    row per element of the result and a column per element of the 
+    argument (both flattened).
+    */
+
+    struct SparseRows
+    {
+        std::vector<int> offsets;
+        std::vector<int> cols;
+        std::vector<T> values;
+    };
+
+    /*
+    Jacobians wrt. each argument for operations without dense ones 
+    (see 'has_jacobians'), computed on every call rather than cached.
+    */
+
+    virtual std::vector<SparseRows> sparse_backward(std::vector<Tensor<T>*>& args);
+
+    /*
+    Computes the result (and tangent) without recording it in the 
+    graph, handing it to the active NoGradGuard.
+    */
+
+    virtual Tensor<T>& evaluate(std::vector<Tensor<T>*> args) = 0;
+
+    /*
+    Usage of the cached Jacobians. Not to be called while 
+    'backward' may be computing them on another thread.
+    */
+
+    MemoryUsage memory_usage() const;
+
+    void release_jacobians();
+
+    static void set_cache_policy(const JacobianCache policy);
+    static JacobianCache cache_policy();
+
+    /*
+    Whether the result may overwrite an argument of the same size 
+    (true for elementwise operations), used by the MemoryPlanner 
+    and for buffer donation.
+    */
+
+    virtual bool in_place() const;
+
+    /*
+    Whether 'backward' computes dense Jacobians. Operations whose 
+    dense Jacobians would be mostly zeros of quadratic size (Conv) 
+    throw from 'backward' and provide 'sparse_backward' instead.
+    */
+
+    virtual bool has_jacobians() const;
+
+    /*
+    Whether 'vjp' builds the derivative from graph operations, so 
+    that it can be differentiated again. Graphs containing an 
+    operation without one (Conv) cannot be differentiated with 
+    'create_graph' or 'hvp'.
+    */
+
+    virtual bool has_vjp() const;
+
+    /*
+    Whether 'other' computes the same function of its arguments 
+    (same type and parameters), used by the GraphRewriter to merge 
+    common subexpressions.
+    */
+
+    virtual bool equivalent(const Operation<T>& other) const;
+
+    /*
+    Estimated arithmetic operations to produce 'out' from 'args'. 
+    A transcendental function (exp, log, pow) of an element counts 
+    as 'transcendental_flops'; copies and reshapes count as none.
+    */
+
+    static constexpr long long transcendental_flops{ 8 };
+
+    virtual long long flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const;
+
+    /*
+    Makes 'args' the arguments the operation was applied to, after 
+    the GraphRewriter has rewired its output, dropping any cached 
+    Jacobians.
+    */
+
+    void rebind(const std::vector<Tensor<T>*>& args);
 };
 
+template <class T>
+template <class... Tensors>
+std::vector<Tensor<T>> Operation<T>::moved(Tensors&... tensors)
+{
+    std::vector<Tensor<T>> out{};
+    out.reserve(sizeof...(tensors));
+    (out.push_back(std::move(tensors)), ...);
+    return out;
+}
+
 #endif
\ No newline at end of file
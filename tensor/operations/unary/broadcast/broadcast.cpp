@@ -2,9 +2,10 @@
 #include "../../../tensor.hpp"
 #include <vector>
 #include <cassert>
+#include <algorithm>
 
 template <class T>
-Broadcast<T>::Broadcast(const std::vector<int>& new_shape)
+Broadcast<T>::Broadcast(const utils::Shape& new_shape)
     : new_shape{ new_shape }
 {}
 
@@ -20,15 +21,47 @@ Tensor<T>& Broadcast<T>::_forward(Tensor<T>& scalar)
 template <class T>
 std::vector<Tensor<T>> Broadcast<T>::_backward(Tensor<T>& scalar)
 {
-    std::vector<int> grad_shape = this->new_shape;
+    utils::Shape grad_shape = this->new_shape;
     grad_shape.push_back(1);
 
     Tensor<T> grad{ grad_shape, 1 };
     grad.non_zero_idxs = utils::total_idxs(grad_shape);
-    return { grad };
+    return this->moved(grad);
 }
 
 
+template <class T>
+Tensor<T> Broadcast<T>::_tangent(Tensor<T>& scalar, Tensor<T>& out, const Tensor<T>& tangent)
+{
+    Tensor<T> out_tangent{ this->tangent_like(out, &tangent) };
+    std::vector<T>& result{ this->values(out_tangent) };
+    const std::vector<T>& in{ this->values(tangent) };
+    const int size{ utils::prod(this->new_shape) };
+
+    for(int k = 0; k < tangent.shape[0]; ++k)
+        std::fill(result.begin() + k*size, result.begin() + (k+1)*size, in[k]);
+
+    return out_tangent;
+}
+
+template <class T>
+std::vector<Tensor<T>*> Broadcast<T>::_vjp(Tensor<T>& scalar, Tensor<T>& out, Tensor<T>& grad)
+{
+    return { &grad.sum() };
+}
+
+template <class T>
+bool Broadcast<T>::equivalent(const Operation<T>& other) const
+{
+    return Operation<T>::equivalent(other) && (static_cast<const Broadcast<T>&>(other).new_shape == this->new_shape);
+}
+
+template <class T>
+long long Broadcast<T>::flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const
+{
+    return 0;
+}
+
 // Template declarations
 
 template class Broadcast<int>;
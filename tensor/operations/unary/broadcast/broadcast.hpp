@@ -3,19 +3,25 @@
 
 #include "../unary.hpp"
 #include "../../../tensor.hpp"
+#include "../../../utils/shape.hpp"
 #include <vector>
 
 template <class T>
 class Broadcast : public Unary<T>
 {
 protected:
-    const std::vector<int> new_shape;
+    const utils::Shape new_shape;
 
     Tensor<T>& _forward(Tensor<T>& scalar) override;
     std::vector<Tensor<T>> _backward(Tensor<T>& scalar) override;
+    Tensor<T> _tangent(Tensor<T>& tensor, Tensor<T>& out, const Tensor<T>& tangent) override;
+    std::vector<Tensor<T>*> _vjp(Tensor<T>& scalar, Tensor<T>& out, Tensor<T>& grad) override;
 
 public:
-    Broadcast(const std::vector<int>& new_shape);
+    Broadcast(const utils::Shape& new_shape);
+
+    bool equivalent(const Operation<T>& other) const override;
+    long long flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const override;
 };
 
 #endif
\ No newline at end of file
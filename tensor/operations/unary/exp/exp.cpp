@@ -3,6 +3,7 @@
 #include "../../../tensor.hpp"
 #include <cassert>
 #include <vector>
+#include <utility>
 #include <cmath>
 
 template <class T>
@@ -15,33 +16,82 @@ Tensor<T>& Exp<T>::_forward(Tensor<T>& tensor)
 {
     Tensor<T>* out = new Tensor<T>{ tensor.shape, 0 };
 
-    out->modify([&tensor, base=this->base](Tensor<T>& out_tensor, const std::vector<int>& index)
-    {
-        out_tensor(index) = std::pow(base, tensor(index));
-    }
-    , tensor.shape);
+    const std::vector<T>& values{ this->values(tensor) };
+    std::vector<T>& result{ this->values(*out) };
+
+    for(int i = 0; i < static_cast<int>(result.size()); ++i)
+        result[i] = std::pow(this->base, values[i]);
 
     return *out;
 }
 
+template <class T>
+void Exp<T>::_forward_in_place(Tensor<T>& tensor)
+{
+    for(T& value : this->values(tensor))
+        value = std::pow(this->base, value);
+}
+
 template <class T>
 std::vector<Tensor<T>> Exp<T>::_backward(Tensor<T>& tensor)
 {
-    std::vector<int> grad_shape{ utils::concat_shapes(tensor.shape, tensor.shape) };
+    utils::Shape grad_shape{ utils::concat_shapes(tensor.shape, tensor.shape) };
 
     Tensor<T> grad{ grad_shape, 0 };
 
-    grad.modify([&tensor, base=this->base](Tensor<T>& grad_tensor, const std::vector<int> index)
+    grad.modify([&tensor = std::as_const(tensor), base=this->base](Tensor<T>& grad_tensor, const utils::Shape index)
     {
-        std::vector<int> total_index{ utils::concat_shapes(index, index) };
+        utils::Shape total_index{ utils::concat_shapes(index, index) };
         grad_tensor(total_index) = std::log(base) * std::pow(base, tensor(index));
         grad_tensor.non_zero_idxs.push_back(total_index);
     }
     , tensor.shape);
 
-    return { grad };
+    return this->moved(grad);
+}
+
+
+template <class T>
+Tensor<T> Exp<T>::_tangent(Tensor<T>& tensor, Tensor<T>& out, const Tensor<T>& tangent)
+{
+    const std::vector<T>& result{ this->values(out) };
+    std::vector<T> derivative(result.size());
+
+    for(int i = 0; i < static_cast<int>(result.size()); ++i)
+        derivative[i] = std::log(this->base) * result[i];
+
+    return this->elementwise_tangent(out, tangent, derivative);
+}
+
+template <class T>
+std::vector<Tensor<T>*> Exp<T>::_vjp(Tensor<T>& tensor, Tensor<T>& out, Tensor<T>& grad)
+{
+    return { &(grad * (out * std::log(this->base))) };
 }
 
+template <class T>
+bool Exp<T>::in_place() const
+{
+    return true;
+}
+
+template <class T>
+bool Exp<T>::equivalent(const Operation<T>& other) const
+{
+    return Operation<T>::equivalent(other) && (static_cast<const Exp<T>&>(other).base == this->base);
+}
+
+template <class T>
+long long Exp<T>::flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const
+{
+    return static_cast<long long>(utils::prod(out.shape)) * this->transcendental_flops;
+}
+
+template <class T>
+T Exp<T>::get_base() const
+{
+    return this->base;
+}
 
 // Template declarations
 
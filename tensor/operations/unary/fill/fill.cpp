@@ -0,0 +1,61 @@
+#include "fill.hpp"
+#include "../../../utils/utils.hpp"
+#include "../../../tensor.hpp"
+#include <vector>
+
+template <class T>
+Fill<T>::Fill(const T value)
+    : value{ value }
+{}
+
+template <class T>
+Tensor<T>& Fill<T>::_forward(Tensor<T>& tensor)
+{
+    Tensor<T>* out = new Tensor<T>{ tensor.shape, this->value };
+    return *out;
+}
+
+template <class T>
+std::vector<Tensor<T>> Fill<T>::_backward(Tensor<T>& tensor)
+{
+    utils::Shape grad_shape{ utils::concat_shapes(tensor.shape, tensor.shape) };
+    return { Tensor<T>{ grad_shape, 0 } };
+}
+
+template <class T>
+Tensor<T> Fill<T>::_tangent(Tensor<T>& tensor, Tensor<T>& out, const Tensor<T>& tangent)
+{
+    return this->tangent_like(out, &tangent);
+}
+
+template <class T>
+std::vector<Tensor<T>*> Fill<T>::_vjp(Tensor<T>& tensor, Tensor<T>& out, Tensor<T>& grad)
+{
+    return { nullptr };
+}
+
+
+template <class T>
+bool Fill<T>::equivalent(const Operation<T>& other) const
+{
+    return Operation<T>::equivalent(other) && (static_cast<const Fill<T>&>(other).value == this->value);
+}
+
+template <class T>
+long long Fill<T>::flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const
+{
+    return 0;
+}
+
+template <class T>
+T Fill<T>::get_value() const
+{
+    return this->value;
+}
+
+// Template declarations
+
+template class Fill<int>;
+template class Fill<double>;
+template class Fill<long>;
+template class Fill<long long>;
\ No newline at end of file
@@ -0,0 +1,34 @@
+#ifndef FILL_HPP
+#define FILL_HPP
+
+#include "../unary.hpp"
+#include "../../../tensor.hpp"
+#include <vector>
+
+template <class T>
+class Fill : public Unary<T>
+{
+protected:
+    /*
+    Produces a tensor of the same shape as its argument filled 
+    with 'value'. The result does not depend on the values of 
+    the argument, so all of its derivatives are zero.
+    */
+
+    const T value;
+
+    Tensor<T>& _forward(Tensor<T>& tensor) override;
+    std::vector<Tensor<T>> _backward(Tensor<T>& tensor) override;
+    Tensor<T> _tangent(Tensor<T>& tensor, Tensor<T>& out, const Tensor<T>& tangent) override;
+    std::vector<Tensor<T>*> _vjp(Tensor<T>& tensor, Tensor<T>& out, Tensor<T>& grad) override;
+
+public:
+    Fill(const T value);
+
+    bool equivalent(const Operation<T>& other) const override;
+    long long flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const override;
+
+    T get_value() const;
+};
+
+#endif
\ No newline at end of file
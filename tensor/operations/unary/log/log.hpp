@@ -12,10 +12,20 @@ protected:
     const T base;
 
     Tensor<T>& _forward(Tensor<T>& tensor) override;
+    void _forward_in_place(Tensor<T>& tensor) override;
     std::vector<Tensor<T>> _backward(Tensor<T>& tensor) override;
+    Tensor<T> _tangent(Tensor<T>& tensor, Tensor<T>& out, const Tensor<T>& tangent) override;
+    std::vector<Tensor<T>*> _vjp(Tensor<T>& tensor, Tensor<T>& out, Tensor<T>& grad) override;
 
 public:
+    bool in_place() const override;
+
     Log(const T base);
+
+    bool equivalent(const Operation<T>& other) const override;
+    long long flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const override;
+
+    T get_base() const;
 };
 
 #endif
\ No newline at end of file
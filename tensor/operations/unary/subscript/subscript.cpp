@@ -5,7 +5,7 @@
 #include <vector>
 
 template <class T>
-Subscript<T>::Subscript(const std::vector<int>& index)
+Subscript<T>::Subscript(const utils::Shape& index)
     : index{ index }
     , index_size{ static_cast<int>(index.size()) }
 {}
@@ -25,20 +25,65 @@ Tensor<T>& Subscript<T>::_forward(Tensor<T>& tensor)
 template <class T>
 std::vector<Tensor<T>> Subscript<T>::_backward(Tensor<T>& tensor)
 {
-    std::vector<int> grad_shape{ tensor.shape };
+    utils::Shape grad_shape{ tensor.shape };
     grad_shape.insert(grad_shape.begin(), 1);
     
     Tensor<T> grad{ grad_shape, 0 };
 
-    std::vector<int> total_index{ this->index };
+    utils::Shape total_index{ this->index };
     total_index.insert(total_index.begin(), 0);
 
     grad(total_index) = 1;
     grad.non_zero_idxs = { total_index };
-    return { grad };
+    return this->moved(grad);
 }
 
 
+template <class T>
+Tensor<T> Subscript<T>::_tangent(Tensor<T>& tensor, Tensor<T>& out, const Tensor<T>& tangent)
+{
+    Tensor<T> out_tangent{ this->tangent_like(out, &tangent) };
+    const int flat_index{ tensor.flatten_index(this->index) };
+    const int size{ static_cast<int>(tensor.data.size()) };
+
+    for(int k = 0; k < tangent.shape[0]; ++k)
+        out_tangent.data[k] = tangent.data[k*size + flat_index];
+
+    return out_tangent;
+}
+
+template <class T>
+std::vector<Tensor<T>*> Subscript<T>::_vjp(Tensor<T>& tensor, Tensor<T>& out, Tensor<T>& grad)
+{
+    /*
+    Scatters 'grad' back to 'index' by masking its
+    broadcast with a one-hot constant.
+    */
+
+    Tensor<T>& one_hot{ this->constant(tensor.shape, 0) };
+    one_hot(this->index) = 1;
+
+    return { &(this->broadcast(grad, tensor.shape) * one_hot) };
+}
+
+template <class T>
+bool Subscript<T>::equivalent(const Operation<T>& other) const
+{
+    return Operation<T>::equivalent(other) && (static_cast<const Subscript<T>&>(other).index == this->index);
+}
+
+template <class T>
+long long Subscript<T>::flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const
+{
+    return 0;
+}
+
+template <class T>
+const utils::Shape& Subscript<T>::get_index() const
+{
+    return this->index;
+}
+
 // Template declarations
 
 template class Subscript<int>;
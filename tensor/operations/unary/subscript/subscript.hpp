@@ -6,20 +6,28 @@ class Unary;
 
 #include "../unary.hpp"
 #include "../../../tensor.hpp"
+#include "../../../utils/shape.hpp"
 #include <vector>
 
 template <class T>
 class Subscript : public Unary<T>
 {
 protected:
-    const std::vector<int> index;
+    const utils::Shape index;
     const int index_size;
 
     Tensor<T>& _forward(Tensor<T>& tensor) override;
     std::vector<Tensor<T>> _backward(Tensor<T>& tensor) override;
+    Tensor<T> _tangent(Tensor<T>& tensor, Tensor<T>& out, const Tensor<T>& tangent) override;
+    std::vector<Tensor<T>*> _vjp(Tensor<T>& tensor, Tensor<T>& out, Tensor<T>& grad) override;
 
 public:
-    Subscript(const std::vector<int>& index);
+    Subscript(const utils::Shape& index);
+
+    bool equivalent(const Operation<T>& other) const override;
+    long long flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const override;
+
+    const utils::Shape& get_index() const;
 };
 
 #endif
\ No newline at end of file
@@ -18,14 +18,41 @@ Tensor<T>& Sum<T>::_forward(Tensor<T>& tensor)
 template <class T>
 std::vector<Tensor<T>> Sum<T>::_backward(Tensor<T>& tensor)
 {
-    std::vector<int> out_shape{ tensor.shape };
+    utils::Shape out_shape{ tensor.shape };
     out_shape.insert(out_shape.begin(), 1);
     Tensor<T> grad{ out_shape, 1 };
     grad.non_zero_idxs = utils::total_idxs(out_shape);
-    return { grad };
+    return this->moved(grad);
 }
 
 
+template <class T>
+Tensor<T> Sum<T>::_tangent(Tensor<T>& tensor, Tensor<T>& out, const Tensor<T>& tangent)
+{
+    Tensor<T> out_tangent{ this->tangent_like(out, &tangent) };
+    const int size{ static_cast<int>(tensor.data.size()) };
+
+    for(int k = 0; k < tangent.shape[0]; ++k)
+        out_tangent.data[k] = std::accumulate(tangent.data.begin() + k*size, tangent.data.begin() + (k+1)*size, static_cast<T>(0));
+
+    return out_tangent;
+}
+
+template <class T>
+std::vector<Tensor<T>*> Sum<T>::_vjp(Tensor<T>& tensor, Tensor<T>& out, Tensor<T>& grad)
+{
+    if(tensor.shape == grad.shape)
+        return { &grad };
+
+    return { &this->broadcast(grad, tensor.shape) };
+}
+
+template <class T>
+long long Sum<T>::flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const
+{
+    return static_cast<long long>(utils::prod(args[0]->shape));
+}
+
 // Template declarations
 
 template class Sum<int>;
@@ -0,0 +1,78 @@
+#include "transpose.hpp"
+#include "../../../utils/utils.hpp"
+#include "../../../tensor.hpp"
+#include <cassert>
+#include <vector>
+
+template <class T>
+Tensor<T>& Transpose<T>::_forward(Tensor<T>& tensor)
+{
+    assert(tensor.dim == 2);
+
+    int rows{ tensor.shape[0] }, cols{ tensor.shape[1] };
+
+    Tensor<T>* out = new Tensor<T>{ { cols, rows }, 0 };
+    const std::vector<T>& in{ this->values(tensor) };
+    std::vector<T>& result{ this->values(*out) };
+
+    for(int i = 0; i < rows; ++i)
+        for(int j = 0; j < cols; ++j)
+            result[j*rows + i] = in[i*cols + j];
+
+    return *out;
+}
+
+template <class T>
+std::vector<Tensor<T>> Transpose<T>::_backward(Tensor<T>& tensor)
+{
+    int rows{ tensor.shape[0] }, cols{ tensor.shape[1] };
+
+    Tensor<T> grad{ { cols, rows, rows, cols }, 0 };
+
+    grad.modify([](Tensor<T>& grad_tensor, const utils::Shape& index)
+    {
+        utils::Shape total_index{ index[1], index[0], index[0], index[1] };
+        grad_tensor(total_index) = 1;
+        grad_tensor.non_zero_idxs.push_back(total_index);
+    }
+    , tensor.shape);
+
+    return this->moved(grad);
+}
+
+template <class T>
+Tensor<T> Transpose<T>::_tangent(Tensor<T>& tensor, Tensor<T>& out, const Tensor<T>& tangent)
+{
+    int rows{ tensor.shape[0] }, cols{ tensor.shape[1] };
+
+    Tensor<T> out_tangent{ this->tangent_like(out, &tangent) };
+    const std::vector<T>& in{ this->values(tangent) };
+    std::vector<T>& result{ this->values(out_tangent) };
+
+    for(int k = 0; k < tangent.shape[0]; ++k)
+        for(int i = 0; i < rows; ++i)
+            for(int j = 0; j < cols; ++j)
+                result[k*rows*cols + j*rows + i] = in[k*rows*cols + i*cols + j];
+
+    return out_tangent;
+}
+
+template <class T>
+std::vector<Tensor<T>*> Transpose<T>::_vjp(Tensor<T>& tensor, Tensor<T>& out, Tensor<T>& grad)
+{
+    return { &grad.transpose() };
+}
+
+
+template <class T>
+long long Transpose<T>::flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const
+{
+    return 0;
+}
+
+// Template declarations
+
+template class Transpose<int>;
+template class Transpose<double>;
+template class Transpose<long>;
+template class Transpose<long long>;
\ No newline at end of file
@@ -0,0 +1,21 @@
+#ifndef TRANSPOSE_HPP
+#define TRANSPOSE_HPP
+
+#include "../unary.hpp"
+#include "../../../tensor.hpp"
+#include <vector>
+
+template <class T>
+class Transpose : public Unary<T>
+{
+protected:
+    Tensor<T>& _forward(Tensor<T>& tensor) override;
+    std::vector<Tensor<T>> _backward(Tensor<T>& tensor) override;
+    Tensor<T> _tangent(Tensor<T>& tensor, Tensor<T>& out, const Tensor<T>& tangent) override;
+    std::vector<Tensor<T>*> _vjp(Tensor<T>& tensor, Tensor<T>& out, Tensor<T>& grad) override;
+
+public:
+    long long flops(const std::vector<Tensor<T>*>& args, const Tensor<T>& out) const override;
+};
+
+#endif
\ No newline at end of file
@@ -1,28 +1,59 @@
 #include "unary.hpp"
+#include "../../utils/no_grad.hpp"
 #include <cassert>
 #include <stdexcept>
 
 template <class T>
-Tensor<T>& Unary<T>::forward(Tensor<T>& tensor)
+Tensor<T>& Unary<T>::compute(Tensor<T>& tensor)
 {
+    TENSORGRAD_PROFILE_SCOPE(profile, Profiler::type_name(typeid(*this)), "forward");
+    TENSORGRAD_PROFILE_SET(profile, shape, Profiler::shape_str(tensor.shape));
+
     Tensor<T>& out{ _forward(tensor) };
 
+    TENSORGRAD_PROFILE_SET(profile, elements, static_cast<long long>(this->values(out).size()));
+    TENSORGRAD_PROFILE_SET(profile, bytes, static_cast<long long>(this->values(out).size() * sizeof(T)));
+
+    if(tensor.tangent)
+        out.tangent = new Tensor<T>{ _tangent(tensor, out, *tensor.tangent) };
+
+    return out;
+}
+
+template <class T>
+Tensor<T>& Unary<T>::forward(Tensor<T>& tensor)
+{
+    Tensor<T>& out{ compute(tensor) };
+
     this->cached_args = { &tensor };
     out.set_grad_info(this->cached_args, this);
     return out;
 }
 
 template <class T>
-std::vector<Tensor<T>> Unary<T>::backward(Tensor<T>& tensor)
+const std::vector<Tensor<T>>& Unary<T>::backward(Tensor<T>& tensor)
 {
     assert(&tensor == this->cached_args[0]);
 
-    if(this->done_backward)
-        return this->cached_grads;
+    return this->jacobians({ &tensor }, [&]
+    {
+        TENSORGRAD_PROFILE_SCOPE(profile, Profiler::type_name(typeid(*this)), "backward");
+        TENSORGRAD_PROFILE_SET(profile, shape, Profiler::shape_str(tensor.shape));
+
+        std::vector<Tensor<T>> grads{ _backward(tensor) };
 
-    this->cached_grads = { _backward(tensor) };
-    this->done_backward = true;
-    return this->cached_grads;
+        TENSORGRAD_PROFILE_SET(profile, elements, this->total_bytes(grads) / static_cast<long long>(sizeof(T)));
+        TENSORGRAD_PROFILE_SET(profile, bytes, this->total_bytes(grads));
+        TENSORGRAD_PROFILE_SET(profile, nnz, this->total_nnz(grads));
+
+        return grads;
+    });
+}
+
+template <class T>
+void Unary<T>::_forward_in_place(Tensor<T>& tensor)
+{
+    throw std::runtime_error("Operation cannot be evaluated in place.");
 }
 
 template <class T>
@@ -37,6 +68,18 @@ std::vector<Tensor<T>> Unary<T>::_backward(Tensor<T>& tensor1, Tensor<T>& tensor
     throw std::runtime_error("Unary operation does not support binary arguments.");
 }
 
+template <class T>
+Tensor<T> Unary<T>::_tangent(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, const Tensor<T>* tangent1, const Tensor<T>* tangent2)
+{
+    throw std::runtime_error("Unary operation does not support binary arguments.");
+}
+
+template <class T>
+std::vector<Tensor<T>*> Unary<T>::_vjp(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, Tensor<T>& grad)
+{
+    throw std::runtime_error("Unary operation does not support binary arguments.");
+}
+
 template <class T>
 Tensor<T>& Unary<T>::forward(Tensor<T>& tensor1, Tensor<T>& tensor2)
 {
@@ -44,7 +87,7 @@ Tensor<T>& Unary<T>::forward(Tensor<T>& tensor1, Tensor<T>& tensor2)
 }
 
 template <class T>
-std::vector<Tensor<T>> Unary<T>::backward(Tensor<T>& tensor1, Tensor<T>& tensor2)
+const std::vector<Tensor<T>>& Unary<T>::backward(Tensor<T>& tensor1, Tensor<T>& tensor2)
 {
     throw std::runtime_error("Unary operation does not support binary arguments.");
 }
@@ -57,12 +100,55 @@ Tensor<T>& Unary<T>::forward(std::vector<Tensor<T>*> args)
 }
 
 template <class T>
-std::vector<Tensor<T>> Unary<T>::backward(std::vector<Tensor<T>*>& args)
+Tensor<T>& Unary<T>::evaluate(std::vector<Tensor<T>*> args)
+{
+    assert(args.size() == 1);
+    this->check_not_donated(args);
+
+    Tensor<T>& tensor{ *(args[0]) };
+
+    if(this->in_place() && this->donatable(tensor))
+    {
+        _forward_in_place(tensor);
+        return NoGradGuard::adopt(&this->donate(tensor));
+    }
+
+    return NoGradGuard::adopt(&compute(tensor));
+}
+
+template <class T>
+const std::vector<Tensor<T>>& Unary<T>::backward(std::vector<Tensor<T>*>& args)
 {
     assert(args.size() == 1);
     return backward(*(args[0]));
 }
 
+template <class T>
+std::vector<Tensor<T>*> Unary<T>::vjp(std::vector<Tensor<T>*>& args, Tensor<T>& out, Tensor<T>& grad)
+{
+    assert(args.size() == 1);
+    return _vjp(*(args[0]), out, grad);
+}
+
+template <class T>
+Tensor<T> Unary<T>::elementwise_tangent(const Tensor<T>& out, const Tensor<T>& tangent, const std::vector<T>& derivative) const
+{
+    /*
+    Tangent of an elementwise operation, each tangent 
+    scaled by the elementwise 'derivative'.
+    */
+
+    Tensor<T> out_tangent{ this->tangent_like(out, &tangent) };
+    std::vector<T>& result{ this->values(out_tangent) };
+    const std::vector<T>& in{ this->values(tangent) };
+
+    const int size{ static_cast<int>(derivative.size()) };
+    for(int i = 0; i < static_cast<int>(result.size()); ++i)
+        result[i] = derivative[i % size] * in[i];
+
+    return out_tangent;
+}
+
 template class Unary<int>;
 template class Unary<double>;
 template class Unary<long>;
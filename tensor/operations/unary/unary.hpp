@@ -15,15 +15,34 @@ protected:
     Tensor<T>& _forward(Tensor<T>& tensor1, Tensor<T>& tensor2) override;
     std::vector<Tensor<T>> _backward(Tensor<T>& tensor1, Tensor<T>& tensor2) override;
 
+    virtual Tensor<T> _tangent(Tensor<T>& tensor, Tensor<T>& out, const Tensor<T>& tangent) = 0;
+    Tensor<T> _tangent(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, const Tensor<T>* tangent1, const Tensor<T>* tangent2) override;
+
+    virtual std::vector<Tensor<T>*> _vjp(Tensor<T>& tensor, Tensor<T>& out, Tensor<T>& grad) = 0;
+    std::vector<Tensor<T>*> _vjp(Tensor<T>& tensor1, Tensor<T>& tensor2, Tensor<T>& out, Tensor<T>& grad) override;
+
+    Tensor<T> elementwise_tangent(const Tensor<T>& out, const Tensor<T>& tangent, const std::vector<T>& derivative) const;
+
+    /*
+    Overwrites the values of 'tensor' with the result, for 
+    operations that are 'in_place'.
+    */
+
+    virtual void _forward_in_place(Tensor<T>& tensor);
+
+    Tensor<T>& compute(Tensor<T>& tensor);
+
 public:
     Tensor<T>& forward(Tensor<T>& tensor) override;
-    std::vector<Tensor<T>> backward(Tensor<T>& tensor) override;
+    const std::vector<Tensor<T>>& backward(Tensor<T>& tensor) override;
 
     Tensor<T>& forward(Tensor<T>& tensor1, Tensor<T>& tensor2) override;
-    std::vector<Tensor<T>> backward(Tensor<T>& tensor1, Tensor<T>& tensor2) override;
+    const std::vector<Tensor<T>>& backward(Tensor<T>& tensor1, Tensor<T>& tensor2) override;
 
     Tensor<T>& forward(std::vector<Tensor<T>*> args) override;
-    std::vector<Tensor<T>> backward(std::vector<Tensor<T>*>& args) override;
+    const std::vector<Tensor<T>>& backward(std::vector<Tensor<T>*>& args) override;
+    std::vector<Tensor<T>*> vjp(std::vector<Tensor<T>*>& args, Tensor<T>& out, Tensor<T>& grad) override;
+    Tensor<T>& evaluate(std::vector<Tensor<T>*> args) override;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "adam.hpp"
+#include <cmath>
+
+template <class T>
+Adam<T>::Adam(const std::vector<Tensor<T>*>& params, const T lr, const T beta1, const T beta2, const T eps)
+    : Optimizer<T>{ params }
+    , lr{ lr }
+    , beta1{ beta1 }
+    , beta2{ beta2 }
+    , eps{ eps }
+    , m{ this->zero_state() }
+    , v{ this->zero_state() }
+{}
+
+template <class T>
+void Adam<T>::prepare_step()
+{
+    ++t;
+    correction1 = 1 - std::pow(beta1, t);
+    correction2 = 1 - std::pow(beta2, t);
+}
+
+template <class T>
+void Adam<T>::update(const int param, const int begin, const int end, T* values, const T* grads)
+{
+    const int size{ end - begin };
+    T* m_chunk{ m[param].data() + begin };
+    T* v_chunk{ v[param].data() + begin };
+
+    const T step_size{ lr / correction1 };
+    const T sqrt_correction2{ static_cast<T>(std::sqrt(correction2)) };
+
+    for(int i = 0; i < size; ++i)
+    {
+        m_chunk[i] = beta1 * m_chunk[i] + (1 - beta1) * grads[i];
+        v_chunk[i] = beta2 * v_chunk[i] + (1 - beta2) * grads[i] * grads[i];
+        values[i] -= step_size * m_chunk[i] / (std::sqrt(v_chunk[i]) / sqrt_correction2 + eps);
+    }
+}
+
+// Template declarations
+
+template class Adam<int>;
+template class Adam<double>;
+template class Adam<long>;
+template class Adam<long long>;
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef ADAM_HPP
+#define ADAM_HPP
+
+template <class T>
+class Optimizer;
+
+#include "../optimizer.hpp"
+#include <vector>
+
+template <class T>
+class Adam : public Optimizer<T>
+{
+private:
+    /*
+    Adam (Kingma & Ba), with bias-corrected first and second 
+    moment estimates 'm' and 'v':
+
+        m = beta1 * m + (1 - beta1) * grad
+        v = beta2 * v + (1 - beta2) * grad^2
+        param -= lr * (m / (1 - beta1^t)) / (sqrt(v / (1 - beta2^t)) + eps)
+    */
+
+    const T lr;
+    const T beta1;
+    const T beta2;
+    const T eps;
+
+    int t{ 0 };
+    T correction1{ 1 };
+    T correction2{ 1 };
+
+    std::vector<std::vector<T>> m;
+    std::vector<std::vector<T>> v;
+
+protected:
+    void prepare_step() override;
+    void update(const int param, const int begin, const int end, T* values, const T* grads) override;
+
+public:
+    Adam(const std::vector<Tensor<T>*>& params, const T lr = 0.001, const T beta1 = 0.9, const T beta2 = 0.999, const T eps = 1e-8);
+};
+
+#endif
\ No newline at end of file
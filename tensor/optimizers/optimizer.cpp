@@ -0,0 +1,81 @@
+#include "optimizer.hpp"
+#include "../utils/utils.hpp"
+#include <stdexcept>
+#include <algorithm>
+
+template <class T>
+Optimizer<T>::Optimizer(const std::vector<Tensor<T>*>& params)
+    : params{ params }
+{
+    for(int param = 0; param < static_cast<int>(params.size()); ++param)
+    {
+        const int size{ static_cast<int>(params[param]->data.size()) };
+
+        for(int begin = 0; begin < size; begin += chunk_size)
+            chunks.push_back({ param, begin, std::min(size, begin + chunk_size) });
+    }
+}
+
+template <class T>
+void Optimizer<T>::prepare_step()
+{}
+
+template <class T>
+std::vector<std::vector<T>> Optimizer<T>::zero_state() const
+{
+    /*
+    A zeroed buffer per parameter, for optimizer state.
+    */
+
+    std::vector<std::vector<T>> state{};
+
+    for(const Tensor<T>* param : params)
+        state.emplace_back(param->data.size(), 0);
+
+    return state;
+}
+
+template <class T>
+void Optimizer<T>::step()
+{
+    /*
+    Updates every parameter in place from its 'grad'. Parameters 
+    without a 'grad' are left unchanged.
+    */
+
+    for(const Tensor<T>* param : params)
+        if(param->grad && (param->grad->data.size() != param->data.size()))
+            throw std::runtime_error("Parameter and gradient sizes do not match.");
+
+    prepare_step();
+
+    utils::parallel_for(0, static_cast<int>(chunks.size()), [this](int chunk_begin, int chunk_end)
+    {
+        for(int c = chunk_begin; c < chunk_end; ++c)
+        {
+            const Chunk& chunk{ chunks[c] };
+            Tensor<T>& param{ *params[chunk.param] };
+
+            if(param.grad)
+                update(chunk.param, chunk.begin, chunk.end, param.data.data() + chunk.begin, param.grad->data.data() + chunk.begin);
+        }
+    });
+
+    for(Tensor<T>* param : params)
+        if(param->grad)
+            param->touch();
+}
+
+template <class T>
+void Optimizer<T>::zero_grad()
+{
+    for(Tensor<T>* param : params)
+        param->zero_grad();
+}
+
+// Template declarations
+
+template class Optimizer<int>;
+template class Optimizer<double>;
+template class Optimizer<long>;
+template class Optimizer<long long>;
\ No newline at end of file
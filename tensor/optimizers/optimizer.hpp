@@ -0,0 +1,54 @@
+#ifndef OPTIMIZER_HPP
+#define OPTIMIZER_HPP
+
+template <class T>
+class Tensor;
+
+#include "../tensor.hpp"
+#include <vector>
+
+template <class T>
+class Optimizer
+{
+protected:
+    /*
+    Updates work on the raw data of the parameters and their 
+    'grad', in one fused pass per element. The parameters are 
+    split into chunks of at most 'chunk_size' elements, and the 
+    chunks of all parameters are processed by a single parallel 
+    loop (multi-tensor apply), so many small parameters do not 
+    each pay for their own dispatch.
+    */
+
+    struct Chunk
+    {
+        int param, begin, end;
+    };
+
+    static constexpr int chunk_size{ 16384 };
+
+    std::vector<Tensor<T>*> params;
+    std::vector<Chunk> chunks;
+
+    /*
+    Fused update of the elements [begin, end) of parameter 'param', 
+    where 'values' and 'grads' point to the start of the chunk.
+    */
+
+    virtual void update(const int param, const int begin, const int end, T* values, const T* grads) = 0;
+
+    // Called once per step before any update, e.g. to advance step counts.
+    virtual void prepare_step();
+
+    std::vector<std::vector<T>> zero_state() const;
+
+public:
+    Optimizer(const std::vector<Tensor<T>*>& params);
+    virtual ~Optimizer() = default;
+
+    void step();
+
+    void zero_grad();
+};
+
+#endif
\ No newline at end of file
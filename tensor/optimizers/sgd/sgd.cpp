@@ -0,0 +1,39 @@
+#include "sgd.hpp"
+
+template <class T>
+SGD<T>::SGD(const std::vector<Tensor<T>*>& params, const T lr, const T momentum, const T weight_decay)
+    : Optimizer<T>{ params }
+    , lr{ lr }
+    , momentum{ momentum }
+    , weight_decay{ weight_decay }
+    , velocity{ momentum != 0 ? this->zero_state() : std::vector<std::vector<T>>{} }
+{}
+
+template <class T>
+void SGD<T>::update(const int param, const int begin, const int end, T* values, const T* grads)
+{
+    const int size{ end - begin };
+
+    if(momentum == 0)
+    {
+        for(int i = 0; i < size; ++i)
+            values[i] -= lr * (grads[i] + weight_decay * values[i]);
+
+        return;
+    }
+
+    T* v{ velocity[param].data() + begin };
+
+    for(int i = 0; i < size; ++i)
+    {
+        v[i] = momentum * v[i] + grads[i] + weight_decay * values[i];
+        values[i] -= lr * v[i];
+    }
+}
+
+// Template declarations
+
+template class SGD<int>;
+template class SGD<double>;
+template class SGD<long>;
+template class SGD<long long>;
\ No newline at end of file
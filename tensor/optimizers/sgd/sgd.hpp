@@ -0,0 +1,37 @@
+#ifndef SGD_HPP
+#define SGD_HPP
+
+template <class T>
+class Optimizer;
+
+#include "../optimizer.hpp"
+#include <vector>
+
+template <class T>
+class SGD : public Optimizer<T>
+{
+private:
+    /*
+    Stochastic gradient descent with (optional) momentum and 
+    L2 weight decay:
+
+        v = momentum * v + (grad + weight_decay * param)
+        param -= lr * v
+
+    The velocity buffers are only allocated when momentum != 0.
+    */
+
+    const T lr;
+    const T momentum;
+    const T weight_decay;
+
+    std::vector<std::vector<T>> velocity;
+
+protected:
+    void update(const int param, const int begin, const int end, T* values, const T* grads) override;
+
+public:
+    SGD(const std::vector<Tensor<T>*>& params, const T lr, const T momentum = 0, const T weight_decay = 0);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,342 @@
+#include "memory_planner.hpp"
+#include "../utils/no_grad.hpp"
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+#include <iomanip>
+#include <stdexcept>
+
+template <class T>
+MemoryPlanner<T>::MemoryPlanner(Tensor<T>& root)
+    : root{ &root }
+{
+    if(!root.oper)
+        throw std::runtime_error("Memory planner requires a tensor produced by an operation.");
+
+    build_schedule();
+    compute_lifetimes();
+    assign_slabs();
+}
+
+template <class T>
+void MemoryPlanner<T>::build_schedule()
+{
+    /*
+    Post-order over the parents of 'root', with an explicit stack
+    so that deep graphs do not exhaust the native stack. Leaves
+    (including inaccessible constants) are not scheduled.
+    */
+
+    std::unordered_set<Tensor<T>*> visited{ root };
+    std::vector<std::pair<Tensor<T>*, int>> stack{ { root, 0 } };
+
+    while(!stack.empty())
+    {
+        auto& [tensor, next] = stack.back();
+
+        if(next < static_cast<int>(tensor->parents.size()))
+        {
+            Tensor<T>* parent{ tensor->parents[next++] };
+
+            if(parent->oper && visited.insert(parent).second)
+                stack.emplace_back(parent, 0);
+
+            continue;
+        }
+
+        position[tensor] = static_cast<int>(schedule.size());
+        schedule.push_back(tensor);
+        stack.pop_back();
+    }
+}
+
+template <class T>
+void MemoryPlanner<T>::compute_lifetimes()
+{
+    for(int step = 0; step < static_cast<int>(schedule.size()); ++step)
+    {
+        Tensor<T>* tensor{ schedule[step] };
+        lifetimes.push_back(Interval{ tensor, step, step, static_cast<long long>(tensor->data.size()), -1, false });
+    }
+
+    for(int step = 0; step < static_cast<int>(schedule.size()); ++step)
+        for(Tensor<T>* parent : schedule[step]->parents)
+        {
+            const auto& iter{ position.find(parent) };
+
+            if(iter != position.end())
+                lifetimes[iter->second].end = std::max(lifetimes[iter->second].end, step);
+        }
+}
+
+template <class T>
+void MemoryPlanner<T>::assign_slabs()
+{
+    /*
+    Greedy colouring of the interval graph, in order of start. A
+    slab is free once the last interval assigned to it has ended.
+    An elementwise operation may take the slab of an argument of
+    the same size that dies at this step, otherwise the smallest
+    free slab large enough is used, then the largest free slab
+    (grown to fit), and only then a new slab.
+    */
+
+    std::vector<int> occupant{};
+
+    for(int step = 0; step < static_cast<int>(schedule.size()) - 1; ++step)
+    {
+        Interval& interval{ lifetimes[step] };
+        Tensor<T>* tensor{ schedule[step] };
+
+        if(tensor->oper->in_place())
+            for(Tensor<T>* parent : tensor->parents)
+            {
+                const auto& iter{ position.find(parent) };
+
+                if(iter == position.end())
+                    continue;
+
+                const Interval& argument{ lifetimes[iter->second] };
+
+                if(argument.end == step && argument.elements == interval.elements && occupant[argument.slab] == iter->second)
+                {
+                    interval.slab = argument.slab;
+                    interval.in_place = true;
+                    break;
+                }
+            }
+
+        if(interval.slab < 0)
+        {
+            int best_fit{ -1 };
+            int largest{ -1 };
+
+            for(int slab = 0; slab < static_cast<int>(slab_elements.size()); ++slab)
+            {
+                if(lifetimes[occupant[slab]].end >= step)
+                    continue;
+
+                if(slab_elements[slab] >= interval.elements && (best_fit < 0 || slab_elements[slab] < slab_elements[best_fit]))
+                    best_fit = slab;
+
+                if(largest < 0 || slab_elements[slab] > slab_elements[largest])
+                    largest = slab;
+            }
+
+            interval.slab = (best_fit >= 0) ? best_fit : largest;
+        }
+
+        if(interval.slab < 0)
+        {
+            interval.slab = static_cast<int>(slab_elements.size());
+            slab_elements.push_back(0);
+            occupant.push_back(step);
+        }
+
+        slab_elements[interval.slab] = std::max(slab_elements[interval.slab], interval.elements);
+        occupant[interval.slab] = step;
+    }
+}
+
+template <class T>
+const std::vector<typename MemoryPlanner<T>::Interval>& MemoryPlanner<T>::intervals() const
+{
+    return lifetimes;
+}
+
+template <class T>
+int MemoryPlanner<T>::num_slabs() const
+{
+    return static_cast<int>(slab_elements.size());
+}
+
+template <class T>
+long long MemoryPlanner<T>::naive_bytes() const
+{
+    long long elements{ 0 };
+
+    for(const Interval& interval : lifetimes)
+        elements += interval.elements;
+
+    return elements * static_cast<long long>(sizeof(T));
+}
+
+template <class T>
+long long MemoryPlanner<T>::planned_bytes() const
+{
+    long long elements{ lifetimes.back().elements };
+
+    for(long long slab : slab_elements)
+        elements += slab;
+
+    return elements * static_cast<long long>(sizeof(T));
+}
+
+template <class T>
+void MemoryPlanner<T>::report(std::ostream& out) const
+{
+    int in_place{ 0 };
+
+    for(const Interval& interval : lifetimes)
+        in_place += interval.in_place;
+
+    out << "Steps: " << schedule.size() << ", slabs: " << num_slabs() << ", in-place: " << in_place << '\n'
+        << "Naive bytes: " << naive_bytes() << ", planned bytes: " << planned_bytes()
+        << " (" << std::fixed << std::setprecision(2) << static_cast<double>(naive_bytes()) / planned_bytes() << "x)\n";
+
+    for(int slab = 0; slab < num_slabs(); ++slab)
+    {
+        int tensors{ 0 };
+
+        for(const Interval& interval : lifetimes)
+            tensors += (interval.slab == slab);
+
+        out << "  slab " << slab << ": " << slab_elements[slab] * static_cast<long long>(sizeof(T)) << " bytes, " << tensors << " tensor(s)\n";
+    }
+}
+
+template <class T>
+void MemoryPlanner<T>::release()
+{
+    for(int step = 0; step < static_cast<int>(schedule.size()) - 1; ++step)
+    {
+        std::vector<T>{}.swap(schedule[step]->data);
+        schedule[step]->sync_memory();
+    }
+
+    released = true;
+}
+
+template <class T>
+Tensor<T>& MemoryPlanner<T>::execute()
+{
+    /*
+    Until 'release', each step recomputes its tensor into its own
+    storage, as Tensor<T>::refresh does, so the graph can still be
+    read and differentiated. After it, each step evaluates its
+    operation with the slabs of its planned arguments swapped into
+    their tensors, then swaps them back and moves the result's
+    values into its own slab. Arguments alive at the same step
+    never share a slab. The previous occupant of a slab is dead by
+    the time it is taken, so its values are freed before the step,
+    except for a slab taken in place, which the argument dying at
+    this step donates to the operation. The storage held at any
+    time thus stays within 'planned_bytes'.
+    */
+
+    if(!released)
+    {
+        for(Tensor<T>* tensor : schedule)
+        {
+            NoGradGuard guard{};
+            Tensor<T>& result{ tensor->oper->evaluate(tensor->parents) };
+
+            tensor->take(result);
+            tensor->is_stale = false;
+            tensor->sync_memory();
+        }
+
+        return *root;
+    }
+
+    if(slabs.empty())
+    {
+        slabs.resize(slab_elements.size());
+
+        for(int slab = 0; slab < num_slabs(); ++slab)
+            slabs[slab].reserve(slab_elements[slab]);
+
+        record_slabs();
+    }
+
+    const int last{ static_cast<int>(schedule.size()) - 1 };
+
+    for(int step = 0; step <= last; ++step)
+    {
+        Tensor<T>* tensor{ schedule[step] };
+        const Interval& interval{ lifetimes[step] };
+        std::vector<Tensor<T>*> args{ tensor->parents };
+        std::vector<Tensor<T>*> bound{};
+
+        if(step == last)
+        {
+            std::vector<T>{}.swap(root->data);
+            root->sync_memory();
+        }
+        else if(!interval.in_place)
+            std::vector<T>{}.swap(slabs[interval.slab]);
+
+        for(Tensor<T>* arg : args)
+        {
+            const auto& iter{ position.find(arg) };
+
+            if(iter != position.end() && std::find(bound.begin(), bound.end(), arg) == bound.end())
+            {
+                arg->data.swap(slabs[lifetimes[iter->second].slab]);
+                arg->is_donatable = interval.in_place && lifetimes[iter->second].slab == interval.slab;
+                bound.push_back(arg);
+            }
+        }
+
+        // Each buffer is released by one account before the next records it
+        record_slabs();
+
+        for(Tensor<T>* arg : bound)
+            arg->sync_memory();
+
+        NoGradGuard guard{};
+        Tensor<T>& result{ tensor->oper->evaluate(args) };
+
+        for(Tensor<T>* arg : bound)
+        {
+            arg->data.swap(slabs[lifetimes[position.at(arg)].slab]);
+            arg->is_donatable = false;
+            arg->sync_memory();
+        }
+
+        std::vector<T>& destination{ (step == last) ? root->data : slabs[interval.slab] };
+        destination.swap(result.data);
+        std::vector<T>{}.swap(result.data);
+        result.sync_memory();
+
+        if(step == last)
+        {
+            root->touch();
+            root->sync_memory();
+        }
+
+        record_slabs();
+        tensor->is_stale = false;
+    }
+
+    return *root;
+}
+
+template <class T>
+void MemoryPlanner<T>::record_slabs()
+{
+    MemoryUsage usage{};
+
+    for(const std::vector<T>& slab : slabs)
+        usage.data += static_cast<long long>(slab.capacity() * sizeof(T));
+
+    MemoryUsage delta{ usage };
+    delta -= recorded;
+    MemoryTracker::add(delta);
+    recorded = usage;
+}
+
+template <class T>
+MemoryPlanner<T>::~MemoryPlanner()
+{
+    MemoryUsage delta{};
+    delta -= recorded;
+    MemoryTracker::add(delta);
+}
+
+// Template declarations
+
+template class MemoryPlanner<int>;
+template class MemoryPlanner<double>;
+template class MemoryPlanner<long>;
+template class MemoryPlanner<long long>;
\ No newline at end of file
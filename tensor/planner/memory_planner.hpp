@@ -0,0 +1,104 @@
+#ifndef MEMORY_PLANNER_HPP
+#define MEMORY_PLANNER_HPP
+
+template <class T>
+class Tensor;
+
+#include "../tensor.hpp"
+#include "../utils/memory.hpp"
+#include <vector>
+#include <unordered_map>
+#include <ostream>
+
+template <class T>
+class MemoryPlanner
+{
+public:
+    /*
+    Lifetime of an intermediate tensor over the forward schedule:
+    it is produced at step 'start' and last read at step 'end'.
+    Intermediates whose lifetimes do not overlap share a slab.
+    With 'in_place', it overwrites an argument that dies at 'start'.
+    */
+
+    struct Interval
+    {
+        Tensor<T>* tensor;
+        int start;
+        int end;
+        long long elements;
+        int slab;
+        bool in_place;
+    };
+
+private:
+    /*
+    'schedule' holds the tensors produced by operations that 'root'
+    depends on, in an order in which they can be computed. The last
+    step produces 'root', which keeps its own storage.
+    */
+
+    Tensor<T>* root;
+    std::vector<Tensor<T>*> schedule;
+    std::vector<Interval> lifetimes;
+    std::unordered_map<Tensor<T>*, int> position;
+
+    std::vector<long long> slab_elements;
+    std::vector<std::vector<T>> slabs;
+    bool released{ false };
+
+    // Storage of the slabs, as last recorded with the MemoryTracker
+    MemoryUsage recorded{};
+
+    void build_schedule();
+    void compute_lifetimes();
+    void assign_slabs();
+    void record_slabs();
+
+public:
+    /*
+    Plans the forward pass of the graph built up to 'root'. Every
+    operation of this engine reads the values of its arguments to
+    compute its Jacobians, so a graph that is still to be
+    differentiated needs all of them: the plan is for inference.
+    */
+
+    explicit MemoryPlanner(Tensor<T>& root);
+    ~MemoryPlanner();
+
+    MemoryPlanner(const MemoryPlanner&) = delete;
+    MemoryPlanner& operator=(const MemoryPlanner&) = delete;
+
+    const std::vector<Interval>& intervals() const;
+
+    int num_slabs() const;
+
+    // Bytes of the intermediates (and root) when each has its own storage
+    long long naive_bytes() const;
+
+    // Bytes of the slabs (and root)
+    long long planned_bytes() const;
+
+    void report(std::ostream& out) const;
+
+    /*
+    Frees the storage of the planned intermediates in the graph,
+    whose values then only live in the slabs. The graph can still
+    be executed, but no longer differentiated or read.
+    */
+
+    void release();
+
+    /*
+    Recomputes the graph from the current values of its leaves and
+    returns 'root' holding the result. Before 'release', every
+    planned tensor is recomputed into its own storage; after it,
+    the intermediates are stored in the slabs. Either way the
+    planned tensors then count as up to date (see Tensor<T>::refresh)
+    until a leaf is next written.
+    */
+
+    Tensor<T>& execute();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,405 @@
+#include "graph_rewriter.hpp"
+#include "../operations/binary/add/add.hpp"
+#include "../operations/binary/mul/mul.hpp"
+#include "../operations/binary/sub/sub.hpp"
+#include "../operations/binary/div/div.hpp"
+#include "../operations/unary/pow/pow.hpp"
+#include "../utils/no_grad.hpp"
+#include <algorithm>
+#include <unordered_map>
+#include <functional>
+#include <typeinfo>
+#include <type_traits>
+#include <utility>
+#include <stdexcept>
+
+template <class T>
+GraphRewriter<T>::GraphRewriter(Tensor<T>& root)
+    : root{ &root }
+{
+    if(!root.oper)
+        throw std::runtime_error("Graph rewriting requires a tensor produced by an operation.");
+}
+
+template <class T>
+std::vector<Tensor<T>*> GraphRewriter<T>::schedule() const
+{
+    /*
+    Operations 'root' depends on, after their arguments (as in
+    MemoryPlanner::build_schedule).
+    */
+
+    std::vector<Tensor<T>*> order{};
+    std::unordered_set<Tensor<T>*> visited{ root };
+    std::vector<std::pair<Tensor<T>*, int>> stack{ { root, 0 } };
+
+    while(!stack.empty())
+    {
+        auto& [tensor, next] = stack.back();
+
+        if(next < static_cast<int>(tensor->parents.size()))
+        {
+            Tensor<T>* parent{ tensor->parents[next++] };
+
+            if(parent->oper && visited.insert(parent).second)
+                stack.emplace_back(parent, 0);
+
+            continue;
+        }
+
+        order.push_back(tensor);
+        stack.pop_back();
+    }
+
+    return order;
+}
+
+template <class T>
+long long GraphRewriter<T>::cost(const std::vector<Tensor<T>*>& order) const
+{
+    long long flops{ 0 };
+
+    for(Tensor<T>* tensor : order)
+        flops += tensor->oper->flops(tensor->parents, *tensor);
+
+    return flops;
+}
+
+template <class T>
+bool GraphRewriter<T>::is_constant(const Tensor<T>* tensor, T& value)
+{
+    /*
+    Inaccessible leaves are the constants of operator overloads
+    (e.g. the 2 of 'x * 2'), which hold a single value.
+    */
+
+    if(tensor->is_accessible || tensor->oper || tensor->data.empty())
+        return false;
+
+    value = tensor->data[0];
+
+    for(const T& element : tensor->data)
+        if(element != value)
+            return false;
+
+    return true;
+}
+
+template <class T>
+bool GraphRewriter<T>::same_argument(const Tensor<T>* tensor1, const Tensor<T>* tensor2)
+{
+    /*
+    Every constant has its own tensor, so constants are compared
+    by value.
+    */
+
+    if(tensor1 == tensor2)
+        return true;
+
+    return !tensor1->is_accessible && !tensor2->is_accessible && !tensor1->oper && !tensor2->oper
+        && (tensor1->shape == tensor2->shape) && (tensor1->data == tensor2->data);
+}
+
+template <class T>
+Tensor<T>* GraphRewriter<T>::share(Tensor<T>* tensor)
+{
+    /*
+    An inaccessible tensor is deleted along with the single tensor
+    it produces (see Operation<T>::operand), so a copy is used as
+    the argument of another.
+    */
+
+    if(tensor->is_accessible)
+        return tensor;
+
+    Tensor<T>* copy{ make_constant(tensor->shape, 0) };
+    copy->data = tensor->data;
+    return copy;
+}
+
+template <class T>
+Tensor<T>* GraphRewriter<T>::make_constant(const utils::Shape& shape, const T value)
+{
+    Tensor<T>* out = new Tensor<T>{ shape, value };
+    out->set_accessible_bool(false);
+    return out;
+}
+
+template <class T>
+void GraphRewriter<T>::rewire(Tensor<T>* node, Operation<T>* oper, const std::vector<Tensor<T>*>& args)
+{
+    const std::vector<Tensor<T>*> old_args{ node->parents };
+
+    for(Tensor<T>* arg : args)
+        arg->add_child(node);
+
+    node->parents = args;
+
+    for(Tensor<T>* arg : old_args)
+    {
+        {
+            std::lock_guard<std::mutex> lock{ arg->children_mutex };
+            const auto& iter{ std::find(arg->children.begin(), arg->children.end(), node) };
+
+            if(iter == arg->children.end())
+                throw std::runtime_error("Child tensor not found in parents 'children'.");
+
+            arg->children.erase(iter);
+        }
+
+        arg->sync_memory();
+
+        if(!arg->is_accessible && !arg->has_children())
+            delete arg;
+    }
+
+    if(oper)
+    {
+        delete node->oper;
+        node->oper = oper;
+    }
+
+    node->oper->rebind(node->parents);
+    node->sync_memory();
+}
+
+template <class T>
+void GraphRewriter<T>::replace_uses(Tensor<T>* node, Tensor<T>* replacement, const std::unordered_set<Tensor<T>*>& live)
+{
+    std::vector<Tensor<T>*> consumers{};
+
+    {
+        std::lock_guard<std::mutex> lock{ node->children_mutex };
+
+        for(Tensor<T>* child : node->children)
+            if(child && live.count(child) && std::find(consumers.begin(), consumers.end(), child) == consumers.end())
+                consumers.push_back(child);
+
+        node->children.erase(std::remove_if(node->children.begin(), node->children.end(), [&](Tensor<T>* child)
+        {
+            return std::find(consumers.begin(), consumers.end(), child) != consumers.end();
+        }), node->children.end());
+    }
+
+    for(Tensor<T>* consumer : consumers)
+    {
+        for(Tensor<T>*& parent : consumer->parents)
+            if(parent == node)
+            {
+                parent = replacement;
+                replacement->add_child(consumer);
+            }
+
+        consumer->oper->rebind(consumer->parents);
+    }
+
+    node->sync_memory();
+    node->oper->release_jacobians();
+}
+
+template <class T>
+bool GraphRewriter<T>::fold(Tensor<T>* node)
+{
+    /*
+    (x + a) + b -> x + (a + b) and (x * a) * b -> x * (a * b) for
+    constants a, b, with the constants in either position.
+    */
+
+    const bool is_add{ dynamic_cast<Add<T>*>(node->oper) != nullptr };
+    const bool is_mul{ dynamic_cast<Mul<T>*>(node->oper) != nullptr };
+
+    if(!is_add && !is_mul)
+        return false;
+
+    for(int i = 0; i < 2; ++i)
+    {
+        Tensor<T>* inner{ node->parents[1 - i] };
+        T outer_value{};
+
+        if(!is_constant(node->parents[i], outer_value) || !inner->oper || typeid(*inner->oper) != typeid(*node->oper))
+            continue;
+
+        for(int j = 0; j < 2; ++j)
+        {
+            T inner_value{};
+
+            if(!is_constant(inner->parents[j], inner_value))
+                continue;
+
+            const T value{ is_add ? inner_value + outer_value : inner_value * outer_value };
+            rewire(node, nullptr, { share(inner->parents[1 - j]), make_constant(node->shape, value) });
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <class T>
+bool GraphRewriter<T>::reduce(Tensor<T>* node)
+{
+    if(Pow<T>* pow = dynamic_cast<Pow<T>*>(node->oper))
+    {
+        // x^2 -> x * x
+
+        if(pow->get_power() != 2 || !node->parents[0]->is_accessible)
+            return false;
+
+        rewire(node, new Mul<T>{}, { node->parents[0], node->parents[0] });
+        return true;
+    }
+
+    if(dynamic_cast<Mul<T>*>(node->oper))
+    {
+        /*
+        x * y^-1 -> x / y. For integral types y^-1 truncates, so
+        the two differ.
+        */
+
+        if(!std::is_floating_point<T>::value)
+            return false;
+
+        for(int i = 0; i < 2; ++i)
+        {
+            Tensor<T>* reciprocal{ node->parents[1 - i] };
+            Pow<T>* pow{ reciprocal->oper ? dynamic_cast<Pow<T>*>(reciprocal->oper) : nullptr };
+
+            if(!pow || pow->get_power() != -1)
+                continue;
+
+            rewire(node, new Div<T>{}, { node->parents[i], share(reciprocal->parents[0]) });
+            return true;
+        }
+
+        return false;
+    }
+
+    if(dynamic_cast<Add<T>*>(node->oper))
+    {
+        // x + y * -1 -> x - y
+
+        for(int i = 0; i < 2; ++i)
+        {
+            Tensor<T>* negated{ node->parents[1 - i] };
+
+            if(!negated->oper || !dynamic_cast<Mul<T>*>(negated->oper))
+                continue;
+
+            for(int j = 0; j < 2; ++j)
+            {
+                T value{};
+
+                if(!is_constant(negated->parents[j], value) || value != -1)
+                    continue;
+
+                rewire(node, new Sub<T>{}, { node->parents[i], share(negated->parents[1 - j]) });
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+template <class T>
+Tensor<T>* GraphRewriter<T>::find_equivalent(Tensor<T>* node, const std::vector<Tensor<T>*>& candidates) const
+{
+    const bool commutative{ dynamic_cast<Add<T>*>(node->oper) || dynamic_cast<Mul<T>*>(node->oper) };
+    const std::vector<Tensor<T>*>& args{ node->parents };
+
+    for(Tensor<T>* candidate : candidates)
+    {
+        const std::vector<Tensor<T>*>& other{ candidate->parents };
+
+        if(candidate == node || other.size() != args.size() || !node->oper->equivalent(*candidate->oper))
+            continue;
+
+        bool same{ true };
+
+        for(int i = 0; same && i < static_cast<int>(args.size()); ++i)
+            same = same_argument(args[i], other[i]);
+
+        if(!same && commutative)
+            same = same_argument(args[0], other[1]) && same_argument(args[1], other[0]);
+
+        if(same)
+            return candidate;
+    }
+
+    return nullptr;
+}
+
+template <class T>
+const typename GraphRewriter<T>::Stats& GraphRewriter<T>::run()
+{
+    if(NoGradGuard::enabled())
+        throw std::runtime_error("Cannot rewrite a graph inside a NoGradGuard.");
+
+    stats = Stats{};
+
+    const std::vector<Tensor<T>*> order{ schedule() };
+    const std::unordered_set<Tensor<T>*> live(order.begin(), order.end());
+
+    stats.nodes_before = static_cast<int>(order.size());
+    stats.flops_before = cost(order);
+
+    /*
+    Operations already visited, bucketed by type and the tensors
+    (or constant values) they were applied to.
+    */
+
+    std::unordered_map<std::size_t, std::vector<Tensor<T>*>> visited{};
+
+    for(Tensor<T>* node : order)
+    {
+        stats.folded += fold(node);
+        stats.reduced += reduce(node);
+
+        std::size_t key{ typeid(*node->oper).hash_code() };
+
+        for(const Tensor<T>* arg : node->parents)
+        {
+            T value{};
+            key += is_constant(arg, value) ? std::hash<T>{}(value) : std::hash<const Tensor<T>*>{}(arg);
+        }
+
+        std::vector<Tensor<T>*>& candidates{ visited[key] };
+        Tensor<T>* match{ (node == root) ? nullptr : find_equivalent(node, candidates) };
+
+        if(match)
+        {
+            replace_uses(node, match, live);
+            ++stats.eliminated;
+        }
+        else
+            candidates.push_back(node);
+    }
+
+    const std::vector<Tensor<T>*> new_order{ schedule() };
+
+    stats.nodes_after = static_cast<int>(new_order.size());
+    stats.flops_after = cost(new_order);
+
+    return stats;
+}
+
+template <class T>
+const typename GraphRewriter<T>::Stats& GraphRewriter<T>::statistics() const
+{
+    return stats;
+}
+
+template <class T>
+void GraphRewriter<T>::report(std::ostream& out) const
+{
+    out << "Eliminated: " << stats.eliminated << ", folded: " << stats.folded << ", reduced: " << stats.reduced << '\n'
+        << "Nodes: " << stats.nodes_before << " -> " << stats.nodes_after << " (" << stats.nodes_before - stats.nodes_after << " removed)\n"
+        << "FLOPs: " << stats.flops_before << " -> " << stats.flops_after << " (" << stats.flops_before - stats.flops_after << " removed)\n";
+}
+
+// Template declarations
+
+template class GraphRewriter<int>;
+template class GraphRewriter<double>;
+template class GraphRewriter<long>;
+template class GraphRewriter<long long>;
\ No newline at end of file
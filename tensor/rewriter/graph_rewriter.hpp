@@ -0,0 +1,91 @@
+#ifndef GRAPH_REWRITER_HPP
+#define GRAPH_REWRITER_HPP
+
+template <class T>
+class Tensor;
+
+#include "../tensor.hpp"
+#include <vector>
+#include <unordered_set>
+#include <ostream>
+
+template <class T>
+class GraphRewriter
+{
+public:
+    /*
+    What 'run' did to the graph: operations merged into an
+    equivalent one ('eliminated'), chains of constant additions
+    or multiplications collapsed into one ('folded') and operations
+    replaced by cheaper ones ('reduced'), with the operations and
+    estimated FLOPs (see 'Operation<T>::flops') 'root' depends on
+    before and after.
+    */
+
+    struct Stats
+    {
+        int eliminated{ 0 };
+        int folded{ 0 };
+        int reduced{ 0 };
+
+        int nodes_before{ 0 };
+        int nodes_after{ 0 };
+        long long flops_before{ 0 };
+        long long flops_after{ 0 };
+    };
+
+private:
+    Tensor<T>* root;
+    Stats stats{};
+
+    std::vector<Tensor<T>*> schedule() const;
+    long long cost(const std::vector<Tensor<T>*>& order) const;
+
+    bool fold(Tensor<T>* node);
+    bool reduce(Tensor<T>* node);
+    Tensor<T>* find_equivalent(Tensor<T>* node, const std::vector<Tensor<T>*>& candidates) const;
+
+    /*
+    Rewiring. 'rewire' makes 'node' the result of 'oper' (or of its
+    current operation, if null) applied to 'args', deleting the
+    constants it no longer uses. 'replace_uses' makes the consumers
+    of 'node' in 'live' read 'replacement' instead.
+    */
+
+    void rewire(Tensor<T>* node, Operation<T>* oper, const std::vector<Tensor<T>*>& args);
+    void replace_uses(Tensor<T>* node, Tensor<T>* replacement, const std::unordered_set<Tensor<T>*>& live);
+
+    static bool is_constant(const Tensor<T>* tensor, T& value);
+    static bool same_argument(const Tensor<T>* tensor1, const Tensor<T>* tensor2);
+    static Tensor<T>* share(Tensor<T>* tensor);
+    static Tensor<T>* make_constant(const utils::Shape& shape, const T value);
+
+public:
+    /*
+    Rewrites the graph built up to 'root' in place, so that later
+    calls to 'backprop', a MemoryPlanner or a re-evaluation do less
+    work. Every tensor keeps its values; tensors whose operations
+    are merged away are no longer part of the graph of 'root', so
+    derivatives should be taken wrt. leaves.
+    */
+
+    explicit GraphRewriter(Tensor<T>& root);
+
+    /*
+    Runs, in one pass over the graph (arguments before results):
+    folding of constant chains, e.g. (x * 2) * 3 -> x * 6; strength
+    reduction of x^2 -> x * x, x * y^-1 -> x / y (floating point
+    types) and x + y * -1 -> x - y; and elimination of operations
+    equivalent to an earlier one on the same arguments. Folding
+    reassociates floating point arithmetic, so results may differ
+    from the original graph in the last bits.
+    */
+
+    const Stats& run();
+
+    const Stats& statistics() const;
+
+    void report(std::ostream& out) const;
+};
+
+#endif
\ No newline at end of file
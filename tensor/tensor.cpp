@@ -1,6 +1,7 @@
 #include "tensor.hpp"
 #include "engine/engine.hpp"
 #include "utils/utils.hpp"
+#include "utils/no_grad.hpp"
 #include "operations/operation.hpp"
 #include "operations/unary/subscript/subscript.hpp"
 #include "operations/unary/sum/sum.hpp"
@@ -8,7 +9,9 @@
 #include "operations/unary/pow/pow.hpp"
 #include "operations/unary/exp/exp.hpp"
 #include "operations/unary/log/log.hpp"
+#include "operations/unary/transpose/transpose.hpp"
 #include "operations/binary/matmul/matmul.hpp"
+#include "operations/binary/conv/conv.hpp"
 
 #include <cassert>
 #include <vector>
@@ -16,23 +19,119 @@
 #include <functional>
 #include <stdexcept>
 #include <chrono>
+#include <algorithm>
+#include <unordered_set>
+#include <mutex>
+#include <charconv>
+#include <type_traits>
 
 template <class T>
-Tensor<T>::Tensor(const std::vector<T> data)
-    : data{ data }
-    , shape{ std::vector<int>{ static_cast<int>(data.size()) } }
-    , dim{ static_cast<int>(shape.size()) }
+Tensor<T>::Tensor(std::vector<T> data)
+    : data{ std::move(data) }
+    , shape{ utils::Shape{ static_cast<int>(this->data.size()) } }
+    , dim{ static_cast<int>(this->shape.size()) }
     , is_scalar{ check_if_scalar() }
-{}
+{
+    sync_memory();
+}
 
 template <class T>
-Tensor<T>::Tensor(const std::vector<T> data, const std::vector<int> shape)
-    : data{ data }
-    , shape{ shape }
-    , dim{ static_cast<int>(shape.size()) }
+Tensor<T>::Tensor(std::vector<T> data, utils::Shape shape)
+    : data{ std::move(data) }
+    , shape{ std::move(shape) }
+    , dim{ static_cast<int>(this->shape.size()) }
     , is_scalar{ check_if_scalar() }
 {
-    assert(data.size() == utils::prod(shape));
+    assert(this->data.size() == utils::prod(this->shape));
+    sync_memory();
+}
+
+template <class T>
+Tensor<T>::Tensor(const Tensor<T>& other)
+    : Tensor{ std::vector<T>{} }
+{
+    *this = other;
+}
+
+template <class T>
+Tensor<T>::Tensor(Tensor<T>&& other)
+    : Tensor{ std::vector<T>{} }
+{
+    *this = std::move(other);
+}
+
+template <class T>
+Tensor<T>& Tensor<T>::operator= (const Tensor<T>& other)
+{
+    if(this == &other)
+        return *this;
+
+    if(oper || has_parents() || has_children())
+        throw std::runtime_error("Cannot copy into a tensor that is part of a graph.");
+
+    if(other.is_stale)
+        const_cast<Tensor<T>&>(other).refresh();
+
+    release_grad();
+    clear_tangent();
+
+    data = other.data;
+    shape = other.shape;
+    non_zero_idxs = other.non_zero_idxs;
+    dim = other.dim;
+    is_scalar = other.is_scalar;
+    is_accessible = other.is_accessible;
+    is_donatable = other.is_donatable;
+
+    if(other.grad)
+        grad = new Tensor<T>{ *other.grad };
+
+    if(other.tangent)
+        tangent = new Tensor<T>{ *other.tangent };
+
+    ++version;
+    sync_memory();
+
+    return *this;
+}
+
+template <class T>
+Tensor<T>& Tensor<T>::operator= (Tensor<T>&& other)
+{
+    if(this == &other)
+        return *this;
+
+    if(oper || other.oper || has_parents() || other.has_parents() || has_children() || other.has_children())
+        throw std::runtime_error("Cannot move a tensor that is part of a graph.");
+
+    release_grad();
+    clear_tangent();
+
+    data = std::move(other.data);
+    shape = std::move(other.shape);
+    non_zero_idxs = std::move(other.non_zero_idxs);
+    dim = other.dim;
+    is_scalar = other.is_scalar;
+    is_accessible = other.is_accessible;
+    is_donatable = other.is_donatable;
+
+    grad = other.grad;
+    grad_in_graph = other.grad_in_graph;
+    tangent = other.tangent;
+
+    other.data.clear();
+    other.non_zero_idxs.clear();
+    other.grad = nullptr;
+    other.grad_in_graph = false;
+    other.tangent = nullptr;
+    ++other.version;
+    ++version;
+
+    memory = other.memory;
+    sync_memory();
+    other.sync_memory();
+
+    return *this;
 }
 
 template <class T>
@@ -45,11 +144,9 @@ Tensor<T>::~Tensor()
     if(is_accessible && (has_children() || has_parents()))
         ungraph();
 
-    if(grad)
-    {
-        delete grad;
-        grad = nullptr;
-    }
+    release_grad();
+
+    clear_tangent();
 
     if(oper)
     {
@@ -64,59 +161,275 @@ void Tensor<T>::ungraph()
     /*
     Removes tensor from the computational graph, along with its
     children and any associated inaccessibles.
+
+    The tensors to delete are collected with an explicit stack 
+    and unlinked before being deleted, so that their destructors 
+    do not cascade and the native stack stays shallow however 
+    deep the graph is.
     */
 
-    for(Tensor<T>* parent : parents)
+    std::vector<Tensor<T>*> descendants{};
+    std::unordered_set<Tensor<T>*> removed{ this };
+    std::vector<Tensor<T>*> stack{ this };
+
+    while(!stack.empty())
     {
-        if(!parent->is_accessible)
+        Tensor<T>* tensor{ stack.back() };
+        stack.pop_back();
+
+        for(Tensor<T>* child : tensor->children)
+            if(child && removed.insert(child).second)
+            {
+                descendants.push_back(child);
+                stack.push_back(child);
+            }
+    }
+
+    std::vector<Tensor<T>*> inaccessibles{};
+    std::unordered_set<Tensor<T>*> seen_inaccessibles{};
+
+    for(Tensor<T>* tensor : removed)
+    {
+        for(Tensor<T>* parent : tensor->parents)
         {
-            delete parent;
-            parent = nullptr;
-            continue;
-        }
+            if(!parent || removed.count(parent))
+                continue;
+
+            if(!parent->is_accessible)
+            {
+                if(seen_inaccessibles.insert(parent).second)
+                    inaccessibles.push_back(parent);
 
-        const auto& iter{ std::find(parent->children.begin(), parent->children.end(), this) };
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock{ parent->children_mutex };
+            const auto& iter{ std::find(parent->children.begin(), parent->children.end(), tensor) };
         
-        if(iter != parent->children.end())
-            *iter = nullptr;
-        else
-            throw std::runtime_error("Child tensor not found in parents 'children'.");
+            if(iter != parent->children.end())
+                *iter = nullptr;
+            else
+                throw std::runtime_error("Child tensor not found in parents 'children'.");
+        }
+    }
+
+    for(Tensor<T>* tensor : removed)
+    {
+        tensor->parents.clear();
+        tensor->children.clear();
     }
 
-    parents.clear();
+    for(Tensor<T>* tensor : descendants)
+        delete tensor;
 
-    for(Tensor<T>* child : children)
-        if(child)
-        {
-            delete child;
-            child = nullptr;
-        }
-    
-    children.clear();
+    for(Tensor<T>* tensor : inaccessibles)
+        delete tensor;
 }
 
 template <class T>
-void Tensor<T>::backprop(std::vector<Tensor<T>*> target_tensors, bool squeeze)
+void Tensor<T>::backprop(std::vector<Tensor<T>*> target_tensors, bool squeeze, bool create_graph, bool accumulate)
 {
     /*
     For each target tensor in 'target_tensors', the derivative
     tensor of *this wrt. each target tensor is computed, and 
     stored in the target tensors 'grad' variable.
+
+    With 'accumulate', the derivative is added in place to an 
+    existing 'grad' of the same shape (e.g. over micro-batches), 
+    which is kept until 'zero_grad'. Otherwise an existing 'grad' 
+    is overwritten, reusing its Tensor object.
+
+    With 'create_graph', *this must be a scalar and each 'grad' 
+    is built from graph operations (with the shape of its target), 
+    so that it can be differentiated again. It is owned by the 
+    graph and lives as long as the graph does.
     */
 
-    for(Tensor<T>* target : target_tensors)
+    if(create_graph && NoGradGuard::enabled())
+        throw std::runtime_error("Cannot create a gradient graph inside a NoGradGuard.");
+
+    if(create_graph && accumulate)
+        throw std::runtime_error("Gradient accumulation is not supported with 'create_graph'.");
+
+    if(create_graph)
     {
-        if(target->grad)
+        std::vector<Tensor<T>*> grads{ Engine<T>::grad_graph(this, target_tensors) };
+
+        for(int i = 0; i < static_cast<int>(target_tensors.size()); ++i)
         {
-            delete target->grad;
-            target->grad = nullptr;
+            target_tensors[i]->release_grad();
+            target_tensors[i]->grad = grads[i];
+            target_tensors[i]->grad_in_graph = true;
         }
-        
-        Tensor<T>* result = new Tensor<T>{ Engine<T>::grad(this, target) };
+
+        return;
+    }
+
+    for(Tensor<T>* target : target_tensors)
+    {
+        Tensor<T> result{ Engine<T>::grad(this, target) };
+
         if(squeeze)
-            *result = Tensor<T>::squeeze(*result);
+            result.squeeze_shape();
 
-        target->grad = result;
+        if(target->grad_in_graph)
+            target->release_grad();
+
+        if(!target->grad)
+            target->grad = new Tensor<T>{ std::vector<T>{} };
+
+        else if(accumulate)
+        {
+            Tensor<T>& grad{ *target->grad };
+
+            if(grad.shape != result.shape)
+                throw std::runtime_error("Accumulated gradient shapes do not match.");
+
+            for(int i = 0; i < static_cast<int>(grad.data.size()); ++i)
+                grad.data[i] += result.data[i];
+
+            grad.non_zero_idxs.clear();
+            grad.sync_memory();
+            continue;
+        }
+
+        target->grad->take(result);
+        target->grad->sync_memory();
+    }
+
+    if(Operation<T>::cache_policy() == JacobianCache::Free)
+        Engine<T>::release_jacobians(this);
+}
+
+template <class T>
+void Tensor<T>::zero_grad()
+{
+    /*
+    Zeroes 'grad' in place, keeping its storage for the next 
+    (accumulating) backprop. A graph-owned 'grad' is released.
+    */
+
+    if(grad_in_graph)
+    {
+        release_grad();
+        return;
+    }
+
+    if(grad)
+    {
+        std::fill(grad->data.begin(), grad->data.end(), 0);
+        grad->non_zero_idxs.clear();
+        grad->sync_memory();
+    }
+}
+
+template <class T>
+void Tensor<T>::take(Tensor<T>& other)
+{
+    /*
+    Takes the values of 'other' without copying its data.
+    */
+
+    data.swap(other.data);
+    shape.swap(other.shape);
+    non_zero_idxs.swap(other.non_zero_idxs);
+    dim = other.dim;
+    is_scalar = other.is_scalar;
+    ++version;
+}
+
+template <class T>
+void Tensor<T>::mark_descendants_stale()
+{
+    std::vector<Tensor<T>*> stack{ this };
+
+    while(!stack.empty())
+    {
+        Tensor<T>* tensor{ stack.back() };
+        stack.pop_back();
+
+        std::lock_guard<std::mutex> lock{ tensor->children_mutex };
+
+        for(Tensor<T>* child : tensor->children)
+            if(child && !child->is_stale)
+            {
+                child->is_stale = true;
+                stack.push_back(child);
+            }
+    }
+}
+
+template <class T>
+void Tensor<T>::squeeze_shape()
+{
+    /*
+    In-place version of 'squeeze'. Like 'squeeze', it does not 
+    keep 'non_zero_idxs'.
+    */
+
+    shape.erase(std::remove(shape.begin(), shape.end(), 1), shape.end());
+    dim = static_cast<int>(shape.size());
+    is_scalar = check_if_scalar();
+    non_zero_idxs.clear();
+}
+
+template <class T>
+void Tensor<T>::release_grad()
+{
+    if(grad && !grad_in_graph)
+        delete grad;
+
+    grad = nullptr;
+    grad_in_graph = false;
+}
+
+template <class T>
+void Tensor<T>::seed_tangent(const Tensor<T>& direction)
+{
+    /*
+    Seeds the forward-mode tangent of 'this'. 'direction' is 
+    either a single tangent of the same shape as 'this', or 
+    a batch of tangents of shape (num_tangents, *shape).
+    */
+
+    clear_tangent();
+
+    if(direction.shape == shape)
+        tangent = new Tensor<T>{ direction.data, utils::concat_shapes({ 1 }, shape) };
+
+    else if(utils::Shape(direction.shape.begin() + 1, direction.shape.end()) == shape)
+        tangent = new Tensor<T>{ direction.data, direction.shape };
+
+    else
+        throw std::runtime_error("Tangent shape does not match tensor shape.");
+}
+
+template <class T>
+void Tensor<T>::seed_tangent_basis()
+{
+    /*
+    Seeds one tangent per element of 'this' (the identity), 
+    such that the tangents of any tensor computed from 'this' 
+    hold its full derivative wrt. 'this' (see Engine::forward_grad).
+    */
+
+    const int size{ static_cast<int>(data.size()) };
+    Tensor<T> basis{ utils::concat_shapes({ size }, shape), 0 };
+
+    for(int i = 0; i < size; ++i)
+        basis.data[i*size + i] = 1;
+
+    clear_tangent();
+    tangent = new Tensor<T>{ std::move(basis) };
+}
+
+template <class T>
+void Tensor<T>::clear_tangent()
+{
+    if(tangent)
+    {
+        delete tangent;
+        tangent = nullptr;
     }
 }
 
@@ -133,15 +446,29 @@ Tensor<T> Tensor<T>::squeeze(const Tensor<T>& tensor)
     Removes any dimensions in the shape == 1.
     */
 
-    std::vector<int> shape{ tensor.shape };
+    utils::Shape shape{ tensor.shape };
     shape.erase(std::remove(shape.begin(), shape.end(), 1), shape.end());
-    return Tensor<T>{ tensor.data, shape };
+    return Tensor<T>{ tensor.data, std::move(shape) };
+}
+
+template <class T>
+Tensor<T> Tensor<T>::squeeze(Tensor<T>&& tensor)
+{
+    /*
+    Squeezes a temporary in place rather than copying its values.
+    */
+
+    Tensor<T> out{ std::move(tensor) };
+    out.squeeze_shape();
+    return out;
 }
 
 template <class T>
 void Tensor<T>::add_child(Tensor<T>* child)
 {
+    std::lock_guard<std::mutex> lock{ children_mutex };
     this->children.push_back(child);
+    sync_memory();
 }
 
 template <class T>
@@ -151,49 +478,43 @@ Tensor<T>& Tensor<T>::sum()
     Reduces a tensor to a tensor of shape (1) by summation.
     */
 
-    Sum<T>* oper = new Sum<T>();
-    return oper->forward(*this);
+    return apply<Sum<T>>({ this });
 }
 
 template <class T>
 Tensor<T>& Tensor<T>::pow(const T power)
 {
-    Pow<T>* oper = new Pow<T>(power);
-    return oper->forward(*this);
+    return apply<Pow<T>>({ this }, power);
 }
 
 template <class T>
 Tensor<T>& Tensor<T>::exp(const T base)
 {
-    Exp<T>* oper = new Exp<T>(base);
-    return oper->forward(*this);
+    return apply<Exp<T>>({ this }, base);
 }
 
 template <class T>
 Tensor<T>& Tensor<T>::log(const T base)
 {
-    Log<T>* oper = new Log<T>(base);
-    return oper->forward(*this);
+    return apply<Log<T>>({ this }, base);
 }
 
 template <class T>
-Tensor<T>& Tensor<T>::index(const std::vector<int>& idx)
+Tensor<T>& Tensor<T>::index(const utils::Shape& idx)
 {
-    Subscript<T>* oper = new Subscript<T>(idx);
-    return oper->forward(*this);
+    return apply<Subscript<T>>({ this }, idx);
 }
 
 
 template <class T>
-Tensor<T>& Tensor<T>::broadcast(const std::vector<int>& new_shape)
+Tensor<T>& Tensor<T>::broadcast(const utils::Shape& new_shape)
 {
     /*
     Expands a scalar tensor '*this' of shape (1) to a larger tensor 
     filled with 'this->item()' of shape 'new_shape'.
     */
 
-    Broadcast<T>* oper = new Broadcast<T>{ new_shape };
-    return oper->forward(*this);
+    return apply<Broadcast<T>>({ this }, new_shape);
 }
 
 
@@ -240,6 +561,8 @@ bool Tensor<T>::has_children() const
     Does the tensor have any non-null children?
     */
 
+    std::lock_guard<std::mutex> lock{ children_mutex };
+
     for(const Tensor<T>* child : children)
         if(child)
             return true;
@@ -248,18 +571,32 @@ bool Tensor<T>::has_children() const
 }
 
 template <class T>
-void Tensor<T>::modify(std::function<void(Tensor<T>&, const std::vector<int>&)> modifier, const std::vector<int>& iter_shape)
+void Tensor<T>::modify(std::function<void(Tensor<T>&, const utils::Shape&)> modifier, const utils::Shape& iter_shape)
 {
     /*
     Performs index-wise modification of a tensor, 
     where 'modifier' defines the modification to be done, 
-    and 'iter_shape' the index space to iterate over.
+    and 'iter_shape' the index space to iterate over. 
+    The whole modification counts as one write.
     */
 
-    std::vector<std::vector<int>> idxs_set{ utils::total_idxs(iter_shape) };
+    std::vector<utils::Shape> idxs_set{ utils::total_idxs(iter_shape) };
+    is_modifying = true;
 
-    for(std::vector<int> idx : idxs_set)
-        modifier(*this, idx);
+    try
+    {
+        for(utils::Shape idx : idxs_set)
+            modifier(*this, idx);
+    }
+    catch(...)
+    {
+        is_modifying = false;
+        touch();
+        throw;
+    }
+
+    is_modifying = false;
+    touch();
 }
 
 template <class T>
@@ -270,6 +607,132 @@ void Tensor<T>::set_grad_info(std::vector<Tensor<T>*> parents, Operation<T>* ope
 
     this->parents = parents;
     this->oper = oper;
+    sync_memory();
+}
+
+template <class T>
+void Tensor<T>::sync_memory()
+{
+    /*
+    Every index in 'non_zero_idxs' has the same length, so 
+    whether they spilled to the heap is read from the first.
+    */
+
+    MemoryUsage usage{};
+    usage.data = static_cast<long long>(data.capacity() * sizeof(T));
+    usage.indices = static_cast<long long>(non_zero_idxs.capacity() * sizeof(utils::Shape));
+
+    if(!non_zero_idxs.empty() && !non_zero_idxs[0].is_inline())
+        usage.indices += static_cast<long long>(non_zero_idxs.size() * non_zero_idxs[0].capacity() * sizeof(int));
+
+    usage.metadata = static_cast<long long>(sizeof(Tensor<T>)
+        + (parents.capacity() + children.capacity()) * sizeof(Tensor<T>*));
+
+    if(!shape.is_inline())
+        usage.metadata += static_cast<long long>(shape.capacity() * sizeof(int));
+
+    if(oper)
+        usage.metadata += static_cast<long long>(sizeof(Operation<T>));
+
+    memory.record(usage);
+}
+
+template <class T>
+MemoryUsage Tensor<T>::memory_usage() const
+{
+    /*
+    Walks the graph through both parents and children, so the 
+    result is the same from any of its tensors.
+    */
+
+    MemoryUsage usage{};
+    std::unordered_set<const Tensor<T>*> visited{ this };
+    std::vector<const Tensor<T>*> stack{ this };
+
+    while(!stack.empty())
+    {
+        const Tensor<T>* tensor{ stack.back() };
+        stack.pop_back();
+
+        usage += tensor->memory.usage();
+
+        if(tensor->grad && !tensor->grad_in_graph)
+            usage += tensor->grad->memory.usage();
+
+        if(tensor->tangent)
+            usage += tensor->tangent->memory.usage();
+
+        if(tensor->oper)
+            usage += tensor->oper->memory_usage();
+
+        std::vector<const Tensor<T>*> neighbours(tensor->parents.begin(), tensor->parents.end());
+
+        {
+            std::lock_guard<std::mutex> lock{ tensor->children_mutex };
+            neighbours.insert(neighbours.end(), tensor->children.begin(), tensor->children.end());
+        }
+
+        for(const Tensor<T>* neighbour : neighbours)
+            if(neighbour && visited.insert(neighbour).second)
+                stack.push_back(neighbour);
+    }
+
+    return usage;
+}
+
+template <class T>
+int Tensor<T>::refresh()
+{
+    /*
+    Visits every tensor 'this' depends on rather than stopping 
+    at up-to-date ones, as the root replayed by a CompiledGraph 
+    is up to date while its arguments may not be. Each stale tensor is evaluated without recording a graph 
+    and takes the result's values, so operations reading it see 
+    a new version and recompute their cached Jacobians.
+    */
+
+    if(!oper)
+        return 0;
+
+    std::vector<Tensor<T>*> order{};
+    std::unordered_set<Tensor<T>*> visited{ this };
+    std::vector<std::pair<Tensor<T>*, int>> stack{ { this, 0 } };
+
+    while(!stack.empty())
+    {
+        auto& [tensor, next] = stack.back();
+
+        if(next < static_cast<int>(tensor->parents.size()))
+        {
+            Tensor<T>* parent{ tensor->parents[next++] };
+
+            if(parent->oper && visited.insert(parent).second)
+                stack.emplace_back(parent, 0);
+
+            continue;
+        }
+
+        if(tensor->is_stale)
+            order.push_back(tensor);
+
+        stack.pop_back();
+    }
+
+    for(Tensor<T>* tensor : order)
+    {
+        for(const Tensor<T>* arg : tensor->parents)
+            if(arg->data.size() != static_cast<std::size_t>(utils::prod(arg->shape)))
+                throw std::runtime_error("Cannot recompute a tensor whose arguments have been released.");
+
+        NoGradGuard guard{};
+        Tensor<T>& result{ tensor->oper->evaluate(tensor->parents) };
+
+        tensor->take(result);
+        tensor->is_stale = false;
+        tensor->sync_memory();
+    }
+
+    return static_cast<int>(order.size());
 }
 
 template <class T>
@@ -282,14 +745,49 @@ template <class T>
 T Tensor<T>::item() const
 {
     assert(is_scalar);
+
+    if(is_stale)
+        const_cast<Tensor<T>*>(this)->refresh();
+
     return this->data[0];    
 }
 
 template <class T>
 Tensor<T>& Tensor<T>::matmul(Tensor<T>& other_tensor)
 {
-    MatMul<T>* oper = new MatMul<T>();
-    return oper->forward(*this, other_tensor);
+    return apply<MatMul<T>>({ this, &other_tensor });
+}
+
+template <class T>
+Tensor<T>& Tensor<T>::conv1d(Tensor<T>& weight, const int stride, const int padding, const int dilation)
+{
+    /*
+    1d convolution of an input of shape (batch, in_channels, length) 
+    with a weight of shape (out_channels, in_channels, kernel).
+    */
+
+    return apply<Conv1d<T>>({ this, &weight }, stride, padding, dilation);
+}
+
+template <class T>
+Tensor<T>& Tensor<T>::conv2d(Tensor<T>& weight, const std::vector<int>& stride, const std::vector<int>& padding, const std::vector<int>& dilation)
+{
+    /*
+    2d convolution of an input of shape (batch, in_channels, height, width) 
+    with a weight of shape (out_channels, in_channels, kernel_h, kernel_w).
+    */
+
+    return apply<Conv2d<T>>({ this, &weight }, stride, padding, dilation);
+}
+
+template <class T>
+Tensor<T>& Tensor<T>::transpose()
+{
+    /*
+    Transpose of a 2d tensor.
+    */
+
+    return apply<Transpose<T>>({ this });
 }
 
 template <class T>
@@ -303,6 +801,113 @@ Tensor<T>& Tensor<T>::operator- ()
 }
 
 
+template <class T>
+void Tensor<T>::print(std::ostream& out, const utils::PrintOptions& options) const
+{
+    /*
+    Writes the tensor as nested brackets, one innermost row per 
+    line. The data is walked in row-major order with an odometer 
+    over the (possibly summarized) indices of each dimension, and 
+    values are formatted with std::to_chars into a buffer that is 
+    flushed to 'out' in blocks.
+    */
+
+    if(is_stale)
+        const_cast<Tensor<T>*>(this)->refresh();
+
+    std::string buffer{ "Tensor" };
+    char number[512];
+
+    const auto write_value = [&](const T value)
+    {
+        std::to_chars_result result{};
+
+        if constexpr(std::is_floating_point<T>::value)
+        {
+            result = std::to_chars(number, number + sizeof(number), value, std::chars_format::fixed, options.precision);
+
+            if(result.ec != std::errc{})
+                result = std::to_chars(number, number + sizeof(number), value, std::chars_format::scientific, options.precision);
+        }
+        else
+            result = std::to_chars(number, number + sizeof(number), value);
+
+        buffer.append(number, result.ptr);
+        buffer += ' ';
+
+        if(buffer.size() >= 65536)
+        {
+            out.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    };
+
+    if(dim == 0 || data.empty())
+    {
+        if(!data.empty())
+            write_value(data[0]);
+
+        out.write(buffer.data(), buffer.size());
+        return;
+    }
+
+    const bool summarize{ static_cast<int>(data.size()) > options.threshold };
+    std::vector<std::vector<int>> visits(dim);
+    std::vector<int> strides(dim, 1);
+
+    for(int d = dim - 1; d >= 0; --d)
+    {
+        if(d < dim - 1)
+            strides[d] = strides[d + 1] * shape[d + 1];
+
+        const int edge{ std::max(1, options.edge_items) };
+
+        for(int i = 0; i < shape[d]; ++i)
+            if(!summarize || shape[d] <= 2 * edge || i < edge || i >= shape[d] - edge)
+                visits[d].push_back(i);
+    }
+
+    utils::Shape position(dim, 0);
+    int offset{ 0 };
+
+    for(int d = 0; d < dim; ++d)
+        buffer += "[ ";
+
+    while(true)
+    {
+        write_value(data[offset]);
+
+        int d{ dim - 1 };
+
+        for(; d >= 0; --d)
+        {
+            const int previous{ visits[d][position[d]] };
+
+            if(++position[d] < static_cast<int>(visits[d].size()))
+            {
+                offset += (visits[d][position[d]] - previous) * strides[d];
+
+                if(visits[d][position[d]] > previous + 1)
+                    buffer += (d == dim - 1) ? "... " : "... \n";
+
+                break;
+            }
+
+            offset -= previous * strides[d];
+            position[d] = 0;
+            buffer += (d == dim - 1) ? "] \n" : "] ";
+        }
+
+        if(d < 0)
+            break;
+
+        for(int open = d + 1; open < dim; ++open)
+            buffer += "[ ";
+    }
+
+    out.write(buffer.data(), buffer.size());
+}
+
 // Template declarations
 
 template class Tensor<int>;
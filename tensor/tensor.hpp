@@ -10,17 +10,47 @@ class Subscript;
 template <class T>
 class Sum;
 
+template <class T>
+class Conv;
+
 template <class T>
 class Engine;
 
+template <class T>
+class Optimizer;
+
+template <class T>
+class Checkpoint;
+
+template <class T>
+class DataLoader;
+
+template <class T>
+class MemoryPlanner;
+
+template <class T>
+class GraphRewriter;
+
+template <class T>
+class CodeGenerator;
+
+template <class T>
+class CompiledGraph;
+
+#include "utils/shape.hpp"
 #include "operations/operation.hpp"
 #include "operations/unary/subscript/subscript.hpp"
 #include "operations/unary/sum/sum.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/utils.hpp"
+#include "utils/memory.hpp"
 #include <iostream>
 #include <vector>
 #include <functional>
 #include <initializer_list>
 #include <cmath>
+#include <utility>
+#include <type_traits>
 
 template <class T>
 class Tensor
@@ -50,50 +80,180 @@ private:
 
     'oper' is the operation that was applied to 'parents' to 
     create 'this'.
+
+    A tensor (e.g. a weight) may be shared by graphs built on 
+    different threads, so 'children' is guarded by its own mutex.
+    'parents' and 'oper' are only written while building 'this'.
     */
 
     std::vector<Tensor<T>*> parents;
     std::vector<Tensor<T>*> children;
+    mutable CopyableMutex children_mutex;
     Operation<T>* oper = nullptr;
 
+    /*
+    With 'backprop(..., create_graph = true)', 'grad' points to a 
+    node of the computational graph, which is owned by the graph 
+    rather than by 'this'.
+    */
+
+    bool grad_in_graph{ false };
+
+    /*
+    Result of an operation evaluated under a donating NoGradGuard, 
+    whose storage may be taken over by the elementwise operation 
+    it is next passed to (as may that of inaccessible constants).
+    */
+
+    bool is_donatable{ false };
+
+    /*
+    Usage last recorded with the process-wide MemoryTracker.
+    */
+
+    MemoryAccount memory;
+
+    /*
+    Incremented whenever the values of 'this' may have been written 
+    (non-const element access, or an optimizer, data loader or 
+    checkpoint writing them), so that operations can tell whether 
+    their cached Jacobians are still valid.
+    */
+
+    unsigned long long version{ 0 };
+
+    /*
+    Set when a tensor 'this' is computed from has been written 
+    since 'this' was computed. Its values are then recomputed 
+    (see 'refresh') before they are next read. A stale tensor's 
+    children are stale too, so marking stops at stale tensors.
+    */
+
+    bool is_stale{ false };
+
+    /*
+    Set while 'modify' runs, so that the element writes of its 
+    modifier count as a single write of 'this'.
+    */
+
+    bool is_modifying{ false };
+
+    void release_grad();
+
+    /*
+    Records a write to the values of 'this': increments 'version' 
+    and marks the tensors computed from 'this' stale.
+    */
+
+    void touch();
+
+    void mark_descendants_stale();
+
+    void take(Tensor<T>& other);
+
+    void squeeze_shape();
+
     bool check_if_scalar() const;
 
     void add_child(Tensor<T>* child);
 
     void set_accessible_bool(bool is_accessible);
 
-    Tensor<T>& broadcast(const std::vector<int>& new_shape);
+    Tensor<T>& broadcast(const utils::Shape& new_shape);
 
     static std::vector<Tensor<T>*> try_broadcast(Tensor<T>& tensor1, Tensor<T>& tensor2);
 
+    /*
+    Applies the operation 'Op' (constructed from 'op_args') to 
+    'args', recording it in the graph unless a NoGradGuard is 
+    alive, in which case the operation lives on the stack.
+    */
+
+    template <class Op, class... Args>
+    static Tensor<T>& apply(std::vector<Tensor<T>*> args, const Args&... op_args);
+
+    template <class U>
+    static Tensor<T>& constant(const utils::Shape& shape, const U value);
+
 public:
+    /*
+    Returned by non-const element access. Reads convert it to a 
+    'T' without side effects, while assignments write through to 
+    the element and record the write (see 'touch'), so reading 
+    through a non-const tensor does not make its descendants 
+    stale or its cached Jacobians invalid.
+    */
+
+    class Element
+    {
+    private:
+        Tensor<T>& tensor;
+        T& value;
+
+    public:
+        Element(Tensor<T>& tensor, T& value);
+
+        operator T() const;
+
+        Element& operator= (const Element& other);
+        Element& operator= (const T other);
+        Element& operator+= (const T other);
+        Element& operator-= (const T other);
+        Element& operator*= (const T other);
+        Element& operator/= (const T other);
+    };
+
     // Public variables
 
-    std::vector<int> shape;
+    utils::Shape shape;
     int dim;
     bool is_scalar;
 
     Tensor<T>* grad = nullptr;
 
-    std::vector<std::vector<int>> non_zero_idxs{};
+    /*
+    Forward-mode tangents of shape (num_tangents, *shape), 
+    propagated through every operation applied to 'this' 
+    once seeded. Null tangents are treated as zero.
+    */
+
+    Tensor<T>* tangent = nullptr;
+
+    std::vector<utils::Shape> non_zero_idxs{};
 
     // Constructors and destructor
 
     Tensor();
-    Tensor(const std::vector<T> data);
-    Tensor(const std::vector<T> data, const std::vector<int> shape);
+    Tensor(std::vector<T> data);
+    Tensor(std::vector<T> data, utils::Shape shape);
 
     template <class U>
     Tensor(const std::vector<std::vector<U>>& data);
 
-    template <class U>
-    Tensor(const std::vector<int> shape, const U value);
+    template <class U, class = std::enable_if_t<std::is_arithmetic<U>::value>>
+    Tensor(utils::Shape shape, const U value);
+
+    /*
+    A copy takes the values of a tensor and its own clones of its 
+    grad and tangent, but not its place in a graph: it is a new 
+    leaf. Moving steals the values, grad and tangent of a tensor 
+    that is not part of a graph (e.g. a derivative or Jacobian), 
+    leaving it empty. Copying or moving into a graph node, or 
+    moving a graph node, throws, since its parents and children 
+    point to it.
+    */
+
+    Tensor(const Tensor<T>& other);
+    Tensor(Tensor<T>&& other);
+
+    Tensor<T>& operator= (const Tensor<T>& other);
+    Tensor<T>& operator= (Tensor<T>&& other);
 
     ~Tensor();
 
     //
 
-    void modify(std::function<void(Tensor<T>&, const std::vector<int>&)> modifier, const std::vector<int>& iter_shape);
+    void modify(std::function<void(Tensor<T>&, const utils::Shape&)> modifier, const utils::Shape& iter_shape);
     
     template <class Container>
     int flatten_index(const Container& indices) const;
@@ -102,22 +262,55 @@ public:
     static std::vector<T> flatten(const std::vector<std::vector<U>>& data);
 
     template <class U>
-    static std::vector<int> calc_shape(const std::vector<std::vector<U>>& data);
+    static utils::Shape calc_shape(const std::vector<std::vector<U>>& data);
 
     static Tensor<T> squeeze(const Tensor<T>& tensor);
+    static Tensor<T> squeeze(Tensor<T>&& tensor);
+
+    void backprop(std::vector<Tensor<T>*> target_tensors, bool squeeze = true, bool create_graph = false, bool accumulate = false);
 
-    void backprop(std::vector<Tensor<T>*> target_tensors, bool squeeze = true);
+    void zero_grad();
 
     void ungraph();
 
+    void seed_tangent(const Tensor<T>& direction);
+
+    void seed_tangent_basis();
+
+    void clear_tangent();
+
     void set_grad_info(std::vector<Tensor<T>*> parents, Operation<T>* op);
     
     bool has_parents() const;
 
     bool has_children() const;
 
+    /*
+    'sync_memory' records the current size of 'this' with the 
+    MemoryTracker. 'memory_usage' sums the usage of the graph 
+    containing 'this' (every tensor connected to it, their grads 
+    and tangents, and the Jacobians cached by their operations).
+    */
+
+    void sync_memory();
+
+    MemoryUsage memory_usage() const;
+
+    /*
+    Recomputes 'this' and the stale tensors it depends on, 
+    arguments first, from the current values of the leaves, and 
+    returns how many were recomputed. Tensors are refreshed when 
+    read (element access, 'item', printing), used as an argument 
+    or differentiated, so this only needs calling to choose when 
+    the work is done. Tangents are not recomputed.
+    */
+
+    int refresh();
+
     T item() const;
 
+    void print(std::ostream& out, const utils::PrintOptions& options) const;
+
     // Custom operations
 
     Tensor<T>& sum();
@@ -128,19 +321,28 @@ public:
 
     Tensor<T>& log(const T base = std::exp(1.0));
 
-    Tensor<T>& index(const std::vector<int>& idx);
+    Tensor<T>& index(const utils::Shape& idx);
 
     Tensor<T>& matmul(Tensor<T>& other_tensor);
 
+    Tensor<T>& transpose();
+
+    Tensor<T>& conv1d(Tensor<T>& weight, const int stride = 1, const int padding = 0, const int dilation = 1);
+
+    Tensor<T>& conv2d(Tensor<T>& weight, const std::vector<int>& stride = { 1, 1 }, const std::vector<int>& padding = { 0, 0 }, const std::vector<int>& dilation = { 1, 1 });
+
 
     
     // Operator overloads
 
     template <class... A>
-    T& operator() (A... args);
+    Element operator() (A... args);
+
+    template <class... A>
+    const T operator() (A... args) const;
 
     template <class Container>
-    T& operator() (const Container& indices);
+    Element operator() (const Container& indices);
 
     template <class Container>
     const T operator() (const Container& indices) const;
@@ -194,7 +396,27 @@ public:
     
     friend class Sum<T>;
 
+    friend class Conv<T>;
+
     friend class Engine<T>;
+
+    friend class Operation<T>;
+
+    friend class Optimizer<T>;
+
+    friend class Checkpoint<T>;
+
+    friend class DataLoader<T>;
+
+    friend class MemoryPlanner<T>;
+
+    friend class GraphRewriter<T>;
+
+    friend class CodeGenerator<T>;
+
+    friend class CompiledGraph<T>;
+
+    friend class NoGradGuard;
 };
 
 
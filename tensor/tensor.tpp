@@ -7,11 +7,21 @@ class Add;
 template <class T>
 class Mul;
 
+template <class T>
+class Sub;
+
+template <class T>
+class Div;
+
 #include "tensor.hpp"
 #include "utils/utils.hpp"
+#include "utils/no_grad.hpp"
 #include "operations/binary/add/add.hpp"
 #include "operations/binary/mul/mul.hpp"
+#include "operations/binary/sub/sub.hpp"
+#include "operations/binary/div/div.hpp"
 #include <cassert>
+#include <mutex>
 #include <string>
 
 
@@ -22,20 +32,19 @@ Tensor<T>::Tensor(const std::vector<std::vector<U>>& data)
     , shape{ calc_shape(data) }
     , dim{ static_cast<int>(shape.size()) }
     , is_scalar{ check_if_scalar() }
-{}
+{
+    sync_memory();
+}
 
 template <class T>
-template <class U>
-Tensor<T>::Tensor(const std::vector<int> shape, const U value)
-    : shape{ shape }
-    , dim{ static_cast<int>(shape.size()) }
+template <class U, class>
+Tensor<T>::Tensor(utils::Shape shape, const U value)
+    : data(utils::prod(shape), static_cast<T>(value))
+    , shape{ std::move(shape) }
+    , dim{ static_cast<int>(this->shape.size()) }
     , is_scalar{ check_if_scalar() }
 {
-    T casted_value{ static_cast<T>(value) };
-    int num_values{ utils::prod(shape) };
-    const std::vector<T> data(num_values, casted_value);
-
-    this->data = data;
+    sync_memory();
 }
 
 
@@ -75,9 +84,9 @@ std::vector<T> Tensor<T>::flatten(const std::vector<std::vector<U>>& data)
 
 template <class T>
 template <class U>
-std::vector<int> Tensor<T>::calc_shape(const std::vector<std::vector<U>>& data)
+utils::Shape Tensor<T>::calc_shape(const std::vector<std::vector<U>>& data)
 {
-    std::vector<int> shape{};
+    utils::Shape shape{};
     utils::calc_shape(data, shape);
     return shape;
 }
@@ -87,23 +96,110 @@ std::vector<int> Tensor<T>::calc_shape(const std::vector<std::vector<U>>& data)
 
 template <class T>
 template <class Container>
-T& Tensor<T>::operator() (const Container& indices)
+typename Tensor<T>::Element Tensor<T>::operator() (const Container& indices)
 {
-    return this->data[ flatten_index(indices) ];
+    if(is_stale)
+        refresh();
+
+    return Element{ *this, this->data[ flatten_index(indices) ] };
 }
 
 template <class T>
 template <class Container>
 const T Tensor<T>::operator() (const Container& indices) const
 {
+    if(is_stale)
+        const_cast<Tensor<T>*>(this)->refresh();
+
     return this->data[ flatten_index(indices) ];
 }
 
+template <class T>
+Tensor<T>::Element::Element(Tensor<T>& tensor, T& value)
+    : tensor{ tensor }, value{ value }
+{
+}
+
+template <class T>
+Tensor<T>::Element::operator T() const
+{
+    return value;
+}
+
+template <class T>
+typename Tensor<T>::Element& Tensor<T>::Element::operator= (const Element& other)
+{
+    return *this = static_cast<T>(other);
+}
+
+template <class T>
+typename Tensor<T>::Element& Tensor<T>::Element::operator= (const T other)
+{
+    if(!tensor.is_modifying)
+        tensor.touch();
+
+    value = other;
+    return *this;
+}
+
+template <class T>
+typename Tensor<T>::Element& Tensor<T>::Element::operator+= (const T other)
+{
+    return *this = value + other;
+}
+
+template <class T>
+typename Tensor<T>::Element& Tensor<T>::Element::operator-= (const T other)
+{
+    return *this = value - other;
+}
+
+template <class T>
+typename Tensor<T>::Element& Tensor<T>::Element::operator*= (const T other)
+{
+    return *this = value * other;
+}
+
+template <class T>
+typename Tensor<T>::Element& Tensor<T>::Element::operator/= (const T other)
+{
+    return *this = value / other;
+}
+
+template <class T>
+void Tensor<T>::touch()
+{
+    /*
+    Defined here so that element writes stay inline. Children 
+    may be added by another thread building a graph on 'this', 
+    so they are read under its lock.
+    */
+
+    ++version;
+
+    bool has_children{ false };
+
+    {
+        std::lock_guard<std::mutex> lock{ children_mutex };
+        has_children = !children.empty();
+    }
+
+    if(has_children)
+        mark_descendants_stale();
+}
+
+template <class T>
+template <class... A>
+typename Tensor<T>::Element Tensor<T>::operator() (A... indices)
+{
+    return (*this)(utils::Shape{ indices... });
+}
+
 template <class T>
 template <class... A>
-T& Tensor<T>::operator() (A... indices)
+const T Tensor<T>::operator() (A... indices) const
 {
-    return (*this)(std::vector<int>{ indices... });
+    return (*this)(utils::Shape{ indices... });
 }
 
 
@@ -112,12 +208,47 @@ T& Tensor<T>::operator() (A... indices)
 template <class U>
 std::ostream& operator<< (std::ostream& out, const Tensor<U>& tensor)
 {
-    std::string out_str{};
-    utils::build_str(tensor, out_str);
-    return (out << "Tensor" << out_str);
+    tensor.print(out, utils::print_options());
+    return out;
+}
+
+
+
+template <class T>
+template <class Op, class... Args>
+Tensor<T>& Tensor<T>::apply(std::vector<Tensor<T>*> args, const Args&... op_args)
+{
+    for(Tensor<T>* arg : args)
+        if(arg->is_stale)
+            arg->refresh();
+
+    if(NoGradGuard::enabled())
+    {
+        Op oper(op_args...);
+        return oper.evaluate(args);
+    }
+
+    Op* oper = new Op(op_args...);
+    return oper->forward(args);
 }
 
+template <class T>
+template <class U>
+Tensor<T>& Tensor<T>::constant(const utils::Shape& shape, const U value)
+{
+    /*
+    Inaccessible constant operand, owned by its child in the 
+    graph or by the active NoGradGuard.
+    */
+
+    Tensor<T>* value_tensor = new Tensor<T>{ shape, value };
+    value_tensor->set_accessible_bool(false);
+
+    if(NoGradGuard::enabled())
+        NoGradGuard::adopt(value_tensor);
 
+    return *value_tensor;
+}
 
 template <class T>
 Tensor<T>& operator+ (Tensor<T>& tensor1, Tensor<T>& tensor2)
@@ -126,17 +257,13 @@ Tensor<T>& operator+ (Tensor<T>& tensor1, Tensor<T>& tensor2)
     Elementwise tensor addition.
     */
 
-    Add<T>* oper = new Add<T>();
-    return oper->forward( Tensor<T>::try_broadcast(tensor1, tensor2) );
+    return Tensor<T>::template apply<Add<T>>( Tensor<T>::try_broadcast(tensor1, tensor2) );
 }
 
 template <class T, class U>
 Tensor<T>& operator+ (Tensor<T>& tensor, const U value)
 {
-    Tensor<T>* value_tensor = new Tensor<T>{ tensor.shape, value };
-    value_tensor->set_accessible_bool(false);
-
-    return tensor + (*value_tensor);
+    return tensor + Tensor<T>::constant(tensor.shape, value);
 }
 
 template <class T, class U>
@@ -155,7 +282,7 @@ Tensor<T>& operator- (Tensor<T>& tensor1, Tensor<T>& tensor2)
     Elementwise tensor subtraction.
     */
 
-    return tensor1 + (-tensor2);
+    return Tensor<T>::template apply<Sub<T>>( Tensor<T>::try_broadcast(tensor1, tensor2) );
 }
 
 template <class T, class U>
@@ -167,7 +294,7 @@ Tensor<T>& operator- (Tensor<T>& tensor, const U value)
 template <class T, class U>
 Tensor<T>& operator- (const U value, Tensor<T>& tensor)
 {
-    return value + (-tensor);
+    return Tensor<T>::constant(tensor.shape, value) - tensor;
 }
 
 
@@ -180,17 +307,13 @@ Tensor<T>& operator* (Tensor<T>& tensor1, Tensor<T>& tensor2)
     Elementwise tensor multiplication.
     */
 
-    Mul<T>* oper = new Mul<T>();
-    return oper->forward( Tensor<T>::try_broadcast(tensor1, tensor2) );
+    return Tensor<T>::template apply<Mul<T>>( Tensor<T>::try_broadcast(tensor1, tensor2) );
 }
 
 template <class T, class U>
 Tensor<T>& operator* (Tensor<T>& tensor, const U value)
 {
-    Tensor<T>* value_tensor = new Tensor<T>{ tensor.shape, value };
-    value_tensor->set_accessible_bool(false);
-
-    return tensor * (*value_tensor);
+    return tensor * Tensor<T>::constant(tensor.shape, value);
 }
 
 template <class T, class U>
@@ -210,7 +333,7 @@ Tensor<T>& operator/ (Tensor<T>& tensor1, Tensor<T>& tensor2)
     Elementwise tensor division.
     */
 
-    return tensor1 * tensor2.pow(-1);
+    return Tensor<T>::template apply<Div<T>>( Tensor<T>::try_broadcast(tensor1, tensor2) );
 }
 
 template <class T, class U>
@@ -222,7 +345,7 @@ Tensor<T>& operator/ (Tensor<T>& tensor, const U value)
 template <class T, class U>
 Tensor<T>& operator/ (const U value, Tensor<T>& tensor)
 {
-    return value * tensor.pow(-1);
+    return Tensor<T>::constant(tensor.shape, value) / tensor;
 }
 
 
@@ -0,0 +1,231 @@
+#include "memory.hpp"
+#include <iostream>
+#include <mutex>
+#include <cstdlib>
+
+long long MemoryUsage::total() const
+{
+    return data + jacobians + indices + metadata;
+}
+
+MemoryUsage& MemoryUsage::operator+= (const MemoryUsage& other)
+{
+    data += other.data;
+    jacobians += other.jacobians;
+    indices += other.indices;
+    metadata += other.metadata;
+    return *this;
+}
+
+MemoryUsage& MemoryUsage::operator-= (const MemoryUsage& other)
+{
+    data -= other.data;
+    jacobians -= other.jacobians;
+    indices -= other.indices;
+    metadata -= other.metadata;
+    return *this;
+}
+
+std::ostream& operator<< (std::ostream& out, const MemoryUsage& usage)
+{
+    return out << "data " << usage.data << " B, jacobians " << usage.jacobians
+               << " B, indices " << usage.indices << " B, metadata " << usage.metadata
+               << " B, total " << usage.total() << " B";
+}
+
+std::atomic<long long> MemoryTracker::current_bytes[4]{};
+std::atomic<long long> MemoryTracker::peak_bytes[4]{};
+std::atomic<long long> MemoryTracker::current_total{ 0 };
+std::atomic<long long> MemoryTracker::peak_total{ 0 };
+std::atomic<long long> MemoryTracker::tensors{ 0 };
+
+void MemoryTracker::raise(std::atomic<long long>& peak, const long long value)
+{
+    long long previous{ peak.load(std::memory_order_relaxed) };
+
+    while(value > previous && !peak.compare_exchange_weak(previous, value, std::memory_order_relaxed));
+}
+
+void MemoryTracker::add(const MemoryUsage& delta)
+{
+    const long long deltas[4]{ delta.data, delta.jacobians, delta.indices, delta.metadata };
+
+    for(int i = 0; i < 4; ++i)
+    {
+        if(deltas[i] == 0)
+            continue;
+
+        const long long value{ current_bytes[i].fetch_add(deltas[i], std::memory_order_relaxed) + deltas[i] };
+
+        if(deltas[i] > 0)
+            raise(peak_bytes[i], value);
+    }
+
+    const long long total{ delta.total() };
+
+    if(total == 0)
+        return;
+
+    const long long value{ current_total.fetch_add(total, std::memory_order_relaxed) + total };
+
+    if(total > 0)
+        raise(peak_total, value);
+}
+
+void MemoryTracker::add_tensors(const long long count)
+{
+    tensors.fetch_add(count, std::memory_order_relaxed);
+}
+
+MemoryUsage MemoryTracker::current()
+{
+    return MemoryUsage{
+        current_bytes[0].load(std::memory_order_relaxed),
+        current_bytes[1].load(std::memory_order_relaxed),
+        current_bytes[2].load(std::memory_order_relaxed),
+        current_bytes[3].load(std::memory_order_relaxed)
+    };
+}
+
+MemoryUsage MemoryTracker::peak()
+{
+    return MemoryUsage{
+        peak_bytes[0].load(std::memory_order_relaxed),
+        peak_bytes[1].load(std::memory_order_relaxed),
+        peak_bytes[2].load(std::memory_order_relaxed),
+        peak_bytes[3].load(std::memory_order_relaxed)
+    };
+}
+
+long long MemoryTracker::peak_total_bytes()
+{
+    return peak_total.load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::reset_peak()
+{
+    for(int i = 0; i < 4; ++i)
+        peak_bytes[i].store(current_bytes[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    peak_total.store(current_total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+long long MemoryTracker::live_tensors()
+{
+    return tensors.load(std::memory_order_relaxed);
+}
+
+bool MemoryTracker::report_leaks(std::ostream& out)
+{
+    const long long live{ live_tensors() };
+
+    if(live == 0)
+    {
+        out << "No tensors alive.\n";
+        return false;
+    }
+
+    out << live << " tensor(s) alive: " << current() << '\n';
+    return true;
+}
+
+void MemoryTracker::enable_leak_report()
+{
+    static std::once_flag registered{};
+
+    std::call_once(registered, []
+    {
+        std::atexit([]
+        {
+            if(live_tensors() != 0)
+            {
+                std::cerr << "tensorgrad leak report: ";
+                report_leaks(std::cerr);
+            }
+        });
+    });
+}
+
+namespace
+{
+    const bool leak_report_from_env{ []
+    {
+        if(std::getenv("TENSORGRAD_LEAK_REPORT"))
+            MemoryTracker::enable_leak_report();
+
+        return true;
+    }() };
+}
+
+MemoryAccount::MemoryAccount()
+{
+    MemoryTracker::add_tensors(1);
+}
+
+MemoryAccount::MemoryAccount(const MemoryAccount& other)
+    : recorded{ other.recorded }
+    , jacobian{ other.jacobian }
+{
+    MemoryTracker::add_tensors(1);
+    MemoryTracker::add(recorded);
+}
+
+MemoryAccount& MemoryAccount::operator= (const MemoryAccount& other)
+{
+    if(this == &other)
+        return *this;
+
+    MemoryUsage delta{ other.recorded };
+    delta -= recorded;
+    MemoryTracker::add(delta);
+
+    recorded = other.recorded;
+    jacobian = other.jacobian;
+    return *this;
+}
+
+MemoryAccount::~MemoryAccount()
+{
+    MemoryUsage delta{};
+    delta -= recorded;
+    MemoryTracker::add(delta);
+    MemoryTracker::add_tensors(-1);
+}
+
+void MemoryAccount::record(MemoryUsage usage)
+{
+    if(jacobian)
+    {
+        usage.jacobians += usage.data;
+        usage.data = 0;
+    }
+
+    MemoryUsage delta{ usage };
+    delta -= recorded;
+    MemoryTracker::add(delta);
+
+    recorded = usage;
+}
+
+void MemoryAccount::mark_jacobian()
+{
+    if(jacobian)
+        return;
+
+    jacobian = true;
+
+    MemoryUsage usage{ recorded };
+    usage.jacobians += usage.data;
+    usage.data = 0;
+
+    MemoryUsage delta{ usage };
+    delta -= recorded;
+    MemoryTracker::add(delta);
+
+    recorded = usage;
+}
+
+const MemoryUsage& MemoryAccount::usage() const
+{
+    return recorded;
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#ifndef MEMORY_HPP
+#define MEMORY_HPP
+
+#include <atomic>
+#include <ostream>
+
+/*
+Bytes held by tensors, split into their values ('data'), the values
+of Jacobians cached by operations ('jacobians'), their sparse
+'non_zero_idxs' ('indices') and the Tensor objects themselves with
+their shapes, graph links and operations ('metadata').
+*/
+
+struct MemoryUsage
+{
+    long long data{ 0 };
+    long long jacobians{ 0 };
+    long long indices{ 0 };
+    long long metadata{ 0 };
+
+    long long total() const;
+
+    MemoryUsage& operator+= (const MemoryUsage& other);
+    MemoryUsage& operator-= (const MemoryUsage& other);
+};
+
+std::ostream& operator<< (std::ostream& out, const MemoryUsage& usage);
+
+/*
+Process-wide accounting of every live tensor. The counters are
+relaxed atomics updated whenever a tensor records its usage, so
+they are cheap but only as current as the last recording: a
+tensor records on construction, when produced or differentiated
+by an operation and when its gradient is written, and releases
+on destruction. Code that resizes a tensor's public members
+directly can call 'Tensor<T>::sync_memory' afterwards.
+*/
+
+class MemoryTracker
+{
+private:
+    static std::atomic<long long> current_bytes[4];
+    static std::atomic<long long> peak_bytes[4];
+    static std::atomic<long long> current_total;
+    static std::atomic<long long> peak_total;
+    static std::atomic<long long> tensors;
+
+    static void raise(std::atomic<long long>& peak, const long long value);
+
+public:
+    static void add(const MemoryUsage& delta);
+    static void add_tensors(const long long count);
+
+    static MemoryUsage current();
+
+    /*
+    Peak of each category, and of their total, since the start of
+    the process or the last 'reset_peak'. The categories may peak
+    at different times, so 'peak().total()' can exceed 'peak_total'.
+    */
+
+    static MemoryUsage peak();
+    static long long peak_total_bytes();
+    static void reset_peak();
+
+    static long long live_tensors();
+
+    /*
+    Writes the live tensors and their usage, returning whether any
+    are alive. With 'enable_leak_report' (or the environment variable
+    TENSORGRAD_LEAK_REPORT set), this is written to std::cerr at exit
+    if tensors outlive the program.
+    */
+
+    static bool report_leaks(std::ostream& out);
+    static void enable_leak_report();
+};
+
+/*
+Usage recorded by a single tensor. Copies record the same usage
+again, and the destructor releases whatever was last recorded,
+so the process-wide counters always balance.
+*/
+
+class MemoryAccount
+{
+private:
+    MemoryUsage recorded{};
+    bool jacobian{ false };
+
+public:
+    MemoryAccount();
+    MemoryAccount(const MemoryAccount& other);
+    MemoryAccount& operator= (const MemoryAccount& other);
+    ~MemoryAccount();
+
+    /*
+    Records 'usage', whose values are counted as 'jacobians'
+    rather than 'data' once 'mark_jacobian' has been called.
+    */
+
+    void record(MemoryUsage usage);
+    void mark_jacobian();
+
+    const MemoryUsage& usage() const;
+};
+
+#endif
\ No newline at end of file
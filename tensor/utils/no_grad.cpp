@@ -0,0 +1,23 @@
+#include "no_grad.hpp"
+
+thread_local NoGradGuard* NoGradGuard::current{ nullptr };
+
+NoGradGuard::NoGradGuard(const bool donate_results)
+    : previous{ current }
+    , donate_results{ donate_results }
+{
+    current = this;
+}
+
+NoGradGuard::~NoGradGuard()
+{
+    for(auto iter = arena.rbegin(); iter != arena.rend(); ++iter)
+        iter->second(iter->first);
+
+    current = previous;
+}
+
+bool NoGradGuard::enabled()
+{
+    return current != nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef NO_GRAD_HPP
+#define NO_GRAD_HPP
+
+template <class T>
+class Tensor;
+
+#include <vector>
+#include <utility>
+
+class NoGradGuard
+{
+private:
+    /*
+    Innermost guard alive on the calling thread, if any.
+    */
+
+    static thread_local NoGradGuard* current;
+
+    NoGradGuard* previous;
+
+    const bool donate_results;
+
+    /*
+    Tensors produced while the guard is alive, with the function 
+    deleting each (tensors of any element type share the arena).
+    */
+
+    std::vector<std::pair<void*, void(*)(void*)>> arena;
+
+public:
+    /*
+    While a guard is alive, operations on the calling thread are 
+    evaluated without building a graph: no Operation is allocated 
+    and no parent/child links are recorded. Results are owned by 
+    the innermost guard and freed, in reverse order, when it is 
+    destroyed, so copy out any tensor needed afterwards.
+
+    With 'donate_results', the result of an operation may be 
+    consumed by the next elementwise operation (Add, Sub, Mul, Div, 
+    Exp, Log, Pow) it is passed to: the new result takes over its 
+    storage and it is left empty, so elementwise chains run without 
+    allocating a new buffer per operation. Only the final result of a chain 
+    should then be read, and using a consumed tensor again throws.
+    */
+
+    explicit NoGradGuard(const bool donate_results = false);
+    ~NoGradGuard();
+
+    NoGradGuard(const NoGradGuard&) = delete;
+    NoGradGuard& operator=(const NoGradGuard&) = delete;
+
+    static bool enabled();
+
+    template <class T>
+    static Tensor<T>& adopt(Tensor<T>* tensor);
+};
+
+template <class T>
+Tensor<T>& NoGradGuard::adopt(Tensor<T>* tensor)
+{
+    current->arena.emplace_back(tensor, [](void* ptr){ delete static_cast<Tensor<T>*>(ptr); });
+    tensor->is_donatable = current->donate_results;
+    return *tensor;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "profiler.hpp"
+#include <fstream>
+#include <map>
+#include <tuple>
+#include <thread>
+#include <iomanip>
+#include <stdexcept>
+#include <cstdlib>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+Profiler& Profiler::global()
+{
+    static Profiler profiler{};
+    return profiler;
+}
+
+void Profiler::enable(const bool enabled)
+{
+    this->enabled = enabled;
+}
+
+bool Profiler::is_enabled() const
+{
+    return enabled;
+}
+
+long long Profiler::now_ns() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Profiler::record(Event event)
+{
+    std::lock_guard<std::mutex> lock{ mutex };
+    events.push_back(std::move(event));
+}
+
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock{ mutex };
+    events.clear();
+}
+
+std::vector<Profiler::Event> Profiler::snapshot()
+{
+    std::lock_guard<std::mutex> lock{ mutex };
+    return events;
+}
+
+void Profiler::write_chrome_trace(const std::string& path)
+{
+    const std::vector<Event> recorded{ snapshot() };
+    std::ofstream file{ path };
+
+    if(!file)
+        throw std::runtime_error("Could not open '" + path + "' for writing.");
+
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    file << std::fixed << std::setprecision(3);
+
+    for(int i = 0; i < static_cast<int>(recorded.size()); ++i)
+    {
+        const Event& event{ recorded[i] };
+
+        file << (i ? ",\n" : "\n")
+             << "{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+             << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread
+             << ",\"ts\":" << event.start_ns / 1e3 << ",\"dur\":" << event.duration_ns / 1e3
+             << ",\"args\":{\"shape\":\"" << event.shape << "\",\"elements\":" << event.elements
+             << ",\"bytes\":" << event.bytes << ",\"nnz\":" << event.nnz << "}}";
+    }
+
+    file << "\n]}\n";
+}
+
+void Profiler::summary(std::ostream& out)
+{
+    struct Total
+    {
+        long long calls{ 0 }, duration_ns{ 0 }, elements{ 0 }, bytes{ 0 }, nnz{ 0 };
+    };
+
+    std::map<std::tuple<std::string, std::string, std::string>, Total> totals{};
+
+    for(const Event& event : snapshot())
+    {
+        Total& total{ totals[{ event.category, event.name, event.shape }] };
+        ++total.calls;
+        total.duration_ns += event.duration_ns;
+        total.elements += event.elements;
+        total.bytes += event.bytes;
+        total.nnz += event.nnz;
+    }
+
+    out << std::left << std::setw(10) << "Category" << std::setw(28) << "Name" << std::setw(32) << "Shape"
+        << std::right << std::setw(8) << "Calls" << std::setw(14) << "Total (us)" << std::setw(12) << "Mean (us)"
+        << std::setw(14) << "Elements" << std::setw(14) << "Bytes" << std::setw(14) << "NNZ" << '\n';
+
+    for(const auto& [key, total] : totals)
+    {
+        const auto& [category, name, shape] = key;
+
+        out << std::left << std::setw(10) << category << std::setw(28) << name << std::setw(32) << shape
+            << std::right << std::setw(8) << total.calls << std::fixed << std::setprecision(1)
+            << std::setw(14) << total.duration_ns / 1e3 << std::setw(12) << total.duration_ns / 1e3 / total.calls
+            << std::setw(14) << total.elements << std::setw(14) << total.bytes << std::setw(14) << total.nnz << '\n';
+    }
+}
+
+std::string Profiler::type_name(const std::type_info& type)
+{
+#ifdef __GNUG__
+    int status{ 0 };
+    char* demangled{ abi::__cxa_demangle(type.name(), nullptr, nullptr, &status) };
+
+    if(status == 0 && demangled)
+    {
+        std::string name{ demangled };
+        std::free(demangled);
+        return name;
+    }
+#endif
+
+    return type.name();
+}
+
+std::string Profiler::shape_str(const std::vector<int>& shape)
+{
+    std::string out{ "(" };
+
+    for(int i = 0; i < static_cast<int>(shape.size()); ++i)
+        out += (i ? ", " : "") + std::to_string(shape[i]);
+
+    return out + ")";
+}
+
+std::string Profiler::shape_str(const std::vector<int>& shape1, const std::vector<int>& shape2)
+{
+    return shape_str(shape1) + " x " + shape_str(shape2);
+}
+
+ProfileScope::ProfileScope(std::string name, const char* category)
+    : active{ Profiler::global().is_enabled() }
+    , start_ns{ active ? Profiler::global().now_ns() : 0 }
+    , event{ std::move(name), category, {}, 0, 0, 0, 0, 0, 0 }
+{}
+
+ProfileScope::~ProfileScope()
+{
+    /*
+    Threads are numbered in order of their first recorded event.
+    */
+
+    if(!active)
+        return;
+
+    static std::atomic<int> next_thread{ 0 };
+    thread_local const int thread{ next_thread++ };
+
+    Profiler& profiler{ Profiler::global() };
+    event.start_ns = start_ns;
+    event.duration_ns = profiler.now_ns() - start_ns;
+    event.thread = thread;
+    profiler.record(std::move(event));
+}
\ No newline at end of file
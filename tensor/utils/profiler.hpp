@@ -0,0 +1,105 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <typeinfo>
+
+/*
+Opt-in instrumentation of operations and the engine. Built with 
+TENSORGRAD_PROFILE defined (CMake option TENSORGRAD_PROFILE), the 
+TENSORGRAD_PROFILE_* macros below record an event per forward, 
+backward, Engine::grad and Engine::update call while the profiler 
+is enabled at runtime. Without TENSORGRAD_PROFILE the macros expand 
+to nothing.
+*/
+
+class Profiler
+{
+public:
+    struct Event
+    {
+        std::string name;
+        const char* category;
+        std::string shape;
+        long long start_ns;
+        long long duration_ns;
+        int thread;
+        long long elements;
+        long long bytes;
+        long long nnz;
+    };
+
+private:
+    std::atomic<bool> enabled{ false };
+    const std::chrono::steady_clock::time_point epoch{ std::chrono::steady_clock::now() };
+
+    std::mutex mutex;
+    std::vector<Event> events;
+
+public:
+    static Profiler& global();
+
+    void enable(const bool enabled = true);
+    bool is_enabled() const;
+
+    long long now_ns() const;
+    void record(Event event);
+    void clear();
+
+    std::vector<Event> snapshot();
+
+    /*
+    Writes the events in the Chrome trace event format (one complete 
+    event per call), viewable in chrome://tracing or Perfetto.
+    */
+
+    void write_chrome_trace(const std::string& path);
+
+    /*
+    Writes a table aggregating the events by name and shape: number 
+    of calls, total and mean time, elements, bytes and Jacobian nnz.
+    */
+
+    void summary(std::ostream& out);
+
+    static std::string type_name(const std::type_info& type);
+    static std::string shape_str(const std::vector<int>& shape);
+    static std::string shape_str(const std::vector<int>& shape1, const std::vector<int>& shape2);
+};
+
+class ProfileScope
+{
+private:
+    const bool active;
+    const long long start_ns;
+
+public:
+    Profiler::Event event;
+
+    ProfileScope(std::string name, const char* category);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+    bool is_active() const { return active; }
+};
+
+#ifdef TENSORGRAD_PROFILE
+
+#define TENSORGRAD_PROFILE_SCOPE(scope, name, category) ProfileScope scope{ (Profiler::global().is_enabled() ? (name) : std::string{}), category }
+#define TENSORGRAD_PROFILE_SET(scope, field, value) do { if(scope.is_active()) scope.event.field = (value); } while(false)
+
+#else
+
+#define TENSORGRAD_PROFILE_SCOPE(scope, name, category)
+#define TENSORGRAD_PROFILE_SET(scope, field, value)
+
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,271 @@
+#ifndef SHAPE_HPP
+#define SHAPE_HPP
+
+#include <vector>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace utils
+{
+    /*
+    Shape or multi-index of a tensor. Up to 'inline_capacity' entries
+    are stored inline, so building the (concatenated) indices of a
+    Jacobian does not touch the heap; longer ones spill to the heap.
+    Converts to and from std::vector<int>, and supports the parts of
+    its interface used by the library. Members are defined inline as
+    they sit on the hottest paths (element access, 'modify').
+    */
+
+    class Shape
+    {
+    public:
+        using value_type = int;
+        using size_type = std::size_t;
+        using iterator = int*;
+        using const_iterator = const int*;
+
+        static constexpr int inline_capacity{ 8 };
+
+    private:
+        int* values;
+        int count{ 0 };
+        int allocated{ inline_capacity };
+        int buffer[inline_capacity];
+
+        void grow(const int needed)
+        {
+            if(needed <= allocated)
+                return;
+
+            const int new_allocated{ std::max(needed, 2 * allocated) };
+            int* new_values{ new int[new_allocated] };
+            std::copy(values, values + count, new_values);
+
+            if(values != buffer)
+                delete[] values;
+
+            values = new_values;
+            allocated = new_allocated;
+        }
+
+    public:
+        Shape()
+            : values{ buffer }
+        {}
+
+        Shape(std::initializer_list<int> list)
+            : Shape(list.begin(), list.end())
+        {}
+
+        template <class Iterator, class = std::enable_if_t<!std::is_integral<Iterator>::value>>
+        Shape(Iterator first, Iterator last)
+            : values{ buffer }
+        {
+            grow(static_cast<int>(std::distance(first, last)));
+
+            for(; first != last; ++first)
+                values[count++] = *first;
+        }
+
+        explicit Shape(const size_type size, const int value = 0)
+            : values{ buffer }
+        {
+            grow(static_cast<int>(size));
+            std::fill(values, values + size, value);
+            count = static_cast<int>(size);
+        }
+
+        Shape(const std::vector<int>& vector)
+            : Shape(vector.begin(), vector.end())
+        {}
+
+        Shape(const Shape& other)
+            : Shape(other.begin(), other.end())
+        {}
+
+        Shape(Shape&& other) noexcept
+            : values{ buffer }
+        {
+            *this = std::move(other);
+        }
+
+        Shape& operator= (const Shape& other)
+        {
+            if(this != &other)
+            {
+                grow(other.count);
+                std::copy(other.begin(), other.end(), values);
+                count = other.count;
+            }
+
+            return *this;
+        }
+
+        Shape& operator= (Shape&& other) noexcept
+        {
+            if(this == &other)
+                return *this;
+
+            if(other.values == other.buffer)
+            {
+                if(values != buffer)
+                    delete[] values;
+
+                values = buffer;
+                allocated = inline_capacity;
+                std::copy(other.begin(), other.end(), values);
+            }
+            else
+            {
+                if(values != buffer)
+                    delete[] values;
+
+                values = other.values;
+                allocated = other.allocated;
+                other.values = other.buffer;
+                other.allocated = inline_capacity;
+            }
+
+            count = other.count;
+            other.count = 0;
+            return *this;
+        }
+
+        ~Shape()
+        {
+            if(values != buffer)
+                delete[] values;
+        }
+
+        operator std::vector<int>() const
+        {
+            return std::vector<int>(begin(), end());
+        }
+
+        size_type size() const { return static_cast<size_type>(count); }
+        size_type capacity() const { return static_cast<size_type>(allocated); }
+        bool empty() const { return count == 0; }
+        bool is_inline() const { return values == buffer; }
+
+        int& operator[] (const size_type i) { return values[i]; }
+        int operator[] (const size_type i) const { return values[i]; }
+
+        int& front() { return values[0]; }
+        int front() const { return values[0]; }
+        int& back() { return values[count-1]; }
+        int back() const { return values[count-1]; }
+
+        int* data() { return values; }
+        const int* data() const { return values; }
+
+        iterator begin() { return values; }
+        iterator end() { return values + count; }
+        const_iterator begin() const { return values; }
+        const_iterator end() const { return values + count; }
+
+        void reserve(const size_type size) { grow(static_cast<int>(size)); }
+        void clear() { count = 0; }
+
+        void push_back(const int value)
+        {
+            grow(count + 1);
+            values[count++] = value;
+        }
+
+        void pop_back() { --count; }
+
+        void resize(const size_type size, const int value = 0)
+        {
+            if(static_cast<int>(size) > count)
+            {
+                grow(static_cast<int>(size));
+                std::fill(values + count, values + size, value);
+            }
+
+            count = static_cast<int>(size);
+        }
+
+        void swap(Shape& other) noexcept
+        {
+            Shape temp{ std::move(other) };
+            other = std::move(*this);
+            *this = std::move(temp);
+        }
+
+        template <class Iterator, class = std::enable_if_t<!std::is_integral<Iterator>::value>>
+        void assign(Iterator first, Iterator last)
+        {
+            clear();
+            insert(end(), first, last);
+        }
+
+        void assign(const size_type size, const int value)
+        {
+            clear();
+            resize(size, value);
+        }
+
+        iterator insert(const_iterator position, const int value)
+        {
+            return insert(position, &value, &value + 1);
+        }
+
+        iterator insert(const_iterator position, std::initializer_list<int> list)
+        {
+            return insert(position, list.begin(), list.end());
+        }
+
+        template <class Iterator, class = std::enable_if_t<!std::is_integral<Iterator>::value>>
+        iterator insert(const_iterator position, Iterator first, Iterator last)
+        {
+            // The range may point into 'this', which growing or shifting would overwrite
+            const Shape items{ first, last };
+            const int offset{ static_cast<int>(position - values) };
+            const int inserted{ items.count };
+
+            grow(count + inserted);
+            std::copy_backward(values + offset, values + count, values + count + inserted);
+            std::copy(items.begin(), items.end(), values + offset);
+            count += inserted;
+
+            return values + offset;
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            const int offset{ static_cast<int>(first - values) };
+            const int erased{ static_cast<int>(last - first) };
+
+            std::copy(values + offset + erased, values + count, values + offset);
+            count -= erased;
+
+            return values + offset;
+        }
+
+        iterator erase(const_iterator position)
+        {
+            return erase(position, position + 1);
+        }
+    };
+
+    inline bool operator== (const Shape& shape1, const Shape& shape2)
+    {
+        return std::equal(shape1.begin(), shape1.end(), shape2.begin(), shape2.end());
+    }
+
+    inline bool operator!= (const Shape& shape1, const Shape& shape2)
+    {
+        return !(shape1 == shape2);
+    }
+
+    inline bool operator< (const Shape& shape1, const Shape& shape2)
+    {
+        return std::lexicographical_compare(shape1.begin(), shape1.end(), shape2.begin(), shape2.end());
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+
+ThreadPool& ThreadPool::global()
+{
+    static ThreadPool pool{ std::max(0, static_cast<int>(std::thread::hardware_concurrency()) - 1) };
+    return pool;
+}
+
+ThreadPool::ThreadPool(const int num_workers)
+{
+    for(int i = 0; i < num_workers; ++i)
+        workers.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        stopping = true;
+    }
+
+    task_added.notify_all();
+
+    for(std::thread& worker : workers)
+        worker.join();
+}
+
+int ThreadPool::num_workers() const
+{
+    return static_cast<int>(workers.size());
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock{ mutex };
+        tasks.push(std::move(task));
+    }
+
+    task_added.notify_one();
+    task_done.notify_all();
+}
+
+void ThreadPool::work()
+{
+    std::unique_lock<std::mutex> lock{ mutex };
+
+    while(true)
+    {
+        task_added.wait(lock, [this]{ return stopping || !tasks.empty(); });
+
+        if(tasks.empty())
+            return;
+
+        std::function<void()> task{ std::move(tasks.front()) };
+        tasks.pop();
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        task_done.notify_all();
+    }
+}
+
+void ThreadPool::run_until(const std::function<bool()>& done)
+{
+    std::unique_lock<std::mutex> lock{ mutex };
+
+    while(!done())
+    {
+        if(tasks.empty())
+        {
+            task_done.wait(lock);
+            continue;
+        }
+
+        std::function<void()> task{ std::move(tasks.front()) };
+        tasks.pop();
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        task_done.notify_all();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+
+    std::mutex mutex;
+    std::condition_variable task_added;
+    std::condition_variable task_done;
+    bool stopping{ false };
+
+    void work();
+
+public:
+    /*
+    Pool shared by the library, with one worker less than the 
+    number of hardware threads since callers of 'run_until' (and 
+    of utils::parallel_for) execute tasks as well.
+    */
+
+    static ThreadPool& global();
+
+    explicit ThreadPool(const int num_workers);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int num_workers() const;
+
+    void submit(std::function<void()> task);
+
+    /*
+    Runs queued tasks on the calling thread until 'done' returns 
+    true, sleeping while there is nothing to run. 'done' is checked 
+    again after every task finishes on any thread. Any queued task 
+    may be run, including ones submitted by other callers.
+    */
+
+    void run_until(const std::function<bool()>& done);
+};
+
+/*
+Mutex that can be a member of a copyable class: a copy gets its 
+own unlocked mutex rather than sharing (or failing to copy) the 
+original.
+*/
+
+class CopyableMutex : public std::mutex
+{
+public:
+    CopyableMutex() = default;
+    CopyableMutex(const CopyableMutex&) {}
+    CopyableMutex& operator=(const CopyableMutex&) { return *this; }
+};
+
+#endif
\ No newline at end of file
@@ -1,15 +1,29 @@
 #include "utils.hpp"
 #include <map>
 
-std::vector<std::vector<int>> utils::total_idxs(const std::vector<int>& idx_shape)
+int utils::prod(const utils::Shape& shape)
 {
-    static std::map<std::vector<int>, std::vector<std::vector<int>>> cache;
+    int result{ 1 };
+    for(int val : shape)
+        result *= val;
+    return result;
+}
+
+utils::PrintOptions& utils::print_options()
+{
+    static PrintOptions options{};
+    return options;
+}
+
+std::vector<utils::Shape> utils::total_idxs(const utils::Shape& idx_shape)
+{
+    thread_local std::map<utils::Shape, std::vector<utils::Shape>> cache;
     const auto& iter{ cache.find(idx_shape) };
 
     if(iter != cache.end())
         return iter->second;
 
-    std::vector<std::vector<int>> idxs_set{};
+    std::vector<utils::Shape> idxs_set{};
     bool empty{ true };
     int dims_done{ 0 };
     for(int curr_dim : idx_shape)
@@ -17,16 +31,16 @@ std::vector<std::vector<int>> utils::total_idxs(const std::vector<int>& idx_shap
         if(empty)
         {
             for(int i = 0; i < curr_dim; ++i)
-                idxs_set.push_back( std::vector<int>{ i } );
+                idxs_set.push_back( utils::Shape{ i } );
             
             empty = false;
             ++dims_done;
             continue;
         }
 
-        std::vector<std::vector<int>> new_idxs(idxs_set.size() * curr_dim);
+        std::vector<utils::Shape> new_idxs(idxs_set.size() * curr_dim);
         int count{ 0 };
-        for(std::vector<int> idx : idxs_set)
+        for(utils::Shape idx : idxs_set)
         {
             idx.push_back(-1);
             for(int i = 0; i < curr_dim; ++i)
@@ -46,8 +60,27 @@ std::vector<std::vector<int>> utils::total_idxs(const std::vector<int>& idx_shap
     return idxs_set;
 }
 
-std::vector<int> utils::concat_shapes(std::vector<int> shape1, const std::vector<int>& shape2)
+utils::Shape utils::concat_shapes(utils::Shape shape1, const utils::Shape& shape2)
 {
     shape1.insert(shape1.end(), shape2.begin(), shape2.end());
     return shape1;
+}
+
+utils::Shape utils::unflatten_index(int flat_index, const utils::Shape& shape)
+{
+    /*
+    Inverse of Tensor::flatten_index, maps a row-major flat 
+    index back to a multidimensional index of 'shape'.
+    */
+
+    const int dim{ static_cast<int>(shape.size()) };
+    utils::Shape index(dim);
+
+    for(int i = dim-1; i >= 0; --i)
+    {
+        index[i] = flat_index % shape[i];
+        flat_index /= shape[i];
+    }
+
+    return index;
 }
\ No newline at end of file
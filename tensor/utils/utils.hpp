@@ -4,6 +4,9 @@
 template <class T>
 class Tensor;
 
+class ThreadPool;
+
+#include "shape.hpp"
 #include <vector>
 #include <string>
 
@@ -12,8 +15,23 @@ namespace utils
     template <class T>
     T prod(const std::vector<T>& vec);
 
-    template <class T>
-    void build_str(const Tensor<T>& tensor, std::string& out, std::vector<int> index = {});
+    int prod(const utils::Shape& shape);
+
+    /*
+    Formatting used by 'operator<<': 'precision' digits after the 
+    point for floating point values, and tensors with more than 
+    'threshold' elements are summarized by their first and last 
+    'edge_items' entries along each longer dimension.
+    */
+
+    struct PrintOptions
+    {
+        int precision{ 6 };
+        int threshold{ 1000 };
+        int edge_items{ 3 };
+    };
+
+    PrintOptions& print_options();
 
     template <class T, class U>
     void flatten(const std::vector<U>& vector, std::vector<T>& out);
@@ -22,17 +40,25 @@ namespace utils
     void flatten(const std::vector<std::vector<U>>& multidim, std::vector<T>& out);
 
     template <class U>
-    int calc_shape(const std::vector<U>& vector, std::vector<int>& out, bool first_dim = true);
+    int calc_shape(const std::vector<U>& vector, utils::Shape& out, bool first_dim = true);
 
     template <class U>
-    int calc_shape(const std::vector<std::vector<U>>& multidim, std::vector<int>& out, bool first_dim = true);
+    int calc_shape(const std::vector<std::vector<U>>& multidim, utils::Shape& out, bool first_dim = true);
+
+    std::vector<utils::Shape> total_idxs(const utils::Shape& idx_shape);
 
-    std::vector<std::vector<int>> total_idxs(const std::vector<int>& idx_shape);
+    utils::Shape concat_shapes(utils::Shape shape1, const utils::Shape& shape2);
 
-    std::vector<int> concat_shapes(std::vector<int> shape1, const std::vector<int>& shape2);
+    utils::Shape unflatten_index(int flat_index, const utils::Shape& shape);
 
     template <class T>
-    Tensor<T> self_derivative(const std::vector<int>& shape, const bool overwrite_non_zero = false);
+    Tensor<T> self_derivative(const utils::Shape& shape, const bool overwrite_non_zero = false);
+
+    template <class Function>
+    void parallel_for(const int begin, const int end, Function func, const int min_chunk = 1);
+
+    template <class Function>
+    void parallel_for(ThreadPool& pool, const int begin, const int end, Function func, const int min_chunk = 1);
 }
 
 #include "utils.tpp"
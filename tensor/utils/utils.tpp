@@ -3,9 +3,16 @@
 
 #include "utils.hpp"
 #include "../tensor.hpp"
+#include "thread_pool.hpp"
 #include <iostream>
 #include <string>
 #include <cassert>
+#include <atomic>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 
 template <class T>
 T utils::prod(const std::vector<T>& vec)
@@ -16,34 +23,6 @@ T utils::prod(const std::vector<T>& vec)
     return result;
 }
 
-template <class T>
-void utils::build_str(const Tensor<T>& tensor, std::string& out, std::vector<int> index)
-{
-    const int index_size{ static_cast<int>(index.size()) };
-
-    if(index_size == tensor.dim)
-    {
-        const T value{ tensor(index) };
-        out += std::to_string(value) + " ";
-        return;
-    }
-
-    index.push_back(-1);
-
-    out += "[ ";
-
-    for(int i = 0; i < tensor.shape[index_size]; ++i)
-    {
-        index[index_size] = i;
-        utils::build_str(tensor, out, index);
-    }
-
-    out += "] ";
-
-    if(index_size == tensor.dim - 1)
-        out += '\n';
-}
-
 template <class T, class U>
 void utils::flatten(const std::vector<U>& vector, std::vector<T>& out)
 {
@@ -58,7 +37,7 @@ void utils::flatten(const std::vector<std::vector<U>>& multidim, std::vector<T>&
 }
 
 template <class U>
-int utils::calc_shape(const std::vector<U>& vector, std::vector<int>& out, bool first_dim)
+int utils::calc_shape(const std::vector<U>& vector, utils::Shape& out, bool first_dim)
 {
     int curr_size{ static_cast<int>(vector.size()) };
 
@@ -69,7 +48,7 @@ int utils::calc_shape(const std::vector<U>& vector, std::vector<int>& out, bool
 }
 
 template <class U>
-int utils::calc_shape(const std::vector<std::vector<U>>& multidim, std::vector<int>& out, bool first_dim)
+int utils::calc_shape(const std::vector<std::vector<U>>& multidim, utils::Shape& out, bool first_dim)
 {
     int curr_size{ static_cast<int>(multidim.size()) };
     
@@ -93,25 +72,26 @@ int utils::calc_shape(const std::vector<std::vector<U>>& multidim, std::vector<i
 
 
 template <class T>
-Tensor<T> utils::self_derivative(const std::vector<int>& shape, const bool overwrite_non_zero)
+Tensor<T> utils::self_derivative(const utils::Shape& shape, const bool overwrite_non_zero)
 {
     Tensor<T> out{ concat_shapes(shape, shape), 0 };
 
     if(overwrite_non_zero)
     {
-        out.modify([](Tensor<T>& tensor, const std::vector<int>& index)
+        out.modify([](Tensor<T>& tensor, const utils::Shape& index)
         {
-            std::vector<int> total_index{ concat_shapes(index, index) };
+            utils::Shape total_index{ concat_shapes(index, index) };
             tensor(total_index) = 1;
             tensor.non_zero_idxs.push_back(total_index);
         }
         , shape);
 
+        out.sync_memory();
         return out;
 
     }
 
-    out.modify([](Tensor<T>& tensor, const std::vector<int>& index)
+    out.modify([](Tensor<T>& tensor, const utils::Shape& index)
     {
         tensor(concat_shapes(index, index)) = 1;
     }
@@ -120,4 +100,90 @@ Tensor<T> utils::self_derivative(const std::vector<int>& shape, const bool overw
     return out;
 }
 
+template <class Function>
+void utils::parallel_for(const int begin, const int end, Function func, const int min_chunk)
+{
+    parallel_for(ThreadPool::global(), begin, end, std::move(func), min_chunk);
+}
+
+template <class Function>
+void utils::parallel_for(ThreadPool& pool, const int begin, const int end, Function func, const int min_chunk)
+{
+    /*
+    Splits [begin, end) into contiguous chunks and calls 
+    'func(chunk_begin, chunk_end)' for each chunk. The calling 
+    thread and one task per other chunk submitted to 'pool' claim 
+    chunks in turn, so the caller only runs chunks of this call 
+    (never unrelated tasks queued on the pool) and then waits for 
+    those still running elsewhere. Tasks that start after every 
+    chunk was claimed return at once, without touching 'func'. 
+    The first exception thrown by a chunk is rethrown on the 
+    calling thread, and the chunks not yet started are skipped. 
+    Ranges too small to split are run on the calling thread.
+    */
+
+    const int total{ end - begin };
+    if(total <= 0)
+        return;
+
+    const int num_chunks{ std::max(1, std::min(pool.num_workers() + 1, total / std::max(1, min_chunk))) };
+
+    if(num_chunks == 1)
+    {
+        func(begin, end);
+        return;
+    }
+
+    struct Batch
+    {
+        std::atomic<int> next{ 0 };
+        std::atomic<bool> failed{ false };
+        std::exception_ptr error{};
+
+        std::mutex mutex;
+        std::condition_variable all_finished;
+        int finished{ 0 };
+    };
+
+    const int chunk_size{ (total + num_chunks - 1) / num_chunks };
+    const std::shared_ptr<Batch> batch{ std::make_shared<Batch>() };
+
+    const auto run_chunks = [batch, &func, begin, end, chunk_size, num_chunks]
+    {
+        for(int chunk = batch->next++; chunk < num_chunks; chunk = batch->next++)
+        {
+            if(!batch->failed)
+            {
+                try
+                {
+                    func(begin + chunk * chunk_size, std::min(end, begin + (chunk + 1) * chunk_size));
+                }
+                catch(...)
+                {
+                    if(!batch->failed.exchange(true))
+                        batch->error = std::current_exception();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock{ batch->mutex };
+
+            if(++batch->finished == num_chunks)
+                batch->all_finished.notify_all();
+        }
+    };
+
+    for(int chunk = 1; chunk < num_chunks; ++chunk)
+        pool.submit(run_chunks);
+
+    run_chunks();
+
+    {
+        std::unique_lock<std::mutex> lock{ batch->mutex };
+        batch->all_finished.wait(lock, [&batch, num_chunks]{ return batch->finished == num_chunks; });
+    }
+
+    if(batch->error)
+        std::rethrow_exception(batch->error);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include <vector>
+
+TEST(accumulate_over_micro_batches)
+{
+    Tensor<double> w{ { 0.5, -1.0, 2.0, 0.25 }, { 2, 2 } };
+    Tensor<double>* grad{ nullptr };
+
+    for(int b = 0; b < 3; ++b)
+    {
+        Tensor<double> x{ { 1.0 * b, 2.0, 0.1, 1.0 }, { 2, 2 } };
+        Tensor<double>& loss{ x.matmul(w).sum() };
+        loss.backprop({ &w }, true, false, true);
+
+        // Accumulated into the same tensor
+        if(!grad)
+            grad = w.grad;
+
+        CHECK(w.grad == grad);
+    }
+
+    // d loss / d w_ij = sum_r x_ri, summed over the batches
+    CHECK_NEAR((*w.grad)(std::vector<int>{ 0, 0 }), 0.0 + 1.0 + 2.0 + 3 * 0.1, 1e-12);
+    CHECK_NEAR((*w.grad)(std::vector<int>{ 1, 1 }), 3 * (2.0 + 1.0), 1e-12);
+}
+
+TEST(zero_grad_keeps_the_tensor)
+{
+    Tensor<double> w{ { 0.5, -1.0, 2.0, 0.25 }, { 2, 2 } };
+    Tensor<double> x{ { 1.0, 2.0, 0.1, 1.0 }, { 2, 2 } };
+
+    Tensor<double>& loss{ x.matmul(w).sum() };
+    loss.backprop({ &w }, true, false, true);
+
+    Tensor<double>* grad{ w.grad };
+    w.zero_grad();
+
+    CHECK(w.grad == grad);
+    CHECK(w.grad->shape == w.shape);
+
+    for(const auto& idx : utils::total_idxs(w.shape))
+        CHECK((*w.grad)(idx) == 0);
+
+    loss.backprop({ &w }, true, false, true);
+    CHECK_NEAR((*w.grad)(std::vector<int>{ 0, 0 }), 1.1, 1e-12);
+}
+
+TEST(backprop_without_accumulate_overwrites)
+{
+    Tensor<double> w{ { 0.5, -1.0, 2.0, 0.25 }, { 2, 2 } };
+    Tensor<double> x{ { 1.0, 2.0, 0.1, 1.0 }, { 2, 2 } };
+
+    Tensor<double>& loss{ x.matmul(w).sum() };
+    loss.backprop({ &w });
+
+    Tensor<double>* grad{ w.grad };
+    loss.backprop({ &w });
+
+    CHECK(w.grad == grad);
+    CHECK_NEAR((*w.grad)(std::vector<int>{ 0, 0 }), 1.1, 1e-12);
+}
+
+TEST(zero_grad_without_a_grad)
+{
+    Tensor<double> w{ { 0.5, -1.0 }, { 2 } };
+    w.zero_grad();
+
+    Tensor<double>& loss{ (w * w).sum() };
+    loss.backprop({ &w }, true, false, true);
+    CHECK_NEAR((*w.grad)(std::vector<int>{ 1 }), -2.0, 1e-12);
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
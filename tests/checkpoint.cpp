@@ -0,0 +1,191 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/checkpoint/checkpoint.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+namespace
+{
+    std::string temp_path(const std::string& name)
+    {
+        return (std::filesystem::temp_directory_path() / ("tensorgrad_test_" + name + ".ckpt")).string();
+    }
+
+    std::vector<double> test_values()
+    {
+        std::vector<double> values(24);
+
+        for(int i = 0; i < 24; ++i)
+            values[i] = 0.5 * i - 3;
+
+        return values;
+    }
+
+    /*
+    Saves a single tensor, then overwrites one field of its index 
+    entry, counted in bytes back from the end of the index (the 
+    entry ends with its offset and size).
+    */
+
+    std::string corrupted_checkpoint(const uint64_t from_end, const uint64_t value)
+    {
+        const std::string path{ (std::filesystem::temp_directory_path() / "tensorgrad_test_corrupted.ckpt").string() };
+        const Tensor<double> tensor{ { 1.0, 2.0 }, { 2 } };
+        Checkpoint<double>::save(path, { { "w", &tensor } });
+
+        std::ifstream in{ path, std::ios::binary };
+        std::string bytes{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+        in.close();
+
+        uint64_t index_offset{}, index_size{};
+        std::memcpy(&index_offset, bytes.data() + 16, sizeof(uint64_t));
+        std::memcpy(&index_size, bytes.data() + 24, sizeof(uint64_t));
+        std::memcpy(&bytes[index_offset + index_size - from_end], &value, sizeof(uint64_t));
+
+        std::ofstream out{ path, std::ios::binary | std::ios::trunc };
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        return path;
+    }
+}
+
+TEST(save_and_load_round_trip)
+{
+    const std::string path{ temp_path("round_trip") };
+
+    const Tensor<double> weight{ { 1.5, -2, 3, 4, 5, 6 }, { 2, 3 } };
+    const Tensor<double> bias{ { 7.25 }, { 1 } };
+    const Tensor<double> kernel{ test_values(), { 2, 3, 4 } };
+
+    Checkpoint<double>::save(path, { { "layer.weight", &weight }, { "layer.bias", &bias }, { "conv.kernel", &kernel } });
+
+    {
+        const Checkpoint<double> checkpoint{ path };
+
+        CHECK(checkpoint.names() == (std::vector<std::string>{ "layer.weight", "layer.bias", "conv.kernel" }));
+        CHECK(checkpoint.contains("layer.bias") && !checkpoint.contains("layer"));
+        CHECK(checkpoint.shape("conv.kernel") == (std::vector<int>{ 2, 3, 4 }));
+
+        for(const auto& [name, tensor] : std::vector<std::pair<std::string, const Tensor<double>*>>{ { "layer.weight", &weight }, { "layer.bias", &bias }, { "conv.kernel", &kernel } })
+        {
+            const Tensor<double> loaded{ checkpoint.load(name) };
+            CHECK(loaded.shape == tensor->shape);
+
+            for(const auto& idx : utils::total_idxs(tensor->shape))
+                CHECK(loaded(idx) == (*tensor)(idx));
+
+            // Payloads are 64-byte aligned and read in place
+            CHECK(reinterpret_cast<std::uintptr_t>(checkpoint.view(name)) % 64 == 0);
+        }
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(load_into_overwrites_in_place)
+{
+    const std::string path{ temp_path("load_into") };
+
+    const Tensor<int> saved{ std::vector<int>{ 1, 2, 3, 4 }, { 2, 2 } };
+    Checkpoint<int>::save(path, { { "w", &saved } });
+
+    const Checkpoint<int> checkpoint{ path };
+
+    Tensor<int> param{ std::vector<int>{ 0, 0, 0, 0 }, { 2, 2 } };
+    checkpoint.load_into("w", param);
+
+    CHECK(param(std::vector<int>{ 1, 0 }) == 3);
+    CHECK(param(std::vector<int>{ 1, 1 }) == 4);
+
+    Tensor<int> wrong_shape{ std::vector<int>{ 0, 0, 0, 0 }, { 4 } };
+    CHECK_THROWS(checkpoint.load_into("w", wrong_shape));
+
+    std::filesystem::remove(path);
+}
+
+TEST(mismatches_are_errors)
+{
+    const std::string path{ temp_path("mismatches") };
+
+    const Tensor<double> tensor{ { 1.0, 2.0 }, { 2 } };
+    Checkpoint<double>::save(path, { { "w", &tensor } });
+
+    {
+        const Checkpoint<double> checkpoint{ path };
+        CHECK_THROWS(checkpoint.load("missing"));
+
+        const Checkpoint<int> other_type{ path };
+        CHECK_THROWS(other_type.load("w"));
+    }
+
+    // Truncated file
+    std::ifstream in{ path, std::ios::binary };
+    const std::string bytes{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+    in.close();
+
+    std::ofstream out{ path, std::ios::binary | std::ios::trunc };
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 8));
+    out.close();
+
+    CHECK_THROWS(Checkpoint<double>{ path });
+
+    // Not a checkpoint
+    std::ofstream text{ path, std::ios::trunc };
+    text << "not a checkpoint, but long enough to hold a checkpoint header of 64 bytes";
+    text.close();
+
+    CHECK_THROWS(Checkpoint<double>{ path });
+    CHECK_THROWS(Checkpoint<double>{ temp_path("does_not_exist") });
+
+    std::filesystem::remove(path);
+}
+
+TEST(rejects_duplicate_names)
+{
+    const std::string path{ temp_path("duplicates") };
+    const Tensor<double> tensor1{ { 1.0, 2.0 }, { 2 } };
+    const Tensor<double> tensor2{ { 3.0 }, { 1 } };
+    std::filesystem::remove(path);
+
+    CHECK_THROWS(Checkpoint<double>::save(path, { { "w", &tensor1 }, { "b", &tensor2 }, { "w", &tensor2 } }));
+    CHECK(!std::filesystem::exists(path));
+
+    // A file whose index names a tensor twice
+    Checkpoint<double>::save(path, { { "w1", &tensor1 }, { "w2", &tensor2 } });
+
+    std::ifstream in{ path, std::ios::binary };
+    std::string bytes{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+    in.close();
+
+    bytes[bytes.rfind("w2") + 1] = '1';
+
+    std::ofstream out{ path, std::ios::binary | std::ios::trunc };
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    out.close();
+
+    CHECK_THROWS(Checkpoint<double>{ path });
+
+    std::filesystem::remove(path);
+}
+
+TEST(rejects_payload_size_not_matching_shape)
+{
+    const std::string path{ corrupted_checkpoint(8, 3 * sizeof(double)) };
+    CHECK_THROWS(Checkpoint<double>{ path });
+    std::filesystem::remove(path);
+}
+
+TEST(rejects_misaligned_payload)
+{
+    const std::string path{ corrupted_checkpoint(16, 65) };
+    CHECK_THROWS(Checkpoint<double>{ path });
+    std::filesystem::remove(path);
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include "../tensor/codegen/compiled_graph.hpp"
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <cmath>
+
+/*
+Compiles generated code with the system compiler ('c++', or 
+TENSORGRAD_CXX), into a cache directory removed at the end.
+*/
+
+namespace
+{
+    const std::filesystem::path cache_dir{ std::filesystem::temp_directory_path() / "tensorgrad_test_jit" };
+
+    JitOptions options()
+    {
+        JitOptions options{ JitOptions::from_environment() };
+        options.cache_dir = cache_dir.string();
+        options.flags = "-O1 -std=c++17";
+        return options;
+    }
+
+    struct Graph
+    {
+        Tensor<double> x;
+        Tensor<double> w;
+        Tensor<double> s{ std::vector<double>{ 1.5 }, { 1 } };
+        Tensor<double>* loss;
+
+        explicit Graph(const double x00)
+            : x{ std::vector<double>{ x00, 0.2, 0.3, 0.4, 0.5, 0.6 }, { 2, 3 } }
+            , w{ std::vector<double>{ 0.5, -0.2, 0.3, 0.7, -0.1, 0.9 }, { 3, 2 } }
+        {
+            Tensor<double>& m{ x.matmul(w) };
+            Tensor<double>& t{ m.transpose() };
+            Tensor<double>& y{ ((t.exp() - t.pow(2)) / (t * s + 3.0)).log() };
+            loss = &(y.sum() + y.index({ 1, 0 }) * 2.0 - (m * m).sum() / 4.0);
+        }
+
+        ~Graph()
+        {
+            x.ungraph();
+            w.ungraph();
+            s.ungraph();
+        }
+
+        std::vector<Tensor<double>*> targets() { return { &x, &w, &s }; }
+    };
+
+    void check_close(const Tensor<double>& tensor1, const Tensor<double>& tensor2)
+    {
+        CHECK(tensor1.shape == tensor2.shape);
+
+        for(const auto& idx : utils::total_idxs(tensor1.shape))
+            CHECK_NEAR(tensor1(idx), tensor2(idx), 1e-10 * (1 + std::abs(tensor2(idx))));
+    }
+
+    void check_against_backprop(Graph& compiled, const double x00)
+    {
+        Graph reference{ x00 };
+        reference.loss->backprop(reference.targets());
+
+        CHECK_NEAR(compiled.loss->item(), reference.loss->item(), 1e-10);
+        check_close(*compiled.x.grad, *reference.x.grad);
+        check_close(*compiled.w.grad, *reference.w.grad);
+
+        // backprop squeezes the gradient of the one-element 's', while CompiledGraph keeps its shape
+        const double expected{ (*reference.s.grad)(std::vector<int>{}) };
+        CHECK(compiled.s.grad->shape == compiled.s.shape);
+        CHECK_NEAR((*compiled.s.grad)(std::vector<int>{ 0 }), expected, 1e-10 * (1 + std::abs(expected)));
+    }
+}
+
+TEST(matches_backprop)
+{
+    Graph graph{ 0.1 };
+    CompiledGraph<double> compiled{ *graph.loss, graph.targets(), options() };
+
+    CHECK(&compiled.run() == graph.loss);
+    CHECK(std::filesystem::exists(compiled.library_path()));
+    check_against_backprop(graph, 0.1);
+}
+
+TEST(reruns_after_a_leaf_write)
+{
+    Graph graph{ 0.1 };
+    CompiledGraph<double> compiled{ *graph.loss, graph.targets(), options() };
+    compiled.run();
+
+    graph.x(0, 0) = 0.9;
+    compiled.run();
+    check_against_backprop(graph, 0.9);
+}
+
+TEST(libraries_are_cached)
+{
+    Graph graph1{ 0.1 };
+    Graph graph2{ 0.7 };
+
+    const CompiledGraph<double> compiled1{ *graph1.loss, graph1.targets(), options() };
+    CompiledGraph<double> compiled2{ *graph2.loss, graph2.targets(), options() };
+
+    // Same structure and shapes, so the same code
+    CHECK(compiled2.from_cache());
+    CHECK(compiled2.library_path() == compiled1.library_path());
+
+    compiled2.run();
+    check_against_backprop(graph2, 0.7);
+}
+
+TEST(value_only)
+{
+    Graph graph{ 0.3 };
+    const double expected{ graph.loss->item() };
+
+    CompiledGraph<double> compiled{ *graph.loss, {}, options() };
+    CHECK_NEAR(compiled.run().item(), expected, 1e-10);
+    CHECK(!graph.x.grad);
+
+    std::filesystem::remove_all(cache_dir);
+}
+
+TEST(cache_writable_by_others_is_refused)
+{
+    const std::filesystem::path dir{ std::filesystem::temp_directory_path() / "tensorgrad_test_jit_shared" };
+    std::filesystem::create_directories(dir);
+    std::filesystem::permissions(dir, std::filesystem::perms::all);
+
+    JitOptions shared{ options() };
+    shared.cache_dir = dir.string();
+
+    Graph graph{ 0.1 };
+    CHECK_THROWS(CompiledGraph<double>(*graph.loss, graph.targets(), shared));
+
+    std::filesystem::remove_all(dir);
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include <vector>
+#include <thread>
+#include <cmath>
+
+/*
+Graphs sharing leaves, built and differentiated on several threads at
+once. Meant to be run under ThreadSanitizer (-fsanitize=thread).
+*/
+
+namespace
+{
+    constexpr int num_threads{ 8 };
+    constexpr int num_rounds{ 20 };
+
+    std::vector<double> input(const int thread, const int round)
+    {
+        return { 0.1 * thread, 0.2, 0.05 * round, -0.3 };
+    }
+
+    // d/dw sum(exp(x w) + x * x) and d/dx, for 2x2 'x' and 'w'
+    void expected_grads(const std::vector<double>& x, const std::vector<double>& w, std::vector<double>& wrt_x, std::vector<double>& wrt_w)
+    {
+        wrt_x.assign(4, 0);
+        wrt_w.assign(4, 0);
+
+        for(int i = 0; i < 2; ++i)
+            for(int j = 0; j < 2; ++j)
+            {
+                const double e{ std::exp(x[2*i] * w[j] + x[2*i + 1] * w[2 + j]) };
+
+                for(int k = 0; k < 2; ++k)
+                {
+                    wrt_x[2*i + k] += e * w[2*k + j];
+                    wrt_w[2*k + j] += e * x[2*i + k];
+                }
+            }
+
+        for(int i = 0; i < 4; ++i)
+            wrt_x[i] += 2 * x[i];
+    }
+}
+
+TEST(shared_weight_graphs_on_many_threads)
+{
+    const std::vector<double> w_values{ 0.5, -1.0, 0.75, 0.25 };
+    Tensor<double> w{ w_values, { 2, 2 } };
+
+    std::vector<int> failures(num_threads, 0);
+    std::vector<std::thread> threads{};
+
+    for(int t = 0; t < num_threads; ++t)
+        threads.emplace_back([&, t]
+        {
+            for(int r = 0; r < num_rounds; ++r)
+            {
+                const std::vector<double> x_values{ input(t, r) };
+                Tensor<double> x{ x_values, { 2, 2 } };
+
+                Tensor<double>& loss{ (x.matmul(w).exp() + x * x).sum() };
+
+                // 'w' is shared, so its derivative is taken without writing 'w.grad'
+                loss.backprop({ &x });
+                const Tensor<double> wrt_w{ Engine<double>::grad(&loss, &w) };
+
+                std::vector<double> expected_x{}, expected_w{};
+                expected_grads(x_values, w_values, expected_x, expected_w);
+
+                const auto idxs{ utils::total_idxs({ 2, 2 }) };
+
+                for(int i = 0; i < 4; ++i)
+                {
+                    failures[t] += std::abs((*x.grad)(idxs[i]) - expected_x[i]) > 1e-9;
+                    failures[t] += std::abs(wrt_w(utils::concat_shapes(std::vector<int>{ 0 }, idxs[i])) - expected_w[i]) > 1e-9;
+                }
+            }
+        });
+
+    for(std::thread& thread : threads)
+        thread.join();
+
+    for(int t = 0; t < num_threads; ++t)
+        CHECK(failures[t] == 0);
+
+    // Every graph was freed along with its input, unlinking it from 'w'
+    CHECK(!w.has_children());
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include "test.hpp"
+#include "gradient_check.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include <vector>
+
+/*
+Conv1d/Conv2d against a direct evaluation of the cross-correlation, 
+through both the direct kernel (few taps per output) and im2col, 
+and their derivatives against finite differences.
+*/
+
+namespace
+{
+    struct Params
+    {
+        std::vector<int> stride, padding, dilation;
+    };
+
+    // Cross-correlation of an (n, c, h, w) input with an (o, c, kh, kw) weight
+    std::vector<double> reference(const std::vector<double>& input, const std::vector<int>& in_shape, const std::vector<double>& weight, const std::vector<int>& w_shape, const Params& p, std::vector<int>& out_shape)
+    {
+        const int n{ in_shape[0] }, c{ in_shape[1] }, h{ in_shape[2] }, w{ in_shape[3] };
+        const int o{ w_shape[0] }, kh{ w_shape[2] }, kw{ w_shape[3] };
+        const int oh{ (h + 2 * p.padding[0] - p.dilation[0] * (kh - 1) - 1) / p.stride[0] + 1 };
+        const int ow{ (w + 2 * p.padding[1] - p.dilation[1] * (kw - 1) - 1) / p.stride[1] + 1 };
+
+        out_shape = { n, o, oh, ow };
+        std::vector<double> out(n * o * oh * ow, 0);
+
+        for(int b = 0; b < n; ++b)
+            for(int f = 0; f < o; ++f)
+                for(int y = 0; y < oh; ++y)
+                    for(int x = 0; x < ow; ++x)
+                    {
+                        double value{ 0 };
+
+                        for(int ch = 0; ch < c; ++ch)
+                            for(int i = 0; i < kh; ++i)
+                                for(int j = 0; j < kw; ++j)
+                                {
+                                    const int iy{ y * p.stride[0] - p.padding[0] + i * p.dilation[0] };
+                                    const int ix{ x * p.stride[1] - p.padding[1] + j * p.dilation[1] };
+
+                                    if(iy >= 0 && iy < h && ix >= 0 && ix < w)
+                                        value += input[((b * c + ch) * h + iy) * w + ix] * weight[((f * c + ch) * kh + i) * kw + j];
+                                }
+
+                        out[((b * o + f) * oh + y) * ow + x] = value;
+                    }
+
+        return out;
+    }
+
+    void check_forward(const std::vector<int>& in_shape, const std::vector<int>& w_shape, const Params& p)
+    {
+        const std::vector<double> input{ test::sample(utils::prod(in_shape), -1.0, 1.0, 1) };
+        const std::vector<double> weight{ test::sample(utils::prod(w_shape), -1.0, 1.0, 2) };
+
+        Tensor<double> x{ input, in_shape };
+        Tensor<double> w{ weight, w_shape };
+        const Tensor<double>& out{ x.conv2d(w, p.stride, p.padding, p.dilation) };
+
+        std::vector<int> out_shape{};
+        const std::vector<double> expected{ reference(input, in_shape, weight, w_shape, p, out_shape) };
+
+        CHECK(out.shape == out_shape);
+
+        int i{ 0 };
+        for(const auto& idx : utils::total_idxs(out.shape))
+            CHECK_NEAR(out(idx), expected[i++], 1e-12);
+    }
+}
+
+TEST(conv2d_direct_kernel)
+{
+    check_forward({ 2, 2, 5, 6 }, { 3, 2, 2, 2 }, { { 1, 1 }, { 0, 0 }, { 1, 1 } });
+    check_forward({ 1, 2, 5, 6 }, { 2, 2, 2, 3 }, { { 2, 1 }, { 1, 2 }, { 2, 1 } });
+}
+
+TEST(conv2d_im2col)
+{
+    check_forward({ 2, 3, 6, 5 }, { 4, 3, 3, 3 }, { { 1, 1 }, { 0, 0 }, { 1, 1 } });
+    check_forward({ 1, 4, 7, 6 }, { 2, 4, 3, 2 }, { { 2, 3 }, { 1, 1 }, { 1, 2 } });
+}
+
+TEST(conv1d_matches_conv2d_of_height_one)
+{
+    const std::vector<double> input{ test::sample(2 * 3 * 9, -1.0, 1.0, 3) };
+    const std::vector<double> weight{ test::sample(2 * 3 * 3, -1.0, 1.0, 4) };
+
+    Tensor<double> x{ input, { 2, 3, 9 } };
+    Tensor<double> w{ weight, { 2, 3, 3 } };
+    const Tensor<double>& out{ x.conv1d(w, 2, 1, 2) };
+
+    std::vector<int> out_shape{};
+    const std::vector<double> expected{ reference(input, { 2, 3, 1, 9 }, weight, { 2, 3, 1, 3 }, { { 1, 2 }, { 0, 1 }, { 1, 2 } }, out_shape) };
+
+    CHECK(out.shape == (std::vector<int>{ 2, 2, out_shape[3] }));
+
+    int i{ 0 };
+    for(const auto& idx : utils::total_idxs(out.shape))
+        CHECK_NEAR(out(idx), expected[i++], 1e-12);
+}
+
+TEST(conv1d_gradients)
+{
+    test::check_gradients({ { 2, 2, 7 }, { 3, 2, 3 } }, [](auto& x) -> Tensor<double>& { return x[0]->conv1d(*x[1], 2, 1, 2); });
+}
+
+TEST(conv2d_gradients)
+{
+    // Direct kernel, then im2col
+    test::check_gradients({ { 1, 2, 4, 5 }, { 2, 2, 2, 2 } }, [](auto& x) -> Tensor<double>& { return x[0]->conv2d(*x[1], { 1, 2 }, { 1, 0 }, { 1, 1 }); });
+    test::check_gradients({ { 1, 3, 5, 4 }, { 2, 3, 3, 3 } }, [](auto& x) -> Tensor<double>& { return x[0]->conv2d(*x[1], { 2, 1 }, { 1, 1 }, { 1, 1 }); });
+}
+
+TEST(conv_in_a_larger_graph)
+{
+    test::check_gradients({ { 1, 2, 4, 4 }, { 2, 2, 2, 2 } }, [](auto& x) -> Tensor<double>&
+    {
+        return (x[0]->conv2d(*x[1], { 1, 1 }, { 1, 1 }, { 1, 1 }).exp() * 0.5).sum();
+    });
+}
+
+TEST(create_graph_is_not_supported_through_conv)
+{
+    // Conv has no differentiable backward, so neither create_graph nor hvp can pass through it
+    Tensor<double> x{ test::sample(16, -1.0, 1.0, 1), { 1, 1, 4, 4 } };
+    Tensor<double> w{ test::sample(4, -1.0, 1.0, 2), { 1, 1, 2, 2 } };
+    Tensor<double> c{ std::vector<double>{ 0.5, 2.0 }, { 2 } };
+
+    Tensor<double>& loss{ x.conv2d(w, { 1, 1 }, { 0, 0 }, { 1, 1 }).exp().sum() + (c * c).sum() };
+    CHECK_THROWS(loss.backprop({ &w }, true, true));
+
+    // Derivatives that do not pass through it can still be differentiated again
+    loss.backprop({ &c }, true, true);
+    CHECK(c.grad->has_parents());
+    CHECK_NEAR((*c.grad)(std::vector<int>{ 1 }), 4.0, 1e-12);
+
+    w.seed_tangent(Tensor<double>{ std::vector<double>(4, 1.0), { 1, 1, 2, 2 } });
+    CHECK_THROWS(Engine<double>::hvp(&(x.conv2d(w, { 1, 1 }, { 0, 0 }, { 1, 1 }).exp().sum()), &w));
+
+    x.ungraph();
+    w.ungraph();
+    c.ungraph();
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/data/data_loader.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::string temp_path(const std::string& name)
+    {
+        return (std::filesystem::temp_directory_path() / ("tensorgrad_test_" + name)).string();
+    }
+}
+
+TEST(csv_batches_over_two_epochs)
+{
+    // 10 records of 3 values, the last one dropped as a partial batch
+    const std::string path{ temp_path("loader.csv") };
+
+    {
+        std::ofstream file{ path };
+        file << "a,b,c\n";
+
+        for(int i = 0; i < 10; ++i)
+            file << i << ", " << i * 0.5 << ",+" << -i << "\n";
+
+        file << "\n";
+    }
+
+    DataLoader<double> loader{ path, DataLoader<double>::Format::CSV, { 3 }, 3, 2, true };
+
+    for(int epoch = 0; epoch < 2; ++epoch)
+    {
+        int batches{ 0 };
+
+        while(Tensor<double>* batch = loader.next())
+        {
+            CHECK(batch->shape == (std::vector<int>{ 3, 3 }));
+
+            for(int r = 0; r < 3; ++r)
+            {
+                const int record{ 3 * batches + r };
+                CHECK((*batch)(std::vector<int>{ r, 0 }) == record);
+                CHECK((*batch)(std::vector<int>{ r, 1 }) == record * 0.5);
+                CHECK((*batch)(std::vector<int>{ r, 2 }) == -record);
+            }
+
+            // A graph built from the batch is removed when it is recycled
+            (*batch * 2.0).sum();
+            ++batches;
+        }
+
+        CHECK(batches == 3);
+        CHECK(loader.next() == nullptr);
+        loader.reset();
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(binary_batches)
+{
+    // 15 records of shape (2, 1): 7 full batches of 2 and one dropped record
+    const std::string path{ temp_path("loader.bin") };
+
+    {
+        std::ofstream file{ path, std::ios::binary };
+
+        for(int i = 0; i < 30; ++i)
+        {
+            const double value{ static_cast<double>(i) };
+            file.write(reinterpret_cast<const char*>(&value), sizeof(double));
+        }
+    }
+
+    DataLoader<double> loader{ path, DataLoader<double>::Format::Binary, { 2, 1 }, 2, 3 };
+    int batches{ 0 };
+
+    while(Tensor<double>* batch = loader.next())
+    {
+        CHECK(batch->shape == (std::vector<int>{ 2, 2, 1 }));
+        CHECK((*batch)(std::vector<int>{ 0, 0, 0 }) == 4 * batches);
+        CHECK((*batch)(std::vector<int>{ 1, 1, 0 }) == 4 * batches + 3);
+        ++batches;
+    }
+
+    CHECK(batches == 7);
+    std::filesystem::remove(path);
+}
+
+TEST(malformed_records_are_reported)
+{
+    const std::string path{ temp_path("malformed.csv") };
+
+    {
+        std::ofstream file{ path };
+        file << "1,2\n3,x\n";
+    }
+
+    {
+        DataLoader<int> loader{ path, DataLoader<int>::Format::CSV, { 2 }, 1 };
+        CHECK_THROWS(while(loader.next()) {});
+    }
+
+    // Destroyed while the producer may still be running
+    {
+        DataLoader<int> loader{ path, DataLoader<int>::Format::CSV, { 2 }, 1, 3 };
+    }
+
+    CHECK_THROWS((DataLoader<int>{ temp_path("missing.csv"), DataLoader<int>::Format::CSV, { 2 }, 1 }.next()));
+    std::filesystem::remove(path);
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
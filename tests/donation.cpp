@@ -0,0 +1,145 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/utils/memory.hpp"
+#include "../tensor/utils/no_grad.hpp"
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    constexpr int size{ 4096 };
+    constexpr long long bytes{ size * static_cast<long long>(sizeof(double)) };
+
+    Tensor<double>& chain(Tensor<double>& x)
+    {
+        return (x * 0.5).exp().log().pow(2).exp();
+    }
+
+    std::vector<double> values_of(const Tensor<double>& tensor)
+    {
+        std::vector<double> values{};
+
+        for(int i = 0; i < static_cast<int>(utils::prod(tensor.shape)); ++i)
+            values.push_back(tensor(std::vector<int>{ i }));
+
+        return values;
+    }
+}
+
+TEST(donating_chain_reuses_one_buffer)
+{
+    std::vector<double> input(size);
+
+    for(int i = 0; i < size; ++i)
+        input[i] = 0.001 * i - 1.0;
+
+    Tensor<double> x{ input, { size } };
+    std::vector<double> expected{}, donated{};
+
+    {
+        NoGradGuard guard{};
+        const long long base{ MemoryTracker::current().data };
+        expected = values_of(chain(x));
+
+        // Every intermediate keeps its own values
+        CHECK(MemoryTracker::current().data - base >= 5 * bytes);
+    }
+
+    {
+        NoGradGuard guard{ true };
+        const long long base{ MemoryTracker::current().data };
+        donated = values_of(chain(x));
+
+        // The buffer of the constant 0.5 is the only one, the rest of the chain overwrites it
+        CHECK(MemoryTracker::current().data - base < 2 * bytes);
+    }
+
+    CHECK(donated.size() == expected.size());
+
+    for(int i = 0; i < size; ++i)
+        CHECK_NEAR(donated[i], expected[i], 1e-12);
+}
+
+TEST(consumed_tensors_throw)
+{
+    Tensor<double> x{ std::vector<double>{ 0.1, 0.2, 0.3, 0.4 }, { 2, 2 } };
+
+    NoGradGuard guard{ true };
+    Tensor<double>& a{ x * 2.0 };
+    Tensor<double>& b{ a.exp() };
+
+    CHECK_NEAR(b(1, 1), std::exp(0.8), 1e-12);
+    CHECK_THROWS(a.exp());
+
+    // Leaves are never donated
+    CHECK_NEAR((x + 1.0)(0, 1), 1.2, 1e-12);
+    CHECK_NEAR(x(0, 1), 0.2, 1e-12);
+}
+
+TEST(graph_mode_does_not_donate)
+{
+    Tensor<double> x{ std::vector<double>{ 0.1, 0.2, 0.3, 0.4 }, { 2, 2 } };
+    Tensor<double>& a{ x * 2.0 };
+    Tensor<double>& b{ a.exp() };
+
+    CHECK_NEAR(a(1, 0), 0.6, 1e-12);
+    CHECK_NEAR(b(1, 0), std::exp(0.6), 1e-12);
+
+    x.ungraph();
+}
+
+TEST(moves_steal_values_outside_graphs)
+{
+    Tensor<double> p{ std::vector<double>{ 1.0, 2.0, 3.0 } };
+    Tensor<double> q{ std::move(p) };
+    CHECK(q.shape == std::vector<int>{ 3 });
+    CHECK(q(std::vector<int>{ 2 }) == 3.0);
+
+    Tensor<double> r{ std::vector<double>{ 0.0 } };
+    r = std::move(q);
+    CHECK(r(std::vector<int>{ 1 }) == 2.0);
+
+    const Tensor<double> s{ Tensor<double>::squeeze(Tensor<double>{ std::vector<double>{ 1.0, 2.0 }, { 1, 2 } }) };
+    CHECK(s.shape == std::vector<int>{ 2 });
+
+    // Parents and children still point to a graph node
+    Tensor<double> x{ std::vector<double>{ 1.0, 2.0 } };
+    Tensor<double>& node{ x.exp() };
+    CHECK_THROWS(Tensor<double>{ std::move(node) });
+
+    x.ungraph();
+}
+
+TEST(copies_own_their_grad_and_tangent)
+{
+    Tensor<double>* copy{};
+    Tensor<double> assigned{ { 0.0 }, { 1 } };
+
+    {
+        Tensor<double> a{ { 1.0, 2.0 }, { 2 } };
+        Tensor<double>& loss{ (a * a).sum() };
+        loss.backprop({ &a });
+        a.seed_tangent_basis();
+
+        copy = new Tensor<double>{ a };
+        assigned = a;
+
+        CHECK(copy->grad != a.grad && copy->tangent != a.tangent);
+        CHECK(!copy->has_parents() && !copy->has_children());
+    }
+
+    // 'a' and its graph are gone, the copies' grad and tangent are not
+    CHECK((*copy->grad)(std::vector<int>{ 1 }) == 4.0);
+    CHECK((*assigned.tangent)(std::vector<int>{ 1, 1 }) == 1.0);
+    delete copy;
+
+    Tensor<double> leaf{ { 1.0 }, { 1 } };
+    Tensor<double>& node{ leaf * 2.0 };
+    CHECK_THROWS(node = assigned);
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
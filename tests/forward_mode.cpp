@@ -0,0 +1,112 @@
+#include "test.hpp"
+#include "gradient_check.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include <vector>
+
+/*
+Forward-mode tangents against the reverse-mode derivatives of 
+Engine<double>::grad: a basis seed must reproduce the full 
+derivative, and a direction the derivative contracted with it.
+*/
+
+namespace
+{
+    void check_equal(const Tensor<double>& actual, const Tensor<double>& expected)
+    {
+        CHECK(actual.shape == expected.shape);
+
+        if(actual.shape != expected.shape)
+            return;
+
+        for(const auto& idx : utils::total_idxs(expected.shape))
+            CHECK_NEAR(actual(idx), expected(idx), 1e-9 * (1 + std::abs(expected(idx))));
+    }
+
+    Tensor<double>& composite(Tensor<double>& a, Tensor<double>& b, Tensor<double>& c)
+    {
+        Tensor<double>& m{ a.matmul(b) };
+        Tensor<double>& d{ (m * m + c).exp(1.1) - m.pow(3) / (c * c + 1) };
+        return d.matmul(c) + 2 * d - m.sum() + c.log(2).sum() + d.index({ 0, 1 });
+    }
+}
+
+TEST(basis_seed_matches_grad)
+{
+    for(int which = 0; which < 3; ++which)
+    {
+        Tensor<double> a{ { 1, 2.5, -3, 4, 0.5, 6 }, { 2, 3 } };
+        Tensor<double> b{ { 0.3, -1, 2, 1.5, 2, -0.7 }, { 3, 2 } };
+        Tensor<double> c{ { 1.2, 0.4, 0.5, 2.0 }, { 2, 2 } };
+        Tensor<double>* targets[3]{ &a, &b, &c };
+
+        targets[which]->seed_tangent_basis();
+        Tensor<double>& e{ composite(a, b, c) };
+
+        check_equal(Engine<double>::forward_grad(&e, targets[which]), Engine<double>::grad(&e, targets[which]));
+    }
+}
+
+TEST(basis_seed_through_conv)
+{
+    Tensor<double> x{ test::sample(2 * 3 * 5 * 5, -1.0, 1.0, 1), { 2, 3, 5, 5 } };
+    Tensor<double> w{ test::sample(2 * 3 * 2 * 2, -1.0, 1.0, 2), { 2, 3, 2, 2 } };
+
+    x.seed_tangent_basis();
+    Tensor<double>& out{ x.conv2d(w, { 1, 2 }, { 1, 1 }, { 1, 1 }) };
+    check_equal(Engine<double>::forward_grad(&out, &x), Engine<double>::grad(&out, &x));
+
+    x.clear_tangent();
+    w.seed_tangent_basis();
+    Tensor<double>& out2{ x.conv2d(w, { 1, 2 }, { 1, 1 }, { 1, 1 }) };
+    check_equal(Engine<double>::forward_grad(&out2, &w), Engine<double>::grad(&out2, &w));
+}
+
+TEST(directions_give_jacobian_vector_products)
+{
+    const std::vector<double> v1{ 1, -0.5, 0.25, 2, 0.1, -1 };
+    const std::vector<double> v2{ 0, 1, 0, -1, 3, 0.5 };
+
+    std::vector<double> directions{ v1 };
+    directions.insert(directions.end(), v2.begin(), v2.end());
+
+    Tensor<double> a{ { 1, 2.5, -3, 4, 0.5, 6 }, { 2, 3 } };
+    Tensor<double> b{ { 0.3, -1, 2, 1.5, 2, -0.7 }, { 3, 2 } };
+    Tensor<double> c{ { 1.2, 0.4, 0.5, 2.0 }, { 2, 2 } };
+
+    a.seed_tangent(Tensor<double>{ directions, { 2, 2, 3 } });
+    Tensor<double>& e{ composite(a, b, c) };
+
+    const Tensor<double> jacobian{ Engine<double>::grad(&e, &a) };
+    CHECK(e.tangent->shape == (std::vector<int>{ 2, 2, 2 }));
+
+    for(int k = 0; k < 2; ++k)
+        for(const auto& idx : utils::total_idxs(e.shape))
+        {
+            double expected{ 0 };
+            int j{ 0 };
+
+            for(const auto& arg_idx : utils::total_idxs(a.shape))
+                expected += jacobian(utils::concat_shapes(idx, arg_idx)) * directions[6 * k + j++];
+
+            CHECK_NEAR((*e.tangent)(utils::concat_shapes({ k }, idx)), expected, 1e-9 * (1 + std::abs(expected)));
+        }
+}
+
+TEST(tangents_broadcast_with_scalars)
+{
+    Tensor<double> p{ { 2.0 }, { 1 } };
+    Tensor<double> q{ { 1, 2, 3 }, { 3 } };
+
+    p.seed_tangent(Tensor<double>{ { 1.0 }, { 1 } });
+    Tensor<double>& r{ q * p + p };
+
+    CHECK(r.tangent->shape == (std::vector<int>{ 1, 3 }));
+    CHECK_NEAR((*r.tangent)(0, 2), 4.0, 1e-12);
+    CHECK(q.tangent == nullptr);
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef GRADIENT_CHECK_HPP
+#define GRADIENT_CHECK_HPP
+
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include <vector>
+#include <memory>
+#include <functional>
+
+/*
+Checks Engine<double>::grad of a graph built by 'build' from leaves 
+of the given shapes against central finite differences, wrt. each 
+of its leaves. The leaves are filled with deterministic values in 
+[low, high].
+*/
+
+namespace test
+{
+    using Builder = std::function<Tensor<double>&(std::vector<Tensor<double>*>&)>;
+
+    inline std::vector<double> sample(const int size, const double low, const double high, const int seed)
+    {
+        std::vector<double> values(size);
+
+        for(int i = 0; i < size; ++i)
+        {
+            const double unit{ ((i * 7919 + seed * 104729) % 1000) / 1000.0 };
+            values[i] = low + (high - low) * unit;
+        }
+
+        return values;
+    }
+
+    // Values of the graph built from leaves holding 'values', which are freed along with it
+    inline std::vector<double> evaluate(const std::vector<std::vector<int>>& shapes, const std::vector<std::vector<double>>& values, const Builder& build)
+    {
+        std::vector<std::unique_ptr<Tensor<double>>> leaves{};
+        std::vector<Tensor<double>*> args{};
+
+        for(int i = 0; i < static_cast<int>(shapes.size()); ++i)
+        {
+            leaves.push_back(std::make_unique<Tensor<double>>(values[i], shapes[i]));
+            args.push_back(leaves.back().get());
+        }
+
+        const Tensor<double>& out{ build(args) };
+        std::vector<double> result{};
+
+        for(const auto& idx : utils::total_idxs(out.shape))
+            result.push_back(out(idx));
+
+        return result;
+    }
+
+    inline void check_gradients(const std::vector<std::vector<int>>& shapes, const Builder& build, const double low = -1.0, const double high = 1.0)
+    {
+        constexpr double eps{ 1e-6 };
+        constexpr double tolerance{ 1e-5 };
+
+        std::vector<std::vector<double>> values{};
+
+        for(int i = 0; i < static_cast<int>(shapes.size()); ++i)
+            values.push_back(sample(utils::prod(shapes[i]), low, high, i + 1));
+
+        std::vector<std::unique_ptr<Tensor<double>>> leaves{};
+        std::vector<Tensor<double>*> args{};
+
+        for(int i = 0; i < static_cast<int>(shapes.size()); ++i)
+        {
+            leaves.push_back(std::make_unique<Tensor<double>>(values[i], shapes[i]));
+            args.push_back(leaves.back().get());
+        }
+
+        Tensor<double>& out{ build(args) };
+        const auto out_idxs{ utils::total_idxs(out.shape) };
+
+        for(int i = 0; i < static_cast<int>(shapes.size()); ++i)
+        {
+            const Tensor<double> jacobian{ Engine<double>::grad(&out, args[i]) };
+            CHECK(jacobian.shape == utils::concat_shapes(out.shape, shapes[i]));
+
+            const auto arg_idxs{ utils::total_idxs(shapes[i]) };
+
+            for(int j = 0; j < static_cast<int>(arg_idxs.size()); ++j)
+            {
+                std::vector<std::vector<double>> plus{ values };
+                std::vector<std::vector<double>> minus{ values };
+                plus[i][j] += eps;
+                minus[i][j] -= eps;
+
+                const std::vector<double> out_plus{ evaluate(shapes, plus, build) };
+                const std::vector<double> out_minus{ evaluate(shapes, minus, build) };
+
+                for(int k = 0; k < static_cast<int>(out_idxs.size()); ++k)
+                {
+                    const double expected{ (out_plus[k] - out_minus[k]) / (2 * eps) };
+                    CHECK_NEAR(jacobian(utils::concat_shapes(out_idxs[k], arg_idxs[j])), expected, tolerance * (1 + std::abs(expected)));
+                }
+            }
+        }
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "test.hpp"
+#include "gradient_check.hpp"
+#include "../tensor/tensor.hpp"
+
+/*
+Checks Engine<double>::grad of every operation against central
+finite differences, wrt. each of its arguments. Conv has its own
+checks in conv.cpp.
+*/
+
+using test::check_gradients;
+
+TEST(add)
+{
+    check_gradients({ { 2, 3 }, { 2, 3 } }, [](auto& x) -> Tensor<double>& { return *x[0] + *x[1]; });
+}
+
+TEST(sub)
+{
+    check_gradients({ { 2, 3 }, { 2, 3 } }, [](auto& x) -> Tensor<double>& { return *x[0] - *x[1]; });
+}
+
+TEST(mul)
+{
+    check_gradients({ { 2, 3 }, { 2, 3 } }, [](auto& x) -> Tensor<double>& { return *x[0] * *x[1]; });
+}
+
+TEST(div)
+{
+    check_gradients({ { 2, 3 }, { 2, 3 } }, [](auto& x) -> Tensor<double>& { return *x[0] / *x[1]; }, 0.5, 2.0);
+}
+
+TEST(scalar_operands)
+{
+    check_gradients({ { 4 } }, [](auto& x) -> Tensor<double>& { return (2.0 - *x[0]) * 3.0 + 1.0 / (*x[0] + 2.0); });
+}
+
+TEST(pow)
+{
+    check_gradients({ { 2, 3 } }, [](auto& x) -> Tensor<double>& { return x[0]->pow(3); });
+}
+
+TEST(exp)
+{
+    check_gradients({ { 2, 3 } }, [](auto& x) -> Tensor<double>& { return x[0]->exp(); });
+    check_gradients({ { 3 } }, [](auto& x) -> Tensor<double>& { return x[0]->exp(2); });
+}
+
+TEST(log)
+{
+    check_gradients({ { 2, 3 } }, [](auto& x) -> Tensor<double>& { return x[0]->log(); }, 0.5, 2.0);
+    check_gradients({ { 3 } }, [](auto& x) -> Tensor<double>& { return x[0]->log(10); }, 0.5, 2.0);
+}
+
+TEST(sum)
+{
+    check_gradients({ { 2, 3 } }, [](auto& x) -> Tensor<double>& { return x[0]->sum(); });
+}
+
+TEST(subscript)
+{
+    check_gradients({ { 2, 3 } }, [](auto& x) -> Tensor<double>& { return x[0]->index({ 1, 2 }); });
+}
+
+TEST(broadcast)
+{
+    check_gradients({ { 1 }, { 2, 3 } }, [](auto& x) -> Tensor<double>& { return *x[0] * *x[1]; });
+}
+
+TEST(transpose)
+{
+    check_gradients({ { 2, 3 } }, [](auto& x) -> Tensor<double>& { return x[0]->transpose(); });
+}
+
+TEST(matmul)
+{
+    check_gradients({ { 2, 3 }, { 3, 4 } }, [](auto& x) -> Tensor<double>& { return x[0]->matmul(*x[1]); });
+}
+
+TEST(composite)
+{
+    check_gradients({ { 2, 3 }, { 3, 2 } }, [](auto& x) -> Tensor<double>&
+    {
+        Tensor<double>& m{ x[0]->matmul(*x[1]) };
+        return (m.exp() * m).sum() + (*x[0] * *x[0]).log().sum() - m.sum() / (x[1]->sum() + 10.0);
+    });
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
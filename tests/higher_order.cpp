@@ -0,0 +1,132 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include <vector>
+
+/*
+Derivatives of derivatives: gradients built with create_graph, 
+backpropagated through again, and Hessian-vector products, all 
+against finite differences of first-order gradients.
+*/
+
+namespace
+{
+    constexpr double eps{ 1e-5 };
+
+    const std::vector<double> w0{ 0.3, -0.2, 0.5, 0.1, 0.7, -0.4 };
+    const std::vector<double> x0{ 1, 2, -1, 0.5, 0.3, 1.5 };
+
+    Tensor<double>& loss_of(Tensor<double>& w, Tensor<double>& x, Tensor<double>& c)
+    {
+        Tensor<double>& m{ w.matmul(x) };
+        return (m.exp(2) * m).sum() + (w * w).log().sum() + w.index({ 1, 2 }).pow(3) - m.sum() / (c + w.sum());
+    }
+
+    // First-order gradient of the loss wrt. 'w', evaluated at 'w_values'
+    std::vector<double> grad_at(const std::vector<double>& w_values)
+    {
+        Tensor<double> w{ w_values, { 2, 3 } };
+        Tensor<double> x{ x0, { 3, 2 } };
+        Tensor<double> c{ { 2.0 }, { 1 } };
+
+        loss_of(w, x, c).backprop({ &w });
+
+        std::vector<double> grad{};
+
+        for(const auto& idx : utils::total_idxs(w.shape))
+            grad.push_back((*w.grad)(idx));
+
+        return grad;
+    }
+
+    std::vector<double> shifted(std::vector<double> values, const std::vector<double>& direction, const double step)
+    {
+        for(int i = 0; i < static_cast<int>(values.size()); ++i)
+            values[i] += step * direction[i];
+
+        return values;
+    }
+}
+
+TEST(create_graph_gives_the_same_first_derivatives)
+{
+    Tensor<double> w{ w0, { 2, 3 } };
+    Tensor<double> x{ x0, { 3, 2 } };
+    Tensor<double> c{ { 2.0 }, { 1 } };
+
+    loss_of(w, x, c).backprop({ &w, &c }, true, true);
+
+    const std::vector<double> expected{ grad_at(w0) };
+    CHECK(w.grad->shape == w.shape);
+    CHECK(w.grad->has_parents());
+
+    int i{ 0 };
+    for(const auto& idx : utils::total_idxs(w.shape))
+        CHECK_NEAR((*w.grad)(idx), expected[i++], 1e-9);
+}
+
+TEST(backprop_through_a_gradient)
+{
+    // d/dw sum(grad^2), with 'grad' built as part of the graph
+    Tensor<double> w{ w0, { 2, 3 } };
+    Tensor<double> x{ x0, { 3, 2 } };
+    Tensor<double> c{ { 2.0 }, { 1 } };
+
+    loss_of(w, x, c).backprop({ &w }, true, true);
+    Tensor<double>& norm{ (*w.grad * *w.grad).sum() };
+    norm.backprop({ &w });
+
+    for(int k = 0; k < 6; ++k)
+    {
+        std::vector<double> unit(6, 0);
+        unit[k] = 1;
+
+        double plus{ 0 }, minus{ 0 };
+
+        for(const double g : grad_at(shifted(w0, unit, eps)))
+            plus += g * g;
+
+        for(const double g : grad_at(shifted(w0, unit, -eps)))
+            minus += g * g;
+
+        const double expected{ (plus - minus) / (2 * eps) };
+        CHECK_NEAR((*w.grad)(std::vector<int>{ k / 3, k % 3 }), expected, 1e-4 * (1 + std::abs(expected)));
+    }
+}
+
+TEST(hessian_vector_product)
+{
+    const std::vector<double> v{ 1, -0.5, 0.25, 2, 0.1, -1 };
+
+    Tensor<double> w{ w0, { 2, 3 } };
+    Tensor<double> x{ x0, { 3, 2 } };
+    Tensor<double> c{ { 2.0 }, { 1 } };
+
+    w.seed_tangent(Tensor<double>{ v, { 2, 3 } });
+    const Tensor<double> hv{ Engine<double>::hvp(&loss_of(w, x, c), &w) };
+
+    CHECK(hv.shape == (std::vector<int>{ 1, 2, 3 }));
+
+    const std::vector<double> plus{ grad_at(shifted(w0, v, eps)) };
+    const std::vector<double> minus{ grad_at(shifted(w0, v, -eps)) };
+
+    for(int k = 0; k < 6; ++k)
+    {
+        const double expected{ (plus[k] - minus[k]) / (2 * eps) };
+        CHECK_NEAR(hv(std::vector<int>{ 0, k / 3, k % 3 }), expected, 1e-5 * (1 + std::abs(expected)));
+    }
+}
+
+TEST(hvp_needs_a_seeded_target)
+{
+    Tensor<double> w{ w0, { 2, 3 } };
+    Tensor<double> x{ x0, { 3, 2 } };
+    Tensor<double> c{ { 2.0 }, { 1 } };
+
+    CHECK_THROWS(Engine<double>::hvp(&loss_of(w, x, c), &w));
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include "../tensor/planner/memory_planner.hpp"
+#include "../tensor/optimizers/sgd/sgd.hpp"
+#include <vector>
+#include <cmath>
+
+using std::vector;
+
+namespace
+{
+    constexpr int n{ 8 };
+
+    // A large branch on w and x (4 operations) and a small one on h (3), added together
+    Tensor<double>& build(Tensor<double>& w, Tensor<double>& x, Tensor<double>& h)
+    {
+        Tensor<double>& large{ (w.matmul(x).exp() + 1.0).log() };
+        Tensor<double>& small{ (h * h * 3.0).sum() };
+        return large.sum() + small;
+    }
+
+    struct Leaves
+    {
+        Tensor<double> w{ values(0.1), { n, n } };
+        Tensor<double> x{ values(-0.2), { n, n } };
+        Tensor<double> h{ vector<double>{ 0.5, -1.5, 2.0 }, { 3 } };
+
+        static vector<double> values(const double scale)
+        {
+            vector<double> values(n * n);
+
+            for(int i = 0; i < n * n; ++i)
+                values[i] = std::sin(i + scale * 10) * scale;
+
+            return values;
+        }
+
+        ~Leaves()
+        {
+            w.ungraph();
+            x.ungraph();
+            h.ungraph();
+        }
+    };
+
+    void check_close(const Tensor<double>& tensor1, const Tensor<double>& tensor2)
+    {
+        CHECK(tensor1.shape == tensor2.shape);
+
+        for(const auto& idx : utils::total_idxs(tensor1.shape))
+            CHECK_NEAR(tensor1(idx), tensor2(idx), 1e-9 * (1 + std::abs(tensor2(idx))));
+    }
+}
+
+TEST(only_the_written_branch_is_recomputed)
+{
+    Leaves leaves;
+    Tensor<double>& loss{ build(leaves.w, leaves.x, leaves.h) };
+    CHECK(loss.refresh() == 0);
+
+    for(int step = 0; step < 3; ++step)
+    {
+        leaves.h(vector<int>{ 0 }) = 0.5 + step;
+
+        // h * h, * 3, sum and the final add
+        CHECK(loss.refresh() == 4);
+        CHECK(loss.refresh() == 0);
+
+        Tensor<double>& fresh{ build(leaves.w, leaves.x, leaves.h) };
+        CHECK_NEAR(loss.item(), fresh.item(), 1e-9 * std::abs(fresh.item()));
+
+        loss.backprop({ &leaves.h, &leaves.w });
+        const Tensor<double> grad_h{ *leaves.h.grad }, grad_w{ *leaves.w.grad };
+
+        fresh.backprop({ &leaves.h, &leaves.w });
+        check_close(grad_h, *leaves.h.grad);
+        check_close(grad_w, *leaves.w.grad);
+    }
+
+    // matmul, exp, add, log, sum and the final add
+    leaves.w(0, 0) = 0.3;
+    CHECK(loss.refresh() == 6);
+}
+
+TEST(reads_refresh_lazily)
+{
+    Leaves leaves;
+    Tensor<double>& loss{ build(leaves.w, leaves.x, leaves.h) };
+
+    leaves.h(vector<int>{ 1 }) = 4.0;
+    const Tensor<double>& h{ leaves.h };
+    CHECK(h(vector<int>{ 1 }) == 4.0);
+
+    // Reading the root refreshes it
+    CHECK_NEAR(loss.item(), build(leaves.w, leaves.x, leaves.h).item(), 1e-9 * std::abs(loss.item()));
+    CHECK(loss.refresh() == 0);
+
+    // So does passing a stale tensor to a new operation
+    leaves.h(vector<int>{ 2 }) = 1.0;
+    Tensor<double>& doubled{ loss * 2.0 };
+    CHECK_NEAR(doubled.item(), 2 * build(leaves.w, leaves.x, leaves.h).item(), 1e-9 * std::abs(doubled.item()));
+}
+
+TEST(optimizer_steps_are_writes)
+{
+    Tensor<double> a{ vector<double>{ 1.0, 2.0, 3.0, 4.0 }, { 2, 2 } };
+    Tensor<double>& r{ (a.exp() * 2.0 + a).sum() };
+    SGD<double> optimizer{ { &a }, 0.1 };
+
+    r.backprop({ &a });
+    optimizer.step();
+
+    // exp, * 2, + and sum
+    CHECK(r.refresh() == 4);
+
+    double expected{ 0.0 };
+
+    for(int i = 0; i < 4; ++i)
+    {
+        const double value{ (i + 1) - 0.1 * (2 * std::exp(i + 1.0) + 1) };
+        CHECK_NEAR(a(i / 2, i % 2), value, 1e-12);
+        expected += 2 * std::exp(value) + value;
+    }
+
+    CHECK_NEAR(r.item(), expected, 1e-9 * std::abs(expected));
+
+    a.ungraph();
+}
+
+TEST(planner_execute_refreshes_the_root)
+{
+    Tensor<double> a{ vector<double>{ 1.0, 2.0, 3.0, 4.0 }, { 2, 2 } };
+    Tensor<double>& r{ (a.exp() * 2.0 + a).sum() };
+    MemoryPlanner<double> plan{ r };
+    plan.release();
+
+    a(0, 0) = 2.0;
+    const double expected{ (std::exp(2.0) + std::exp(2.0) + std::exp(3.0) + std::exp(4.0)) * 2 + 11 };
+    CHECK_NEAR(plan.execute().item(), expected, 1e-9 * expected);
+    CHECK(r.refresh() == 0);
+
+    a.ungraph();
+}
+
+TEST(unreleased_plan_recomputes_intermediates)
+{
+    Tensor<double> x{ vector<double>{ 1.0, 2.0 }, { 2 } };
+    Tensor<double>& a{ x.exp() };
+    Tensor<double>& b{ (a * a).sum() };
+    MemoryPlanner<double> plan{ b };
+
+    x(vector<int>{ 0 }) = 3.0;
+    plan.execute();
+    CHECK(b.refresh() == 0);
+    CHECK_NEAR(a(vector<int>{ 0 }), std::exp(3.0), 1e-12);
+
+    b.backprop({ &x });
+    CHECK_NEAR((*x.grad)(vector<int>{ 0 }), 2 * std::exp(6.0), 1e-9);
+    CHECK_NEAR((*x.grad)(vector<int>{ 1 }), 2 * std::exp(4.0), 1e-9);
+
+    // The next write still reaches the root
+    x(vector<int>{ 1 }) = 0.0;
+    CHECK(b.refresh() == 3);
+    CHECK_NEAR(b.item(), std::exp(6.0) + 1.0, 1e-9);
+
+    x.ungraph();
+}
+
+TEST(modify_is_one_write)
+{
+    Tensor<double> x{ vector<double>{ 1.0, 2.0, 3.0, 4.0 }, { 2, 2 } };
+    Tensor<double>& y{ (x * x).sum() };
+    y.refresh();
+
+    x.modify([](Tensor<double>& tensor, const utils::Shape& index)
+    {
+        tensor(index) = index[0] + index[1];
+    }
+    , x.shape);
+
+    // * and sum
+    CHECK(y.refresh() == 2);
+    CHECK(y.item() == 6.0);
+
+    x.ungraph();
+}
+
+TEST(element_reads_are_not_writes)
+{
+    Tensor<double> x{ vector<double>{ 1.0, 2.0 }, { 2 } };
+    Tensor<double>& y{ (x * x).sum() };
+    y.refresh();
+
+    const double read{ x(vector<int>{ 0 }) };
+    CHECK(read == 1.0 && x(vector<int>{ 1 }) + 1.0 == 3.0);
+    CHECK(y.refresh() == 0);
+
+    x(vector<int>{ 1 }) += 1.0;
+    CHECK(y.refresh() == 2);
+    CHECK(y.item() == 10.0);
+
+    x.ungraph();
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include "../tensor/utils/memory.hpp"
+#include <vector>
+
+/*
+The loss sums x * w + x.matmul(w), so d(loss)/dw only depends on 
+x: d/dw[i][j] = x[i][j] + sum over rows r of x[r][i].
+*/
+
+namespace
+{
+    struct Graph
+    {
+        Tensor<double> w{ std::vector<double>{ 0.5, -1.0, 2.0, 0.25 }, { 2, 2 } };
+        Tensor<double> x{ std::vector<double>{ 1.0, 2.0, 0.1, 1.0 }, { 2, 2 } };
+        Tensor<double>& loss{ (x * w + x.matmul(w)).sum() };
+
+        ~Graph()
+        {
+            x.ungraph();
+            w.ungraph();
+        }
+
+        void check_grad()
+        {
+            const Tensor<double>& cx{ x };
+
+            for(int i = 0; i < 2; ++i)
+                for(int j = 0; j < 2; ++j)
+                {
+                    const double expected{ cx(i, j) + cx(0, i) + cx(1, i) };
+                    CHECK_NEAR((*w.grad)(i, j), expected, 1e-12);
+                }
+        }
+    };
+
+    // Restores the default policy when a test finishes
+    struct PolicyGuard
+    {
+        explicit PolicyGuard(const JacobianCache policy) { Operation<double>::set_cache_policy(policy); }
+        ~PolicyGuard() { Operation<double>::set_cache_policy(JacobianCache::Keep); }
+    };
+}
+
+TEST(keep_is_invalidated_by_a_write)
+{
+    CHECK(Operation<double>::cache_policy() == JacobianCache::Keep);
+
+    Graph graph;
+    graph.loss.backprop({ &graph.w });
+    graph.check_grad();
+
+    const long long cached{ graph.loss.memory_usage().jacobians };
+    CHECK(cached > 0);
+
+    graph.x(0, 0) = 3.0;
+    graph.loss.backprop({ &graph.w });
+    graph.check_grad();
+    CHECK(graph.loss.memory_usage().jacobians == cached);
+}
+
+TEST(free_releases_after_backprop)
+{
+    PolicyGuard policy{ JacobianCache::Free };
+
+    Graph graph;
+    graph.loss.backprop({ &graph.w, &graph.x });
+    graph.check_grad();
+    CHECK(graph.loss.memory_usage().jacobians == 0);
+
+    graph.x(1, 0) = -2.0;
+    graph.loss.backprop({ &graph.w });
+    graph.check_grad();
+    CHECK(graph.loss.memory_usage().jacobians == 0);
+}
+
+TEST(recompute_releases_each_jacobian)
+{
+    PolicyGuard policy{ JacobianCache::Recompute };
+
+    Graph graph;
+    graph.loss.backprop({ &graph.w });
+    graph.check_grad();
+    CHECK(graph.loss.memory_usage().jacobians == 0);
+
+    graph.x(0, 1) = 5.0;
+    graph.loss.backprop({ &graph.w });
+    graph.check_grad();
+    CHECK(graph.loss.memory_usage().jacobians == 0);
+}
+
+TEST(switching_back_to_keep)
+{
+    Graph graph;
+
+    {
+        PolicyGuard policy{ JacobianCache::Free };
+        graph.loss.backprop({ &graph.w });
+        CHECK(graph.loss.memory_usage().jacobians == 0);
+    }
+
+    graph.loss.backprop({ &graph.w });
+    graph.check_grad();
+    CHECK(graph.loss.memory_usage().jacobians > 0);
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/utils/memory.hpp"
+#include <sstream>
+#include <vector>
+
+TEST(tensors_record_and_release_their_data)
+{
+    const MemoryUsage base{ MemoryTracker::current() };
+    const long long base_live{ MemoryTracker::live_tensors() };
+
+    {
+        const Tensor<double> tensor{ std::vector<double>(1000, 1.0), { 10, 100 } };
+        const MemoryUsage now{ MemoryTracker::current() };
+
+        CHECK(now.data - base.data >= 1000 * static_cast<long long>(sizeof(double)));
+        CHECK(now.metadata > base.metadata);
+        CHECK(MemoryTracker::live_tensors() == base_live + 1);
+    }
+
+    const MemoryUsage after{ MemoryTracker::current() };
+    CHECK(after.total() == base.total());
+    CHECK(MemoryTracker::live_tensors() == base_live);
+}
+
+TEST(cached_jacobians_are_counted)
+{
+    const MemoryUsage base{ MemoryTracker::current() };
+    const long long base_live{ MemoryTracker::live_tensors() };
+
+    {
+        Tensor<double> w{ std::vector<double>{ 0.5, -1.0, 2.0, 0.25 }, { 2, 2 } };
+        Tensor<double> x{ std::vector<double>{ 1.0, 2.0, 0.1, 1.0 }, { 2, 2 } };
+        Tensor<double>& loss{ x.matmul(w).exp().sum() };
+
+        const MemoryUsage before{ loss.memory_usage() };
+        CHECK(before.jacobians == 0);
+
+        loss.backprop({ &w });
+
+        const MemoryUsage after{ loss.memory_usage() };
+        CHECK(after.jacobians > 0);
+        CHECK(after.indices > 0);
+        CHECK(after.total() > before.total());
+
+        // Any node of the graph reports the whole graph
+        CHECK(w.memory_usage().total() == after.total());
+        CHECK(x.memory_usage().total() == after.total());
+    }
+
+    CHECK(MemoryTracker::current().total() == base.total());
+    CHECK(MemoryTracker::live_tensors() == base_live);
+}
+
+TEST(peak_keeps_the_high_water_mark)
+{
+    MemoryTracker::reset_peak();
+    const MemoryUsage base{ MemoryTracker::current() };
+
+    {
+        const Tensor<double> tensor{ std::vector<double>(10000, 2.0), { 10000 } };
+    }
+
+    const long long bytes{ 10000 * static_cast<long long>(sizeof(double)) };
+
+    CHECK(MemoryTracker::current().total() == base.total());
+    CHECK(MemoryTracker::peak().data - base.data >= bytes);
+    CHECK(MemoryTracker::peak_total_bytes() - base.total() >= bytes);
+
+    MemoryTracker::reset_peak();
+    CHECK(MemoryTracker::peak_total_bytes() == MemoryTracker::current().total());
+}
+
+TEST(report_leaks_lists_live_tensors)
+{
+    CHECK(MemoryTracker::live_tensors() == 0);
+
+    std::ostringstream none;
+    CHECK(!MemoryTracker::report_leaks(none));
+
+    {
+        const Tensor<double> tensor{ std::vector<double>{ 1.0, 2.0 } };
+
+        std::ostringstream live;
+        CHECK(MemoryTracker::report_leaks(live));
+        CHECK(!live.str().empty());
+    }
+
+    CHECK(MemoryTracker::live_tensors() == 0);
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/planner/memory_planner.hpp"
+#include "../tensor/utils/memory.hpp"
+#include <sstream>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // Alternating matmuls and elementwise blocks, reduced to a scalar
+    Tensor<double>& chain(Tensor<double>& x, Tensor<double>& w1, Tensor<double>& w2)
+    {
+        Tensor<double>* h{ &x };
+
+        for(int i = 0; i < 6; ++i)
+        {
+            Tensor<double>& a{ h->matmul(i % 2 ? w2 : w1) };
+            h = &(a * a + a).exp();
+        }
+
+        return h->sum();
+    }
+}
+
+TEST(plan_reuses_storage)
+{
+    Tensor<double> x{ std::vector<double>(32, 0.1), { 4, 8 } };
+    Tensor<double> w1{ std::vector<double>(64, 0.05), { 8, 8 } };
+    Tensor<double> w2{ std::vector<double>(64, -0.02), { 8, 8 } };
+    Tensor<double>& out{ chain(x, w1, w2) };
+
+    MemoryPlanner<double> plan{ out };
+
+    // matmul, mul, add and exp per block, then the root 'sum' with its own storage
+    const auto& intervals{ plan.intervals() };
+    CHECK(intervals.size() == 25);
+    CHECK(intervals.back().tensor == &out);
+    CHECK(plan.num_slabs() < 24);
+    CHECK(plan.planned_bytes() * 3 < plan.naive_bytes());
+
+    for(int i = 0; i < 24; ++i)
+    {
+        CHECK(intervals[i].start <= intervals[i].end);
+        CHECK(intervals[i].slab >= 0 && intervals[i].slab < plan.num_slabs());
+    }
+
+    std::ostringstream report;
+    plan.report(report);
+    CHECK(!report.str().empty());
+
+    x.ungraph();
+    w1.ungraph();
+    w2.ungraph();
+}
+
+TEST(execute_matches_unplanned_evaluation)
+{
+    Tensor<double> x{ std::vector<double>(32, 0.1), { 4, 8 } };
+    Tensor<double> w1{ std::vector<double>(64, 0.05), { 8, 8 } };
+    Tensor<double> w2{ std::vector<double>(64, -0.02), { 8, 8 } };
+    Tensor<double>& out{ chain(x, w1, w2) };
+    const double expected{ out.item() };
+
+    MemoryPlanner<double> plan{ out };
+    plan.release();
+    CHECK_NEAR(plan.execute().item(), expected, 1e-12);
+
+    // Leaves written after planning are picked up by the next execute
+    x(std::vector<int>{ 0, 0 }) = 0.5;
+    const double planned{ plan.execute().item() };
+
+    Tensor<double> x2{ std::vector<double>(32, 0.1), { 4, 8 } };
+    x2(std::vector<int>{ 0, 0 }) = 0.5;
+    const double unplanned{ chain(x2, w1, w2).item() };
+
+    CHECK(planned != expected);
+    CHECK_NEAR(planned, unplanned, 1e-12);
+
+    x.ungraph();
+    x2.ungraph();
+    w1.ungraph();
+    w2.ungraph();
+}
+
+TEST(branches_keep_arguments_alive)
+{
+    // 'a' is read again by the product before the root 'sum', so it stays alive until then
+    Tensor<double> x{ std::vector<double>{ 0.1, 0.2, 0.3, 0.4 }, { 4 } };
+    Tensor<double>& a{ x.exp() };
+    Tensor<double>& b{ (a * a).log() };
+    Tensor<double>& c{ (b + b).exp() };
+    Tensor<double>& out{ (c * a).sum() };
+    const double expected{ out.item() };
+
+    MemoryPlanner<double> plan{ out };
+
+    for(const auto& interval : plan.intervals())
+        if(interval.tensor == &a)
+            CHECK(interval.end == static_cast<int>(plan.intervals().size()) - 2);
+
+    plan.release();
+    CHECK_NEAR(plan.execute().item(), expected, 1e-12);
+    CHECK_NEAR(plan.execute().item(), expected, 1e-12);
+
+    x.ungraph();
+}
+
+TEST(execute_stays_within_planned_bytes)
+{
+    Tensor<double> x{ std::vector<double>(32, 0.1), { 4, 8 } };
+    Tensor<double> w1{ std::vector<double>(64, 0.05), { 8, 8 } };
+    Tensor<double> w2{ std::vector<double>(64, -0.02), { 8, 8 } };
+    Tensor<double>& out{ chain(x, w1, w2) };
+    const double expected{ out.item() };
+
+    MemoryPlanner<double> plan{ out };
+    plan.release();
+
+    const long long base{ MemoryTracker::current().data };
+    MemoryTracker::reset_peak();
+
+    for(int i = 0; i < 3; ++i)
+        CHECK_NEAR(plan.execute().item(), expected, 1e-12);
+
+    // The slabs are counted with the tensors, and nothing else is held alongside them
+    const long long peak{ MemoryTracker::peak().data - base };
+    CHECK(peak >= plan.planned_bytes() - static_cast<long long>(sizeof(double)));
+    CHECK(peak <= plan.planned_bytes());
+
+    x.ungraph();
+    w1.ungraph();
+    w2.ungraph();
+}
+
+TEST(in_place_steps_match_unplanned_evaluation)
+{
+    // Elementwise steps with scalar operands, each overwriting the slab of its argument
+    const auto build = [](Tensor<double>& x) -> Tensor<double>&
+    {
+        return (((x * 0.5).exp() + 1.0).log() * x - 2.0).exp().sum();
+    };
+
+    std::vector<double> values{ 0.3, -0.7, 1.1, 0.2, -1.4, 0.9 };
+    std::vector<double> expected{};
+
+    for(int i = 0; i < 3; ++i)
+    {
+        values[i] = 0.25 * i;
+
+        Tensor<double> x{ values, { 2, 3 } };
+        expected.push_back(build(x).item());
+        x.ungraph();
+    }
+
+    Tensor<double> x{ std::vector<double>{ 0.3, -0.7, 1.1, 0.2, -1.4, 0.9 }, { 2, 3 } };
+    Tensor<double>& out{ build(x) };
+
+    MemoryPlanner<double> plan{ out };
+    int in_place{ 0 };
+
+    for(const auto& interval : plan.intervals())
+        in_place += interval.in_place;
+
+    CHECK(in_place > 0);
+
+    plan.release();
+    const long long base{ MemoryTracker::current().data };
+    MemoryTracker::reset_peak();
+
+    for(int i = 0; i < 3; ++i)
+    {
+        x(0, i) = 0.25 * i;
+        CHECK_NEAR(plan.execute().item(), expected[i], 1e-12 * std::abs(expected[i]));
+    }
+
+    CHECK(MemoryTracker::peak().data - base <= plan.planned_bytes());
+
+    x.ungraph();
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include "../tensor/utils/no_grad.hpp"
+#include <vector>
+#include <thread>
+
+namespace
+{
+    Tensor<double>& model(Tensor<double>& x, Tensor<double>& w)
+    {
+        return (x.matmul(w) + x * 3.0 - 1.0).exp().sum();
+    }
+}
+
+TEST(values_match_graph_mode_without_a_graph)
+{
+    Tensor<double> w{ { 0.5, -1.0, 2.0, 0.25 }, { 2, 2 } };
+    Tensor<double> x{ { 1.0, 2.0, 0.1, 1.0 }, { 2, 2 } };
+
+    const double expected{ model(x, w).item() };
+    x.ungraph();
+    w.ungraph();
+
+    NoGradGuard guard{};
+    Tensor<double>& y{ model(x, w) };
+
+    CHECK_NEAR(y.item(), expected, 1e-12);
+    CHECK(!y.has_parents());
+    CHECK(!x.has_children() && !w.has_children());
+}
+
+TEST(guards_nest_and_are_per_thread)
+{
+    CHECK(!NoGradGuard::enabled());
+
+    {
+        NoGradGuard outer{};
+        CHECK(NoGradGuard::enabled());
+
+        {
+            NoGradGuard inner{};
+            CHECK(NoGradGuard::enabled());
+        }
+
+        CHECK(NoGradGuard::enabled());
+
+        bool enabled_elsewhere{ true };
+        std::thread other{ [&enabled_elsewhere]{ enabled_elsewhere = NoGradGuard::enabled(); } };
+        other.join();
+        CHECK(!enabled_elsewhere);
+    }
+
+    CHECK(!NoGradGuard::enabled());
+}
+
+TEST(graphs_are_built_again_after_the_guard)
+{
+    Tensor<double> w{ { 0.5, -1.0, 2.0, 0.25 }, { 2, 2 } };
+    Tensor<double> x{ { 1.0, 2.0, 0.1, 1.0 }, { 2, 2 } };
+
+    {
+        NoGradGuard guard{};
+        model(x, w);
+    }
+
+    Tensor<double>& loss{ (x * w).sum() };
+    CHECK(loss.has_parents());
+
+    loss.backprop({ &x });
+    CHECK_NEAR((*x.grad)(std::vector<int>{ 0, 1 }), -1.0, 1e-12);
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/optimizers/sgd/sgd.hpp"
+#include "../tensor/optimizers/adam/adam.hpp"
+#include <vector>
+#include <cmath>
+
+/*
+Steps of each optimizer against its update rule, for a given 
+gradient 'g' of each parameter.
+*/
+
+namespace
+{
+    void set_grad(Tensor<double>& param, const std::vector<double>& g)
+    {
+        delete param.grad;
+        param.grad = new Tensor<double>{ g, param.shape };
+    }
+
+    double at(const Tensor<double>& tensor, const int i)
+    {
+        return tensor(std::vector<int>{ i });
+    }
+}
+
+TEST(sgd_step)
+{
+    Tensor<double> p{ { 1.0, -2.0, 0.5 }, { 3 } };
+    SGD<double> optimizer{ { &p }, 0.1 };
+
+    set_grad(p, { 0.5, 1.0, -3.0 });
+    optimizer.step();
+
+    CHECK_NEAR(at(p, 0), 1.0 - 0.1 * 0.5, 1e-12);
+    CHECK_NEAR(at(p, 1), -2.0 - 0.1 * 1.0, 1e-12);
+    CHECK_NEAR(at(p, 2), 0.5 + 0.1 * 3.0, 1e-12);
+}
+
+TEST(sgd_momentum_and_weight_decay)
+{
+    const double lr{ 0.1 }, momentum{ 0.9 }, decay{ 0.01 };
+    const std::vector<double> g{ 0.5, 1.0, -3.0 };
+
+    Tensor<double> p{ { 1.0, -2.0, 0.5 }, { 3 } };
+    SGD<double> optimizer{ { &p }, lr, momentum, decay };
+
+    std::vector<double> expected{ 1.0, -2.0, 0.5 };
+    std::vector<double> velocity(3, 0);
+
+    for(int step = 0; step < 3; ++step)
+    {
+        set_grad(p, g);
+        optimizer.step();
+
+        for(int i = 0; i < 3; ++i)
+        {
+            velocity[i] = momentum * velocity[i] + g[i] + decay * expected[i];
+            expected[i] -= lr * velocity[i];
+            CHECK_NEAR(at(p, i), expected[i], 1e-12);
+        }
+    }
+}
+
+TEST(adam_steps)
+{
+    const double lr{ 0.01 }, beta1{ 0.8 }, beta2{ 0.99 }, eps{ 1e-6 };
+    const std::vector<double> g{ 0.5, -1.0, 4.0 };
+
+    Tensor<double> p{ { 1.0, -2.0, 0.5 }, { 3 } };
+    Adam<double> optimizer{ { &p }, lr, beta1, beta2, eps };
+
+    std::vector<double> expected{ 1.0, -2.0, 0.5 };
+    std::vector<double> m(3, 0), v(3, 0);
+
+    for(int t = 1; t <= 3; ++t)
+    {
+        set_grad(p, g);
+        optimizer.step();
+
+        for(int i = 0; i < 3; ++i)
+        {
+            m[i] = beta1 * m[i] + (1 - beta1) * g[i];
+            v[i] = beta2 * v[i] + (1 - beta2) * g[i] * g[i];
+            expected[i] -= lr * (m[i] / (1 - std::pow(beta1, t))) / (std::sqrt(v[i] / (1 - std::pow(beta2, t))) + eps);
+            CHECK_NEAR(at(p, i), expected[i], 1e-12);
+        }
+    }
+}
+
+TEST(large_parameters_split_into_chunks)
+{
+    constexpr int size{ 100000 };
+
+    Tensor<double> p{ std::vector<double>(size, 1.0), { size } };
+    Tensor<double> q{ { 3.0 }, { 1 } };
+    SGD<double> optimizer{ { &p, &q }, 0.5 };
+
+    std::vector<double> g(size);
+    for(int i = 0; i < size; ++i)
+        g[i] = i % 7;
+
+    set_grad(p, g);
+    optimizer.step();
+
+    // 'q' has no grad and is left unchanged
+    CHECK(at(q, 0) == 3.0);
+
+    int wrong{ 0 };
+    for(int i = 0; i < size; ++i)
+        wrong += std::abs(at(p, i) - (1.0 - 0.5 * (i % 7))) > 1e-12;
+
+    CHECK(wrong == 0);
+
+    optimizer.zero_grad();
+    CHECK(p.grad->shape == p.shape && (*p.grad)(std::vector<int>{ 6 }) == 0);
+}
+
+TEST(minimises_a_quadratic)
+{
+    Tensor<double> w{ { 0.0, 1.0, -2.0 }, { 3 } };
+    Adam<double> optimizer{ { &w }, 0.1 };
+
+    for(int it = 0; it < 500; ++it)
+    {
+        optimizer.zero_grad();
+        Tensor<double>& loss{ (w - 3).pow(2).sum() };
+        loss.backprop({ &w });
+        optimizer.step();
+        w.ungraph();
+    }
+
+    for(int i = 0; i < 3; ++i)
+        CHECK_NEAR(at(w, i), 3.0, 1e-3);
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
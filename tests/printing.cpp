@@ -0,0 +1,95 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    template <class T>
+    std::string to_string(const Tensor<T>& tensor)
+    {
+        std::ostringstream out;
+        out << tensor;
+        return out.str();
+    }
+
+    // Restores the global print options when a test finishes
+    struct OptionsGuard
+    {
+        utils::PrintOptions saved{ utils::print_options() };
+        ~OptionsGuard() { utils::print_options() = saved; }
+    };
+}
+
+TEST(small_tensors_print_in_full)
+{
+    OptionsGuard guard;
+    utils::print_options().precision = 2;
+
+    const Tensor<double> tensor{ std::vector<double>{ 0.5, -1.25, 3.0, 4.125 }, { 2, 2 } };
+    const std::string text{ to_string(tensor) };
+
+    CHECK(text.find("...") == std::string::npos);
+    CHECK(text.find("0.50") != std::string::npos);
+    CHECK(text.find("-1.25") != std::string::npos);
+    CHECK(text.find("4.12") != std::string::npos || text.find("4.13") != std::string::npos);
+}
+
+TEST(large_tensors_are_summarised)
+{
+    OptionsGuard guard;
+    utils::print_options().threshold = 5;
+    utils::print_options().edge_items = 3;
+
+    std::vector<int> values(20);
+
+    for(int i = 0; i < 20; ++i)
+        values[i] = i + 1;
+
+    values[1] = -2;
+
+    const std::string text{ to_string(Tensor<int>{ values, { 20 } }) };
+    CHECK(text == "Tensor[ 1 -2 3 ... 18 19 20 ] \n");
+}
+
+TEST(summarised_rows_and_columns)
+{
+    OptionsGuard guard;
+    utils::print_options().threshold = 100;
+    utils::print_options().edge_items = 2;
+    utils::print_options().precision = 0;
+
+    std::vector<double> values(400);
+
+    for(int i = 0; i < 400; ++i)
+        values[i] = i;
+
+    const std::string text{ to_string(Tensor<double>{ values, { 20, 20 } }) };
+
+    // Two edge rows on each side plus the elision row, each cut to two edge columns
+    CHECK(text.find("[ 0 1 ... 18 19 ]") != std::string::npos);
+    CHECK(text.find("[ 380 381 ... 398 399 ]") != std::string::npos);
+    CHECK(text.find("[ 40 ") == std::string::npos);
+    CHECK(text.find(" 200 ") == std::string::npos);
+}
+
+TEST(threshold_disables_summarisation)
+{
+    OptionsGuard guard;
+    utils::print_options().threshold = 20;
+
+    std::vector<int> values(20);
+
+    for(int i = 0; i < 20; ++i)
+        values[i] = i;
+
+    const std::string text{ to_string(Tensor<int>{ values, { 20 } }) };
+    CHECK(text.find("...") == std::string::npos);
+    CHECK(text.find(" 10 ") != std::string::npos);
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
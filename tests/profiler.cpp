@@ -0,0 +1,173 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include "../tensor/utils/profiler.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+The scope, summary and trace tests run in every build. The checks 
+on the events recorded by the operations and the engine need the 
+profiler compiled in (-DTENSORGRAD_PROFILE=ON).
+*/
+
+TEST(scopes_record_only_while_enabled)
+{
+    Profiler& profiler{ Profiler::global() };
+    profiler.clear();
+
+    {
+        ProfileScope scope{ "disabled", "manual" };
+        CHECK(!scope.is_active());
+    }
+
+    profiler.enable();
+
+    {
+        ProfileScope scope{ "enabled", "manual" };
+        CHECK(scope.is_active());
+        scope.event.elements = 6;
+        scope.event.bytes = 48;
+    }
+
+    profiler.enable(false);
+
+    const std::vector<Profiler::Event> events{ profiler.snapshot() };
+    CHECK(events.size() == 1);
+    CHECK(events[0].name == "enabled");
+    CHECK(events[0].elements == 6);
+    CHECK(events[0].bytes == 48);
+    CHECK(events[0].duration_ns >= 0);
+
+    profiler.clear();
+    CHECK(profiler.snapshot().empty());
+}
+
+TEST(summary_aggregates_by_name_and_shape)
+{
+    Profiler& profiler{ Profiler::global() };
+    profiler.clear();
+    profiler.enable();
+
+    for(int i = 0; i < 3; ++i)
+    {
+        ProfileScope scope{ "step", "manual" };
+        scope.event.shape = "[2, 3]";
+        scope.event.elements = 6;
+        scope.event.nnz = 2;
+    }
+
+    profiler.enable(false);
+
+    std::ostringstream out;
+    profiler.summary(out);
+
+    std::istringstream lines{ out.str() };
+    std::string header, row, rest;
+    std::getline(lines, header);
+    std::getline(lines, row);
+
+    CHECK(header.find("Calls") != std::string::npos);
+    CHECK(row.find("step") != std::string::npos);
+    CHECK(row.find("[2, 3]") != std::string::npos);
+    CHECK(row.find(" 3 ") != std::string::npos);
+    CHECK(row.find(" 18") != std::string::npos);
+    CHECK(!std::getline(lines, rest));
+
+    profiler.clear();
+}
+
+TEST(chrome_trace)
+{
+    Profiler& profiler{ Profiler::global() };
+    profiler.clear();
+    profiler.enable();
+
+    {
+        ProfileScope first{ "first", "manual" };
+    }
+
+    {
+        ProfileScope second{ "second", "manual" };
+    }
+
+    profiler.enable(false);
+
+    const std::string path{ (std::filesystem::temp_directory_path() / "tensorgrad_test_trace.json").string() };
+    profiler.write_chrome_trace(path);
+
+    std::ifstream file{ path };
+    const std::string trace{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+
+    CHECK(trace.find("\"traceEvents\"") != std::string::npos);
+    CHECK(trace.find("\"name\":\"first\"") != std::string::npos);
+    CHECK(trace.find("\"name\":\"second\"") != std::string::npos);
+    CHECK(trace.find("\"ph\":\"X\"") != std::string::npos);
+
+    std::filesystem::remove(path);
+    profiler.clear();
+}
+
+#ifdef TENSORGRAD_PROFILE
+
+namespace
+{
+    int count(const std::vector<Profiler::Event>& events, const std::string& category, const std::string& name = "")
+    {
+        int n{ 0 };
+
+        for(const Profiler::Event& event : events)
+            if(event.category == category && (name.empty() || event.name == name))
+                ++n;
+
+        return n;
+    }
+}
+
+TEST(operations_and_engine_are_recorded)
+{
+    Profiler& profiler{ Profiler::global() };
+    profiler.clear();
+    profiler.enable();
+
+    Tensor<double> w{ std::vector<double>{ 0.5, -1.0, 2.0, 0.25 }, { 2, 2 } };
+    Tensor<double> x{ std::vector<double>{ 1.0, 2.0, 0.1, 1.0 }, { 2, 2 } };
+    Tensor<double>& loss{ (x.matmul(w) + x * 3.0).exp().sum() };
+
+    // matmul, mul, add, exp and sum
+    std::vector<Profiler::Event> events{ profiler.snapshot() };
+    CHECK(count(events, "forward") == 5);
+    CHECK(count(events, "backward") == 0);
+
+    loss.backprop({ &x, &w });
+    profiler.enable(false);
+
+    events = profiler.snapshot();
+    CHECK(count(events, "backward") >= 5);
+    CHECK(count(events, "engine", "Engine::grad") >= 2);
+    CHECK(count(events, "engine", "Engine::update") >= 1);
+
+    for(const Profiler::Event& event : events)
+        if(std::string{ event.category } == "forward")
+        {
+            CHECK(!event.shape.empty());
+            CHECK(event.bytes == event.elements * static_cast<long long>(sizeof(double)));
+        }
+
+    // Nothing is recorded once disabled
+    const int recorded{ static_cast<int>(events.size()) };
+    x.exp();
+    CHECK(static_cast<int>(profiler.snapshot().size()) == recorded);
+
+    profiler.clear();
+}
+
+#endif
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include "../tensor/rewriter/graph_rewriter.hpp"
+#include <vector>
+#include <cmath>
+
+namespace
+{
+    void check_close(const Tensor<double>& tensor1, const Tensor<double>& tensor2)
+    {
+        CHECK(tensor1.shape == tensor2.shape);
+
+        for(const auto& idx : utils::total_idxs(tensor1.shape))
+            CHECK_NEAR(tensor1(idx), tensor2(idx), 1e-9 * (1 + std::abs(tensor2(idx))));
+    }
+}
+
+TEST(folds_constant_chains)
+{
+    Tensor<double> x{ std::vector<double>{ 0.5, -1.0, 2.0 }, { 3 } };
+    Tensor<double>& loss{ ((((x * 2.0) * 3.0) + 1.0) + 2.0).pow(3).sum() };
+    const double value{ loss.item() };
+
+    loss.backprop({ &x });
+    const Tensor<double> expected{ *x.grad };
+
+    GraphRewriter<double> rewriter{ loss };
+    const auto& stats{ rewriter.run() };
+
+    // x * 6 + 3, then pow and sum
+    CHECK(stats.folded == 2);
+    CHECK(stats.nodes_before == 6);
+    CHECK(stats.nodes_after == 4);
+    CHECK(stats.flops_after < stats.flops_before);
+    CHECK_NEAR(loss.item(), value, 1e-12);
+
+    loss.backprop({ &x });
+    check_close(*x.grad, expected);
+
+    x.ungraph();
+}
+
+TEST(strength_reduction)
+{
+    Tensor<double> x{ std::vector<double>{ 0.5, -1.0, 2.0 }, { 3 } };
+    Tensor<double> y{ std::vector<double>{ 1.5, 2.0, -3.0 }, { 3 } };
+    Tensor<double>& loss{ (x.pow(2) + x * y.pow(-1) + (x + y * -1.0)).sum() };
+
+    loss.backprop({ &x, &y });
+    const Tensor<double> grad_x{ *x.grad }, grad_y{ *y.grad };
+
+    GraphRewriter<double> rewriter{ loss };
+    const auto& stats{ rewriter.run() };
+
+    // x^2 -> x * x, x * y^-1 -> x / y and x + y * -1 -> x - y
+    CHECK(stats.reduced == 3);
+    CHECK(stats.nodes_after < stats.nodes_before);
+
+    loss.backprop({ &x, &y });
+    check_close(*x.grad, grad_x);
+    check_close(*y.grad, grad_y);
+
+    x.ungraph();
+    y.ungraph();
+}
+
+TEST(eliminates_common_subexpressions)
+{
+    Tensor<double> x{ std::vector<double>{ 0.5, -1.0, 2.0, 0.25 }, { 2, 2 } };
+    Tensor<double> y{ std::vector<double>{ 1.5, 2.0, -3.0, 0.5 }, { 2, 2 } };
+
+    // x * y and y * x are the same product, and so are both of their sums
+    Tensor<double>& loss{ (x * y).sum() + (y * x).sum() + x.matmul(y).exp().sum() + x.matmul(y).exp().sum() };
+    const double value{ loss.item() };
+
+    loss.backprop({ &x, &y });
+    const Tensor<double> grad_x{ *x.grad }, grad_y{ *y.grad };
+
+    GraphRewriter<double> rewriter{ loss };
+    const auto& stats{ rewriter.run() };
+
+    CHECK(stats.eliminated == 5);
+    CHECK(stats.nodes_before - stats.nodes_after == 5);
+    CHECK_NEAR(loss.item(), value, 1e-12);
+
+    loss.backprop({ &x, &y });
+    check_close(*x.grad, grad_x);
+    check_close(*y.grad, grad_y);
+
+    // Nothing is left to rewrite
+    const auto& again{ rewriter.run() };
+    CHECK(again.eliminated == 0 && again.folded == 0 && again.reduced == 0);
+    CHECK(again.nodes_before == again.nodes_after);
+
+    x.ungraph();
+    y.ungraph();
+}
+
+TEST(integer_graphs)
+{
+    // y^-1 is not reduced to a division for integers
+    Tensor<int> a{ std::vector<int>{ 1, 2, 3, 4 }, { 2, 2 } };
+    Tensor<int>& loss{ ((a * 2) * 3).pow(2).sum() + a.pow(2).sum() };
+    const int value{ loss.item() };
+
+    GraphRewriter<int> rewriter{ loss };
+    const auto& stats{ rewriter.run() };
+    CHECK(stats.folded == 1);
+    CHECK(stats.reduced == 2);
+    CHECK(loss.item() == value);
+
+    loss.backprop({ &a });
+    CHECK((*a.grad)(1, 1) == 2 * 36 * 4 + 2 * 4);
+
+    a.ungraph();
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
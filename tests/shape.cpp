@@ -0,0 +1,155 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include "../tensor/utils/shape.hpp"
+#include <utility>
+#include <vector>
+
+using utils::Shape;
+
+namespace
+{
+    Shape iota(const int size)
+    {
+        Shape shape{};
+
+        for(int i = 0; i < size; ++i)
+            shape.push_back(i);
+
+        return shape;
+    }
+
+    bool holds_iota(const Shape& shape, const int size)
+    {
+        if(static_cast<int>(shape.size()) != size)
+            return false;
+
+        for(int i = 0; i < size; ++i)
+            if(shape[i] != i)
+                return false;
+
+        return true;
+    }
+}
+
+TEST(spills_past_the_inline_capacity)
+{
+    Shape shape{ iota(Shape::inline_capacity) };
+    CHECK(shape.is_inline());
+    CHECK(holds_iota(shape, 8));
+
+    shape.push_back(8);
+    CHECK(!shape.is_inline());
+    CHECK(shape.capacity() >= 9);
+    CHECK(holds_iota(shape, 9));
+
+    shape.resize(20, 7);
+    CHECK(shape.size() == 20 && shape[19] == 7 && shape[8] == 8);
+
+    shape.resize(3);
+    CHECK(holds_iota(shape, 3));
+}
+
+TEST(copies_and_moves)
+{
+    for(const int size : { 3, 8, 9, 30 })
+    {
+        const Shape original{ iota(size) };
+
+        Shape copy{ original };
+        CHECK(holds_iota(copy, size));
+        CHECK(copy.data() != original.data());
+
+        Shape assigned{ 1, 2 };
+        assigned = original;
+        CHECK(holds_iota(assigned, size));
+
+        Shape moved{ std::move(copy) };
+        CHECK(holds_iota(moved, size));
+
+        Shape move_assigned{ iota(12) };
+        move_assigned = std::move(moved);
+        CHECK(holds_iota(move_assigned, size));
+
+        Shape other{ 5 };
+        other.swap(move_assigned);
+        CHECK(holds_iota(other, size));
+        CHECK(move_assigned.size() == 1 && move_assigned[0] == 5);
+    }
+}
+
+TEST(insert_and_erase)
+{
+    Shape shape{ 0, 1, 6, 7 };
+    const std::vector<int> middle{ 2, 3, 4, 5 };
+    shape.insert(shape.begin() + 2, middle.begin(), middle.end());
+    CHECK(holds_iota(shape, 8) && shape.is_inline());
+
+    // Spills while inserting
+    const std::vector<int> tail{ 8, 9, 10 };
+    shape.insert(shape.end(), tail.begin(), tail.end());
+    CHECK(holds_iota(shape, 11) && !shape.is_inline());
+
+    shape.insert(shape.begin(), -1);
+    CHECK(shape.front() == -1 && shape.size() == 12);
+
+    shape.erase(shape.begin());
+    CHECK(holds_iota(shape, 11));
+
+    shape.erase(shape.begin() + 3, shape.end());
+    CHECK(holds_iota(shape, 3));
+}
+
+TEST(insert_a_range_of_itself)
+{
+    // Inserting its own elements, so that the range moves as the shape spills or shifts
+    Shape shape{ 0, 1, 2, 3, 4, 5 };
+    shape.insert(shape.end(), shape.begin(), shape.end());
+    CHECK(shape == Shape({ 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5 }) && !shape.is_inline());
+
+    shape.insert(shape.begin() + 1, shape.begin() + 9, shape.end());
+    CHECK(shape == Shape({ 0, 3, 4, 5, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5 }));
+
+    Shape small{ 1, 2, 3 };
+    small.insert(small.begin(), small.begin() + 1, small.end());
+    CHECK(small == Shape({ 2, 3, 1, 2, 3 }) && small.is_inline());
+}
+
+TEST(converts_and_compares_like_a_vector)
+{
+    const Shape shape{ iota(10) };
+    const std::vector<int> vector(shape);
+    CHECK(vector.size() == 10 && vector[9] == 9);
+    CHECK(Shape{ vector } == shape);
+
+    const Shape small{ 1, 2 };
+    CHECK(small < Shape({ 1, 3 }));
+    CHECK(small < Shape({ 1, 2, 0 }));
+    CHECK(small != Shape({ 2, 1 }));
+}
+
+TEST(jacobians_with_more_than_eight_dimensions)
+{
+    // A 5-dim tensor has a 10-dim Jacobian wrt. itself
+    const Shape shape{ 1, 2, 1, 2, 1 };
+    Tensor<double> x{ std::vector<double>{ 0.1, 0.2, 0.3, 0.4 }, shape };
+    Tensor<double>& y{ x.exp() };
+
+    const Tensor<double> jacobian{ Engine<double>::grad(&y, &x) };
+    CHECK(jacobian.shape == utils::concat_shapes(shape, shape));
+    CHECK(jacobian.shape.size() == 10);
+
+    for(const auto& idx : utils::total_idxs(jacobian.shape))
+    {
+        const bool diagonal{ Shape{ idx.begin(), idx.begin() + 5 } == Shape{ idx.begin() + 5, idx.end() } };
+        const double expected{ diagonal ? std::exp(x(Shape{ idx.begin(), idx.begin() + 5 })) : 0.0 };
+        CHECK_NEAR(jacobian(idx), expected, 1e-12);
+    }
+
+    x.ungraph();
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include <vector>
+#include <cmath>
+
+using std::vector;
+
+namespace
+{
+    template <class T>
+    void check_matches_grad(Tensor<T>& node, Tensor<T>& target)
+    {
+        const auto sparse{ Engine<T>::sparse_grad(&node, &target) };
+        const Tensor<T> dense{ Engine<T>::grad(&node, &target) };
+        const Tensor<T> expanded{ sparse.to_dense() };
+
+        CHECK(expanded.shape == dense.shape);
+
+        for(const auto& idx : utils::total_idxs(dense.shape))
+            CHECK_NEAR(expanded(idx), dense(idx), 1e-12);
+    }
+}
+
+TEST(tridiagonal_stencil)
+{
+    for(const int n : { 6, 40 })
+    {
+        vector<double> stencil(n * n, 0.0), initial(n);
+
+        for(int i = 0; i < n; ++i)
+        {
+            stencil[i * n + i] = -2.0;
+
+            if(i > 0)
+                stencil[i * n + i - 1] = 1.0;
+
+            if(i + 1 < n)
+                stencil[i * n + i + 1] = 1.0;
+
+            initial[i] = 0.1 * i - 0.3;
+        }
+
+        Tensor<double> a{ stencil, { n, n } };
+        Tensor<double> u{ initial, { n, 1 } };
+        Tensor<double> c{ vector<double>{ 0.5 }, { 1 } };
+        Tensor<double>& r{ a.matmul(u) + (u * u).exp() * c - u.pow(3) };
+
+        // Columns i, i + 3, i + 6, ... never share a row
+        const auto sparse{ Engine<double>::sparse_grad(&r, &u) };
+        CHECK(sparse.colors == 3);
+        CHECK(static_cast<int>(sparse.values.size()) == 3 * n - 2);
+        CHECK(static_cast<int>(sparse.offsets.size()) == n + 1);
+
+        check_matches_grad(r, u);
+        check_matches_grad(r, a);
+        check_matches_grad(r, c);
+
+        a.ungraph();
+        u.ungraph();
+        c.ungraph();
+    }
+}
+
+TEST(independent_target_is_empty)
+{
+    Tensor<double> a{ vector<double>{ 1.0, 2.0, 3.0, 4.0 }, { 2, 2 } };
+    Tensor<double> u{ vector<double>{ 0.5, -0.5 }, { 2, 1 } };
+    Tensor<double>& r{ a.matmul(u) };
+    Tensor<double>& v{ u.exp() };
+
+    const auto sparse{ Engine<double>::sparse_grad(&v, &a) };
+    CHECK(sparse.values.empty());
+    CHECK(sparse.colors == 0);
+    CHECK(static_cast<int>(sparse.offsets.size()) == 3);
+
+    const Tensor<double> expanded{ sparse.to_dense() };
+    CHECK(expanded.shape == utils::concat_shapes(v.shape, a.shape));
+
+    for(const auto& idx : utils::total_idxs(expanded.shape))
+        CHECK(expanded(idx) == 0.0);
+
+    check_matches_grad(r, u);
+
+    a.ungraph();
+    u.ungraph();
+}
+
+TEST(dense_rows_need_a_colour_per_column)
+{
+    Tensor<int> x{ vector<int>{ 1, 2, 3, 4 }, { 4 } };
+    Tensor<int>& y{ (x * x * 3).sum() + x.index({ 2 }) };
+
+    const auto sparse{ Engine<int>::sparse_grad(&y, &x) };
+    CHECK(sparse.colors == 4);
+    check_matches_grad(y, x);
+
+    x.ungraph();
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#ifndef TEST_HPP
+#define TEST_HPP
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <exception>
+#include <cmath>
+
+/*
+Minimal self-contained test harness: tests are functions registered
+with TEST and checked with CHECK / CHECK_NEAR / CHECK_THROWS, a
+failed check reporting its file and line without stopping the test.
+Each test executable runs every registered test from 'test::run_all'
+and exits non-zero if any check failed or a test threw.
+*/
+
+namespace test
+{
+    struct Registration
+    {
+        std::string name;
+        std::function<void()> function;
+    };
+
+    inline std::vector<Registration>& registry()
+    {
+        static std::vector<Registration> tests{};
+        return tests;
+    }
+
+    inline int& failures()
+    {
+        static int count{ 0 };
+        return count;
+    }
+
+    inline void fail(const char* file, const int line, const std::string& message)
+    {
+        std::cout << "  " << file << ":" << line << ": " << message << "\n";
+        ++failures();
+    }
+
+    struct Registrar
+    {
+        Registrar(const std::string& name, const std::function<void()>& function)
+        {
+            registry().push_back({ name, function });
+        }
+    };
+
+    inline int run_all()
+    {
+        int failed_tests{ 0 };
+
+        for(const Registration& test : registry())
+        {
+            const int before{ failures() };
+
+            try
+            {
+                test.function();
+            }
+            catch(const std::exception& error)
+            {
+                fail(__FILE__, __LINE__, std::string{ "unexpected exception: " } + error.what());
+            }
+
+            const bool passed{ failures() == before };
+            failed_tests += !passed;
+            std::cout << (passed ? "[ OK ] " : "[FAIL] ") << test.name << "\n";
+        }
+
+        std::cout << registry().size() - failed_tests << "/" << registry().size() << " tests passed\n";
+        return (failed_tests == 0) ? 0 : 1;
+    }
+}
+
+#define TEST(name) \
+    static void test_##name(); \
+    static const test::Registrar registrar_##name{ #name, test_##name }; \
+    static void test_##name()
+
+#define CHECK(condition) \
+    do { if(!(condition)) test::fail(__FILE__, __LINE__, "CHECK(" #condition ") failed"); } while(0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    do \
+    { \
+        const double check_actual{ static_cast<double>(actual) }; \
+        const double check_expected{ static_cast<double>(expected) }; \
+        if(!(std::abs(check_actual - check_expected) <= (tolerance))) \
+        { \
+            std::ostringstream message{}; \
+            message << "CHECK_NEAR(" #actual ", " #expected "): " << check_actual << " vs " << check_expected; \
+            test::fail(__FILE__, __LINE__, message.str()); \
+        } \
+    } while(0)
+
+#define CHECK_THROWS(statement) \
+    do \
+    { \
+        bool check_threw{ false }; \
+        try { statement; } catch(const std::exception&) { check_threw = true; } \
+        if(!check_threw) test::fail(__FILE__, __LINE__, "CHECK_THROWS(" #statement ") did not throw"); \
+    } while(0)
+
+#endif
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/utils/thread_pool.hpp"
+#include "../tensor/utils/utils.hpp"
+#include <vector>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <stdexcept>
+
+TEST(tasks_run_on_workers_and_caller)
+{
+    for(const int num_workers : { 0, 1, 3 })
+    {
+        ThreadPool pool{ num_workers };
+        std::atomic<int> done{ 0 };
+
+        for(int i = 0; i < 100; ++i)
+            pool.submit([&done]{ ++done; });
+
+        pool.run_until([&done]{ return done == 100; });
+        CHECK(done == 100);
+    }
+}
+
+TEST(tasks_submitted_by_tasks)
+{
+    ThreadPool pool{ 2 };
+    std::atomic<int> done{ 0 };
+
+    for(int i = 0; i < 10; ++i)
+        pool.submit([&pool, &done]
+        {
+            for(int j = 0; j < 10; ++j)
+                pool.submit([&done]{ ++done; });
+        });
+
+    pool.run_until([&done]{ return done == 100; });
+    CHECK(done == 100);
+}
+
+TEST(parallel_for_covers_the_range_once)
+{
+    std::vector<int> hits(1000, 0);
+
+    utils::parallel_for(3, 997, [&hits](const int begin, const int end)
+    {
+        for(int i = begin; i < end; ++i)
+            ++hits[i];
+    });
+
+    for(int i = 0; i < 1000; ++i)
+        CHECK(hits[i] == ((i >= 3 && i < 997) ? 1 : 0));
+}
+
+TEST(parallel_for_on_a_pool)
+{
+    ThreadPool pool{ 3 };
+    std::vector<std::atomic<int>> hits(1000);
+
+    for(int round = 0; round < 20; ++round)
+        utils::parallel_for(pool, 0, 1000, [&hits](const int begin, const int end)
+        {
+            for(int i = begin; i < end; ++i)
+                ++hits[i];
+        });
+
+    for(int i = 0; i < 1000; ++i)
+        CHECK(hits[i] == 20);
+}
+
+TEST(parallel_for_rethrows_chunk_exceptions)
+{
+    ThreadPool pool{ 3 };
+    const std::thread::id caller{ std::this_thread::get_id() };
+
+    for(int round = 0; round < 20; ++round)
+    {
+        // The last chunk throws, on whichever thread runs it
+        CHECK_THROWS(utils::parallel_for(pool, 0, 400, [](const int, const int end)
+        {
+            if(end == 400)
+                throw std::runtime_error("chunk failed");
+        }));
+
+        // A chunk on a worker throws: the caller's chunks wait until a worker has one
+        std::atomic<bool> worker_started{ false };
+
+        CHECK_THROWS(utils::parallel_for(pool, 0, 400, [caller, &worker_started](const int, const int)
+        {
+            if(std::this_thread::get_id() == caller)
+            {
+                while(!worker_started)
+                    std::this_thread::yield();
+
+                return;
+            }
+
+            worker_started = true;
+            throw std::runtime_error("chunk failed");
+        }));
+    }
+
+    // The pool is still usable afterwards
+    std::atomic<int> total{ 0 };
+    utils::parallel_for(pool, 0, 100, [&total](const int begin, const int end){ total += end - begin; });
+    CHECK(total == 100);
+}
+
+TEST(parallel_for_only_runs_its_own_chunks)
+{
+    ThreadPool pool{ 1 };
+    std::atomic<bool> release{ false };
+    std::atomic<bool> unrelated_ran{ false };
+
+    // Keep the only worker busy, with an unrelated task queued behind it
+    pool.submit([&release]{ while(!release) std::this_thread::yield(); });
+    pool.submit([&unrelated_ran]{ unrelated_ran = true; });
+
+    std::vector<int> hits(100, 0);
+
+    utils::parallel_for(pool, 0, 100, [&hits](const int begin, const int end)
+    {
+        for(int i = begin; i < end; ++i)
+            ++hits[i];
+    });
+
+    CHECK(!unrelated_ran);
+
+    for(int i = 0; i < 100; ++i)
+        CHECK(hits[i] == 1);
+
+    release = true;
+    pool.run_until([&unrelated_ran]{ return unrelated_ran.load(); });
+}
+
+TEST(independent_branches_of_one_graph)
+{
+    /*
+    A single backprop over many independent branches, which the 
+    engine schedules on the shared thread pool.
+    */
+
+    constexpr int num_branches{ 32 };
+
+    const std::vector<double> w_values{ 0.1, -0.2, 0.3 };
+    Tensor<double> w{ w_values, { 3 } };
+    Tensor<double>* loss{ &(w * 0.0).sum() };
+
+    for(int b = 1; b <= num_branches; ++b)
+        loss = &(*loss + (w * (0.01 * b)).exp().sum());
+
+    loss->backprop({ &w });
+
+    for(int i = 0; i < 3; ++i)
+    {
+        double expected{ 0 };
+
+        for(int b = 1; b <= num_branches; ++b)
+            expected += 0.01 * b * std::exp(0.01 * b * w_values[i]);
+
+        CHECK_NEAR((*w.grad)(std::vector<int>{ i }), expected, 1e-9);
+    }
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "test.hpp"
+#include "../tensor/tensor.hpp"
+#include "../tensor/engine/engine.hpp"
+#include "../tensor/optimizers/sgd/sgd.hpp"
+#include <vector>
+#include <cmath>
+
+/*
+Graphs deep enough to overflow the stack under recursive traversal, 
+and graphs whose number of paths grows exponentially with depth.
+*/
+
+TEST(deep_chain)
+{
+    constexpr int depth{ 30000 };
+
+    Tensor<double> x{ { 0.5, -0.25 }, { 2 } };
+    Tensor<double> w{ { 0.999, 1.001 }, { 2 } };
+
+    Tensor<double>* h{ &x };
+
+    for(int i = 0; i < depth; ++i)
+        h = &(*h * w);
+
+    Tensor<double>& loss{ h->sum() };
+    loss.backprop({ &x, &w });
+
+    const double wrt_x{ std::pow(0.999, depth) };
+    const double wrt_w{ depth * std::pow(0.999, depth - 1) * 0.5 };
+
+    CHECK_NEAR((*x.grad)(std::vector<int>{ 0 }), wrt_x, 1e-9 * wrt_x);
+    CHECK_NEAR((*w.grad)(std::vector<int>{ 0 }), wrt_w, 1e-6 * wrt_w);
+
+    // Freed iteratively when 'x' and 'w' go out of scope
+}
+
+TEST(diamonds)
+{
+    // 2^60 paths from the root to 'x', each tensor visited once
+    Tensor<double> x{ { 1.0 }, { 1 } };
+    Tensor<double>* h{ &x };
+
+    for(int i = 0; i < 60; ++i)
+        h = &(*h + *h * 0.5);
+
+    h->backprop({ &x }, false);
+
+    const double expected{ std::pow(1.5, 60) };
+    CHECK_NEAR((*x.grad)(std::vector<int>{ 0, 0 }), expected, 1e-9 * expected);
+}
+
+TEST(ungraph_deep_chain)
+{
+    Tensor<double> x{ { 1.0 }, { 1 } };
+    Tensor<double>* h{ &x };
+
+    for(int i = 0; i < 100000; ++i)
+        h = &(*h + 1.0);
+
+    CHECK_NEAR(h->item(), 100001.0, 1e-9);
+
+    x.ungraph();
+    CHECK(!x.has_children());
+}
+
+TEST(unused_target_gets_zero_grad_of_its_shape)
+{
+    Tensor<double> a{ { 1.0, 2.0, 3.0 }, { 3 } };
+    Tensor<double> b{ { 4.0, 5.0, 6.0 }, { 3 } };
+    SGD<double> optimizer{ { &a, &b }, 0.1 };
+
+    Tensor<double>& loss{ (a * a).sum() };
+
+    CHECK(Engine<double>::grad(&loss, &b).shape == utils::concat_shapes(loss.shape, b.shape));
+
+    loss.backprop({ &a, &b });
+    CHECK(b.grad->shape == b.shape);
+
+    loss.backprop({ &a, &b }, true, false, true);
+    optimizer.step();
+
+    CHECK(b(std::vector<int>{ 0 }) == 4.0);
+    CHECK_NEAR(a(std::vector<int>{ 0 }), 1.0 - 0.1 * 4.0, 1e-12);
+}
+
+int main()
+{
+    return test::run_all();
+}
\ No newline at end of file